@@ -16,7 +16,9 @@ export LC_NUMERIC=C
 # reference point must never be recomputed here: costs across candidate
 # configurations are only comparable while it stays fixed.
 #
-# The cost is the negated raw hypervolume, since iRace minimises.
+# The cost is the negated raw hypervolume, since iRace minimises. The solver
+# tracks it online against the reference point and reports it in its statistics,
+# so no separate hypervolume calculator runs after it.
 ###############################################################################
 
 CONFIG_ID="$1"
@@ -31,7 +33,6 @@ PROJECT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
 
 # Executables.
 SOLVER="${PROJECT_DIR}/bin/exec/nsga2_solver_exec"
-HV_CALC="${PROJECT_DIR}/bin/exec/hypervolume_calculator_exec"
 
 # Time limit per run (seconds). Overridable so that a budget smoke test can run
 # many evaluations quickly; the tuning runs use the default.
@@ -51,15 +52,30 @@ fi
 INSTANCE="$(cd "$INSTANCE" && pwd)"
 EXPECTED_RETURNS="${INSTANCE}/train/expected_returns.csv"
 COVARIANCE="${INSTANCE}/train/covariance_matrix.csv"
+BINARY="${INSTANCE}/train/covariance_matrix.bin"
+
+# Map the binary instance written by Stage 0 of run.sh when there is one, which
+# spares every candidate run the parsing of the CSVs.
+if [ -r "$BINARY" ]; then
+    INSTANCE_ARGS=(--instance-filename "$BINARY")
+else
+    INSTANCE_ARGS=(--expected-returns-filename "$EXPECTED_RETURNS"
+                   --covariance-filename "$COVARIANCE")
+fi
 REFERENCE_POINT="${INSTANCE}/reference_point.txt"
 
+if [ ! -r "$REFERENCE_POINT" ]; then
+    echo "Inf 0"
+    exit 0
+fi
+
 # Create temporary directory for this run.
 TMPDIR=$(mktemp -d)
 trap 'rm -rf "$TMPDIR"' EXIT
 
 # Output files.
 PARETO_FILE="${TMPDIR}/pareto.txt"
-HV_FILE="${TMPDIR}/hv.txt"
+STATISTICS_FILE="${TMPDIR}/statistics.txt"
 
 # Transform parameters (population_size_factor -> population_size). pagmo's
 # NSGA-II requires a population size that is a multiple of four.
@@ -91,11 +107,12 @@ done
 START_TIME=$(date +%s.%N)
 
 { "$SOLVER" \
-    --expected-returns-filename "$EXPECTED_RETURNS" \
-    --covariance-filename "$COVARIANCE" \
+    "${INSTANCE_ARGS[@]}" \
     --seed "$SEED" \
     --time-limit "$TIME_LIMIT" \
     --max-num-solutions "$MAX_NUM_SOLUTIONS" \
+    --reference-point "$REFERENCE_POINT" \
+    --statistics "$STATISTICS_FILE" \
     --pareto "$PARETO_FILE" \
     "${TRANSFORMED_PARAMS[@]}" > /dev/null 2>&1; } 2>/dev/null
 
@@ -115,28 +132,10 @@ fail () {
 # alone is not enough.
 [ $SOLVER_EXIT -eq 0 ] || fail
 [ -s "$PARETO_FILE" ] || fail
-[ -r "$REFERENCE_POINT" ] || fail
-
-# Calculate hypervolume. Braced for the same reason as the solver call above --
-# this is the one that actually fires in practice, since pagmo aborts whenever a
-# front point fails to dominate the frozen reference point.
-{ "$HV_CALC" \
-    --expected-returns-filename "$EXPECTED_RETURNS" \
-    --covariance-filename "$COVARIANCE" \
-    --reference-point "$REFERENCE_POINT" \
-    --pareto-0 "$PARETO_FILE" \
-    --hypervolume-0 "$HV_FILE" > /dev/null 2>&1; } 2>/dev/null
-
-HV_EXIT=$?
-
-# hypervolume_calculator_exec opens the output file before computing, and pagmo
-# throws when a front point fails to dominate the reference point. A failure
-# therefore leaves the file present but empty, so existence is not enough.
-[ $HV_EXIT -eq 0 ] || fail
-[ -s "$HV_FILE" ] || fail
+[ -s "$STATISTICS_FILE" ] || fail
 
 # Read hypervolume and negate (iRace minimises, we want to maximise HV).
-HV=$(tr -d '[:space:]' < "$HV_FILE")
+HV=$(awk -F': ' '$1 == "Hypervolume" { print $2 }' "$STATISTICS_FILE")
 COST=$(awk -v hv="$HV" 'BEGIN {
     if (hv !~ /^-?[0-9]+([.][0-9]+)?([eE][-+]?[0-9]+)?$/) { exit 1 }
     printf "%.17g", -hv
@@ -16,6 +16,10 @@ set -euo pipefail
 : "${MOPOP_MAX_NUM_SNAPSHOTS:=30}"
 : "${MOPOP_MAX_REF_SOLUTIONS:=800}"
 : "${MOPOP_NUM_PROCESSES:=6}"
+: "${MOPOP_NUM_THREADS:=1}"
+# factor_model.csv runs the solvers on the low-rank model written by
+# generate_instances.py build --num-factors; the metrics always use the matrix.
+: "${MOPOP_COVARIANCE_FILENAME:=covariance_matrix.csv}"
 
 # Consumed by plotter_definitions.py.
 export MOPOP_INSTANCES MOPOP_SEEDS MOPOP_MAX_NUM_SNAPSHOTS
@@ -91,6 +95,30 @@ mkdir -p "${path}/nigd_plus_snapshots"
 mkdir -p "${path}/metrics"
 mkdir -p "${path}/metrics_snapshots"
 
+################################################################################
+# Stage 0 - binary instances, one unit per (instance, covariance file). Every
+# later stage maps the .bin written next to the covariance file, so the CSVs are
+# parsed once per instance instead of once per run.
+################################################################################
+
+reset_commands
+
+for instance in "${instances[@]}"; do
+  train="${path}/instances/${instance}/train"
+  for covariance in $(printf '%s\n' covariance_matrix.csv "${MOPOP_COVARIANCE_FILENAME}" | sort -u); do
+    binary="${train}/${covariance%.csv}.bin"
+    if [ ! "${binary}" -nt "${train}/${covariance}" ] || [ ! "${binary}" -nt "${train}/expected_returns.csv" ]; then
+      command="${path}/bin/exec/instance_converter_exec "
+      command+="--expected-returns-filename ${train}/expected_returns.csv "
+      command+="--covariance-filename ${train}/${covariance} "
+      command+="--instance-filename ${binary}"
+      dispatch "${command}"
+    fi
+  done
+done
+
+launch "binary instances" ">"
+
 ################################################################################
 # Stage 1 - solver runs, one work unit per (instance, solver, seed).
 ################################################################################
@@ -98,17 +126,16 @@ mkdir -p "${path}/metrics_snapshots"
 reset_commands
 
 for instance in "${instances[@]}"; do
-  expected_returns="${path}/instances/${instance}/train/expected_returns.csv"
-  covariance="${path}/instances/${instance}/train/covariance_matrix.csv"
+  binary="${path}/instances/${instance}/train/${MOPOP_COVARIANCE_FILENAME%.csv}.bin"
   for solver in "${solvers[@]}"; do
     for seed in "${seeds[@]}"; do
       command="${path}/bin/exec/${solver}_solver_exec "
-      command+="--expected-returns-filename ${expected_returns} "
-      command+="--covariance-filename ${covariance} "
+      command+="--instance-filename ${binary} "
       command+="--seed ${seed} "
       command+="--time-limit ${MOPOP_TIME_LIMIT} "
       command+="--max-num-solutions ${MOPOP_MAX_NUM_SOLUTIONS} "
       command+="--max-num-snapshots ${MOPOP_MAX_NUM_SNAPSHOTS} "
+      command+="--num-threads ${MOPOP_NUM_THREADS} "
       command+="--statistics ${path}/statistics/${instance}_${solver}_${seed}.txt "
       command+="--pareto ${path}/pareto/${instance}_${solver}_${seed}.txt "
       command+="--best-solutions-snapshots ${path}/best_solutions_snapshots/${instance}_${solver}_${seed}_ "
@@ -135,45 +162,19 @@ done
 launch "solvers" ">"
 
 ################################################################################
-# Stage 2 - reference Pareto front and reference point, one unit per instance.
+# Stage 2 - reference Pareto front and point, hypervolume ratio and normalized
+# IGD+, one unit per instance. metrics_exec reads every run of the instance once
+# and computes the metrics of the final fronts and snapshots on its own threads.
 ################################################################################
 
 reset_commands
 
 for instance in "${instances[@]}"; do
-  expected_returns="${path}/instances/${instance}/train/expected_returns.csv"
-  covariance="${path}/instances/${instance}/train/covariance_matrix.csv"
-  command="${path}/bin/exec/reference_pareto_front_and_point_calculator_exec "
-  command+="--expected-returns-filename ${expected_returns} "
-  command+="--covariance-filename ${covariance} "
+  binary="${path}/instances/${instance}/train/covariance_matrix.bin"
+  command="${path}/bin/exec/metrics_exec "
+  command+="--instance-filename ${binary} "
   command+="--max-num-solutions ${MOPOP_MAX_REF_SOLUTIONS} "
-  command+="--reference-pareto ${path}/pareto/${instance}.txt "
-  command+="--reference-point ${path}/pareto/${instance}_point.txt "
-  j=0
-  for solver in "${solvers[@]}"; do
-    for seed in "${seeds[@]}"; do
-      command+="--pareto-${j} ${path}/pareto/${instance}_${solver}_${seed}.txt "
-      command+="--best-solutions-snapshots-${j} ${path}/best_solutions_snapshots/${instance}_${solver}_${seed}_ "
-      j=$((j + 1))
-    done
-  done
-  dispatch "${command}"
-done
-
-launch "reference fronts" ">>"
-
-################################################################################
-# Stage 3 - hypervolume ratio, one unit per instance.
-################################################################################
-
-reset_commands
-
-for instance in "${instances[@]}"; do
-  expected_returns="${path}/instances/${instance}/train/expected_returns.csv"
-  covariance="${path}/instances/${instance}/train/covariance_matrix.csv"
-  command="${path}/bin/exec/hypervolume_ratio_calculator_exec "
-  command+="--expected-returns-filename ${expected_returns} "
-  command+="--covariance-filename ${covariance} "
+  command+="--num-threads ${MOPOP_NUM_THREADS} "
   command+="--reference-pareto ${path}/pareto/${instance}.txt "
   command+="--reference-point ${path}/pareto/${instance}_point.txt "
   j=0
@@ -183,33 +184,6 @@ for instance in "${instances[@]}"; do
       command+="--best-solutions-snapshots-${j} ${path}/best_solutions_snapshots/${instance}_${solver}_${seed}_ "
       command+="--hvr-${j} ${path}/hvr/${instance}_${solver}_${seed}.txt "
       command+="--hvr-snapshots-${j} ${path}/hvr_snapshots/${instance}_${solver}_${seed}.txt "
-      j=$((j + 1))
-    done
-  done
-  dispatch "${command}"
-done
-
-launch "hypervolume ratio" ">>"
-
-################################################################################
-# Stage 4 - normalized modified inverted generational distance, per instance.
-################################################################################
-
-reset_commands
-
-for instance in "${instances[@]}"; do
-  expected_returns="${path}/instances/${instance}/train/expected_returns.csv"
-  covariance="${path}/instances/${instance}/train/covariance_matrix.csv"
-  command="${path}/bin/exec/normalized_modified_generational_distance_calculator_exec "
-  command+="--expected-returns-filename ${expected_returns} "
-  command+="--covariance-filename ${covariance} "
-  command+="--reference-pareto ${path}/pareto/${instance}.txt "
-  command+="--reference-point ${path}/pareto/${instance}_point.txt "
-  j=0
-  for solver in "${solvers[@]}"; do
-    for seed in "${seeds[@]}"; do
-      command+="--pareto-${j} ${path}/pareto/${instance}_${solver}_${seed}.txt "
-      command+="--best-solutions-snapshots-${j} ${path}/best_solutions_snapshots/${instance}_${solver}_${seed}_ "
       command+="--nigd-plus-${j} ${path}/nigd_plus/${instance}_${solver}_${seed}.txt "
       command+="--nigd-plus-snapshots-${j} ${path}/nigd_plus_snapshots/${instance}_${solver}_${seed}.txt "
       j=$((j + 1))
@@ -218,10 +192,10 @@ for instance in "${instances[@]}"; do
   dispatch "${command}"
 done
 
-launch "nigd plus" ">>"
+launch "metrics" ">>"
 
 ################################################################################
-# Stage 5 - per (instance, solver) aggregation into best and median runs.
+# Stage 3 - per (instance, solver) aggregation into best and median runs.
 ################################################################################
 
 reset_commands
@@ -275,7 +249,7 @@ done
 launch "results aggregation" ">>"
 
 ################################################################################
-# Stage 6 - plots.
+# Stage 4 - plots.
 ################################################################################
 
 plotters=(hvr hvr_snapshots nigd_plus nigd_plus_snapshots metrics
@@ -291,7 +265,7 @@ done
 wait
 
 ################################################################################
-# Stage 7 - videos.
+# Stage 5 - videos.
 ################################################################################
 
 # Stitch the PNG frames named "<prefix>_<n>.png" into a video, then drop the
@@ -133,6 +133,7 @@ for instance in "${pending[@]}"; do
            --expected-returns-filename "${expected_returns}"
            --covariance-filename "${covariance}"
            --max-num-solutions "${MOPOP_PILOT_MAX_REF_SOLUTIONS}"
+           --num-threads "${MOPOP_PILOT_JOBS}"
            --reference-pareto "${work_dir}/${instance}_front.txt"
            --reference-point "${path}/instances/${instance}/reference_point.txt")
 
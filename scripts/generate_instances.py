@@ -34,6 +34,7 @@ import sys
 import time
 from typing import Dict, List, Optional, Sequence, Tuple
 
+import numpy as np
 import pandas as pd
 
 # --- Paths and constants ---
@@ -78,6 +79,13 @@ EXPECTED_RETURNS_FILENAME = "expected_returns.csv"
 COVARIANCE_FILENAME = "covariance_matrix.csv"
 EXPECTED_RETURNS_COLUMN = "ExpectedDailyReturn"
 
+# The factor model file holds Sigma ~ B F B^T + D. Its header names the factors
+# and ends with IDIOSYNCRATIC_COLUMN, which is how `Instance::load_instance`
+# tells it from a covariance matrix; then come one row per factor with F and
+# one row per ticker with its loadings and its diagonal entry of D.
+FACTOR_MODEL_FILENAME = "factor_model.csv"
+IDIOSYNCRATIC_COLUMN = "Idiosyncratic"
+
 
 def setup_logging() -> None:
   """Configures basic logging for the script."""
@@ -544,14 +552,63 @@ def calculate_covariance_matrix(returns: pd.DataFrame) -> pd.DataFrame:
   return returns.cov()
 
 
+def calculate_factor_model(
+    covariance: pd.DataFrame,
+    num_factors: int) -> Tuple[np.ndarray, np.ndarray, np.ndarray]:
+  """
+  Fits a factor model to a covariance matrix by principal components.
+
+  The factors are the num_factors leading eigenvectors of the covariance of the
+  returns window, so B holds the eigenvectors and F is the diagonal of their
+  eigenvalues. D is whatever variance of each asset the factors leave out, which
+  makes the diagonal of B F B^T + D match the sample variances exactly.
+
+  @return The (loadings, factor_covariance, idiosyncratic_variances) triple.
+  @raises RuntimeError If there are not more assets than factors.
+  """
+  matrix = covariance.to_numpy(dtype=float)
+  if num_factors >= matrix.shape[0]:
+    raise RuntimeError(
+        f"{num_factors} factors need more than {matrix.shape[0]} assets")
+
+  eigenvalues, eigenvectors = np.linalg.eigh(matrix)
+  order = np.argsort(eigenvalues)[::-1][:num_factors]
+  factor_variances = np.clip(eigenvalues[order], 0.0, None)
+  loadings = eigenvectors[:, order]
+  explained = (loadings ** 2) @ factor_variances
+  idiosyncratic = np.clip(np.diag(matrix) - explained, 0.0, None)
+  return loadings, np.diag(factor_variances), idiosyncratic
+
+
+def write_factor_model(path: str, covariance: pd.DataFrame,
+                       num_factors: int) -> None:
+  """Writes the factor model file of one window, in the covariance order."""
+  loadings, factor_covariance, idiosyncratic = calculate_factor_model(
+      covariance, num_factors)
+  names = [f"F{k + 1}" for k in range(num_factors)]
+
+  with open(path, "w", encoding="utf-8", newline="") as handle:
+    writer = csv.writer(handle, lineterminator="\n")
+    writer.writerow(["Ticker"] + names + [IDIOSYNCRATIC_COLUMN])
+    for name, row in zip(names, factor_covariance):
+      writer.writerow([name] + [repr(float(x)) for x in row])
+    for ticker, row, variance in zip(covariance.index, loadings,
+                                     idiosyncratic):
+      writer.writerow([ticker] + [repr(float(x)) for x in row] +
+                      [repr(float(variance))])
+
+
 def write_window(directory: str, returns: pd.DataFrame,
-                 tickers: Sequence[str]) -> Dict[str, str]:
+                 tickers: Sequence[str],
+                 num_factors: int = 0) -> Dict[str, str]:
   """
-  Writes the two instance files of one window and returns their digests.
+  Writes the instance files of one window and returns their digests.
 
   Both files are emitted in the same ticker order because
   `Instance::load_instance` aligns expected-returns row i with covariance
-  row/column i positionally, without matching names.
+  row/column i positionally, without matching names. With num_factors > 0 a
+  factor model of the covariance matrix is written alongside it, for universes
+  too large for the dense matrix.
   """
   os.makedirs(directory, exist_ok=True)
   ordered = list(tickers)
@@ -571,11 +628,18 @@ def write_window(directory: str, returns: pd.DataFrame,
   covariance.columns.name = None
   covariance.to_csv(covariance_path, lineterminator="\n")
 
-  return {
+  digests = {
       EXPECTED_RETURNS_FILENAME: sha256_file(expected_returns_path),
       COVARIANCE_FILENAME: sha256_file(covariance_path),
   }
 
+  if num_factors > 0:
+    factor_model_path = os.path.join(directory, FACTOR_MODEL_FILENAME)
+    write_factor_model(factor_model_path, covariance, num_factors)
+    digests[FACTOR_MODEL_FILENAME] = sha256_file(factor_model_path)
+
+  return digests
+
 
 def window_metadata(name: str, start: pd.Timestamp, end: pd.Timestamp,
                     returns: pd.DataFrame, digests: Dict[str, str]) -> Dict:
@@ -592,7 +656,8 @@ def window_metadata(name: str, start: pd.Timestamp, end: pd.Timestamp,
 
 
 def build_instance(year: int, prices: pd.DataFrame, candidates: List[str],
-                   min_coverage: float, allow_partial: bool) -> Dict:
+                   min_coverage: float, allow_partial: bool,
+                   num_factors: int = 0) -> Dict:
   """
   Builds one instance, writing its two windows and its metadata.
 
@@ -691,7 +756,7 @@ def build_instance(year: int, prices: pd.DataFrame, candidates: List[str],
       raise RuntimeError(
           f"{name}: the {window_name} window yielded no returns")
     digests = write_window(
-        os.path.join(instance_dir, window_name), returns, kept)
+        os.path.join(instance_dir, window_name), returns, kept, num_factors)
     metadata["windows"][window_name] = window_metadata(
         window_name, start, end, returns, digests)
     logging.info(
@@ -727,7 +792,7 @@ def command_build(args: argparse.Namespace) -> int:
   for year in years:
     try:
       build_instance(year, prices, candidates_by_year[year],
-                     args.min_coverage, args.allow_partial)
+                     args.min_coverage, args.allow_partial, args.num_factors)
     except RuntimeError as error:
       logging.error(str(error))
       failures.append(f"ibov_{year}")
@@ -781,6 +846,11 @@ def setup_arg_parser() -> argparse.ArgumentParser:
   build.add_argument(
       "--allow-partial", action="store_true",
       help="drop constituents that fail the coverage rule instead of failing")
+  build.add_argument(
+      "--num-factors", type=int, default=0,
+      help=f"also write {FACTOR_MODEL_FILENAME}, a principal component factor "
+           f"model of each covariance matrix with this many factors. "
+           f"Default: 0 (none)")
   build.add_argument(
       "--no-verify", action="store_true",
       help="skip the cache checksum verification")
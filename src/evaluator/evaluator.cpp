@@ -0,0 +1,1178 @@
+#include "evaluator/evaluator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "evaluator/quadratic_form.hpp"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define MOPOP_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace mopop {
+
+namespace {
+
+/**
+ * @brief The sums accumulated by the sweep over the weights.
+ */
+struct Linear_Sums {
+  /**
+   * @brief The weighted sum of the expected returns.
+   */
+  double expected_return;
+
+  /**
+   * @brief The entropy of the weights.
+   */
+  double entropy;
+};
+
+/**
+ * @brief The kernels compiled for one instruction set.
+ */
+struct Kernels {
+  /**
+   * @brief Sums the n entries of a key.
+   */
+  double (*sum)(const double* key, unsigned n);
+
+  /**
+   * @brief Divides the n entries of a key by a divisor, stores the quotients
+   * as weights unless weight is null, and accumulates the expected return and
+   * the entropy of those weights.
+   */
+  Linear_Sums (*linear)(const double* key, double divisor,
+                        const double* expected_returns, unsigned n,
+                        double* weight);
+
+  /**
+   * @brief Computes the variance with a dense covariance matrix.
+   */
+  double (*dense)(const Instance& instance, const double* weight);
+
+  /**
+   * @brief Computes the variance with a packed covariance matrix.
+   */
+  double (*packed)(const Instance& instance, const double* weight);
+
+  /**
+   * @brief Computes the variance with a factor model covariance matrix.
+   */
+  double (*factor)(const Instance& instance, const double* weight);
+
+  /**
+   * @brief Adds to y0[t] the dot product of row0 and w[t] over the columns
+   * [begin, end), for each of the batch_tile_size portfolios of a tile, and
+   * does the same for row1 and y1 unless row1 is null.
+   */
+  void (*tile_dots)(const double* row0, const double* row1,
+                    const double* const* w, unsigned begin, unsigned end,
+                    double* y0, double* y1);
+};
+
+double scalar_sum(const double* key, unsigned n) {
+  double total = 0.0;
+
+  for (unsigned i = 0; i < n; i++) {
+    total += key[i];
+  }
+
+  return total;
+}
+
+Linear_Sums scalar_linear(const double* key, double divisor,
+                          const double* expected_returns, unsigned n,
+                          double* weight) {
+  Linear_Sums sums = {0.0, 0.0};
+
+  for (unsigned i = 0; i < n; i++) {
+    const double w = key[i] / divisor;
+
+    if (weight != nullptr) {
+      weight[i] = w;
+    }
+
+    sums.expected_return += w * expected_returns[i];
+
+    if (w > 0.0) {
+      sums.entropy -= w * std::log2(w);
+    }
+  }
+
+  return sums;
+}
+
+/**
+ * @brief The number of columns of each block of the product, chosen so that
+ * the weights of a tile and two rows of covariances stay in L1 cache.
+ */
+constexpr unsigned batch_column_block = 256;
+
+void scalar_tile_dots(const double* row0, const double* row1,
+                      const double* const* w, unsigned begin, unsigned end,
+                      double* y0, double* y1) {
+  for (unsigned t = 0; t < batch_tile_size; t++) {
+    double dot0 = 0.0, dot1 = 0.0;
+
+    for (unsigned j = begin; j < end; j++) {
+      dot0 += row0[j] * w[t][j];
+
+      if (row1 != nullptr) {
+        dot1 += row1[j] * w[t][j];
+      }
+    }
+
+    y0[t] += dot0;
+
+    if (row1 != nullptr) {
+      y1[t] += dot1;
+    }
+  }
+}
+
+/**
+ * @brief Computes the variances of a batch of portfolios.
+ *
+ * The portfolios are taken batch_tile_size at a time. For each tile the
+ * product Y = Sigma W^T is built one block of columns at a time, two rows of
+ * covariances against the whole tile per call to the tile_dots kernel, so that
+ * every covariance entry is loaded once per tile instead of once per
+ * portfolio. The rows where the whole tile has zero weight are skipped. Each
+ * variance is then the dot product of the weights with the matching column of
+ * Y. With packed storage Y only holds the upper triangle without the diagonal,
+ * which is added back as w_i (sigma_ii w_i + 2 y_i).
+ *
+ * @tparam Packed Whether the covariance matrix is packed.
+ * @param instance The instance.
+ * @param tile_dots The tile kernel of the active instruction set.
+ * @param weights The num_portfolios x num_assets weights, row by row.
+ * @param num_portfolios The number of portfolios.
+ * @param value The num_portfolios x 4 objective values, of which only the
+ * variances are written.
+ */
+template <bool Packed>
+void batch_variances(const Instance& instance,
+                     decltype(Kernels::tile_dots) tile_dots,
+                     const double* weights, std::size_t num_portfolios,
+                     double* value) {
+  const unsigned n = instance.num_assets;
+  const std::vector<double> zeros(n, 0.0);
+  std::vector<double> products(n * batch_tile_size);
+  std::vector<unsigned> rows;
+  rows.reserve(n);
+
+  for (std::size_t first = 0; first < num_portfolios;
+       first += batch_tile_size) {
+    const double* w[batch_tile_size];
+
+    // The last tile is padded with the zero portfolio.
+    for (unsigned t = 0; t < batch_tile_size; t++) {
+      w[t] = first + t < num_portfolios ? weights + (first + t) * n
+                                        : zeros.data();
+    }
+
+    rows.clear();
+
+    for (unsigned i = 0; i < n; i++) {
+      for (unsigned t = 0; t < batch_tile_size; t++) {
+        if (w[t][i] != 0.0) {
+          rows.push_back(i);
+          break;
+        }
+      }
+    }
+
+    std::fill(products.begin(), products.end(), 0.0);
+
+    for (unsigned begin = 0; begin < n; begin += batch_column_block) {
+      const unsigned end = std::min(n, begin + batch_column_block);
+
+      for (std::size_t k = 0; k < rows.size(); k += 2) {
+        const unsigned i0 = rows[k];
+        const bool paired = k + 1 < rows.size();
+        const unsigned i1 = paired ? rows[k + 1] : i0;
+        double* y0 = products.data() + i0 * batch_tile_size;
+        double* y1 = products.data() + i1 * batch_tile_size;
+
+        if (!Packed) {
+          tile_dots(instance.covariance_row(i0).data(),
+                    paired ? instance.covariance_row(i1).data() : nullptr, w,
+                    begin, end, y0, paired ? y1 : nullptr);
+          continue;
+        }
+
+        // The rows are sorted, so no later row has an entry in this block.
+        if (i0 + 1 >= end) {
+          break;
+        }
+
+        // Packed rows are addressed by column, row i holding the columns above
+        // i. Row i0 runs alone up to the first column of row i1.
+        const double* row0 = instance.covariance_data.data() +
+                             instance.packed_offset(i0) - i0;
+        const unsigned low = std::max(begin, i0 + 1);
+        const unsigned middle =
+            paired ? std::min(end, std::max(begin, i1 + 1)) : end;
+
+        if (low < middle) {
+          tile_dots(row0, nullptr, w, low, middle, y0, nullptr);
+        }
+
+        if (paired && middle < end) {
+          tile_dots(row0,
+                    instance.covariance_data.data() +
+                        instance.packed_offset(i1) - i1,
+                    w, middle, end, y0, y1);
+        }
+      }
+    }
+
+    for (unsigned t = 0; t < batch_tile_size && first + t < num_portfolios;
+         t++) {
+      double variance = 0.0;
+
+      for (unsigned i : rows) {
+        const double y = products[i * batch_tile_size + t];
+
+        if (Packed) {
+          const double diagonal = instance.packed_covariance_row(i)[0];
+          variance += w[t][i] * (diagonal * w[t][i] + 2.0 * y);
+        } else {
+          variance += w[t][i] * y;
+        }
+      }
+
+      value[4 * (first + t) + 1] = variance;
+    }
+  }
+}
+
+#ifdef MOPOP_X86_KERNELS
+
+/**
+ * The vectorized log2 splits x into 2^e * m with m in [sqrt(1/2), sqrt(2)) and
+ * evaluates log(m) = 2 atanh(s), s = (m - 1) / (m + 1), as 2 s times a
+ * polynomial in s^2. With |s| <= 0.172 the 13 terms below are exact to well
+ * under one ulp, so the vector kernels agree with std::log2 up to rounding. The
+ * caller masks out the lanes that are not normal positive numbers.
+ */
+constexpr double log2_coefficients[] = {
+    1.0,        1.0 / 3.0,  1.0 / 5.0,  1.0 / 7.0,  1.0 / 9.0,
+    1.0 / 11.0, 1.0 / 13.0, 1.0 / 15.0, 1.0 / 17.0, 1.0 / 19.0,
+    1.0 / 21.0, 1.0 / 23.0, 1.0 / 25.0};
+constexpr int num_log2_coefficients =
+    sizeof(log2_coefficients) / sizeof(log2_coefficients[0]);
+constexpr double two_log2e = 2.0 * 1.4426950408889634073599246810019;
+constexpr double sqrt2 = 1.4142135623730950488016887242097;
+constexpr double two_pow_52 = 4503599627370496.0;
+
+/**
+ * @brief Adds up the lanes of a compensated sum with Neumaier's algorithm.
+ *
+ * The vector kernels accumulate the entropy in a different order than the
+ * scalar one, so they carry the rounding errors of every product and addition
+ * in a compensation vector. Folding it in at the end makes the vector entropy
+ * as accurate as a sum in twice the working precision, which keeps it within
+ * rounding of the scalar reference, e.g. log2(n) for the uniform portfolio.
+ *
+ * @param sums The lanes of the running sum.
+ * @param compensations The lanes of the accumulated rounding errors.
+ * @param num_lanes The number of lanes.
+ * @return The compensated total.
+ */
+double compensated_total(const double* sums, const double* compensations,
+                         unsigned num_lanes) {
+  double total = 0.0, compensation = 0.0;
+
+  for (unsigned i = 0; i < num_lanes; i++) {
+    const double t = total + sums[i];
+
+    if (std::fabs(total) >= std::fabs(sums[i])) {
+      compensation += (total - t) + sums[i];
+    } else {
+      compensation += (sums[i] - t) + total;
+    }
+
+    total = t;
+    compensation += compensations[i];
+  }
+
+  return total + compensation;
+}
+
+__attribute__((target("avx2,fma"))) inline double avx2_horizontal_sum(
+    __m256d x) {
+  __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(x),
+                           _mm256_extractf128_pd(x, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+
+__attribute__((target("avx2,fma"))) inline __m256i avx2_tail_mask(
+    unsigned remaining) {
+  return _mm256_cmpgt_epi64(_mm256_set1_epi64x(remaining),
+                            _mm256_setr_epi64x(0, 1, 2, 3));
+}
+
+__attribute__((target("avx2,fma"))) inline __m256d avx2_log2(__m256d x) {
+  const __m256i bits = _mm256_castpd_si256(x);
+  const __m256d one = _mm256_set1_pd(1.0);
+  __m256d m = _mm256_castsi256_pd(_mm256_or_si256(
+      _mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+      _mm256_castpd_si256(one)));
+  __m256d e = _mm256_sub_pd(
+      _mm256_castsi256_pd(_mm256_or_si256(
+          _mm256_srli_epi64(bits, 52),
+          _mm256_castpd_si256(_mm256_set1_pd(two_pow_52)))),
+      _mm256_set1_pd(two_pow_52 + 1023.0));
+  const __m256d above = _mm256_cmp_pd(m, _mm256_set1_pd(sqrt2), _CMP_GT_OQ);
+  m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), above);
+  e = _mm256_add_pd(e, _mm256_and_pd(above, one));
+
+  const __m256d s = _mm256_div_pd(_mm256_sub_pd(m, one), _mm256_add_pd(m, one));
+  const __m256d s2 = _mm256_mul_pd(s, s);
+  __m256d p = _mm256_set1_pd(log2_coefficients[num_log2_coefficients - 1]);
+
+  for (int k = num_log2_coefficients - 2; k >= 0; k--) {
+    p = _mm256_fmadd_pd(p, s2, _mm256_set1_pd(log2_coefficients[k]));
+  }
+
+  return _mm256_fmadd_pd(_mm256_mul_pd(s, p), _mm256_set1_pd(two_log2e), e);
+}
+
+__attribute__((target("avx2,fma"))) double avx2_sum(const double* key,
+                                                    unsigned n) {
+  __m256d acc = _mm256_setzero_pd();
+  unsigned i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    acc = _mm256_add_pd(acc, _mm256_loadu_pd(key + i));
+  }
+
+  if (i < n) {
+    acc = _mm256_add_pd(acc,
+                        _mm256_maskload_pd(key + i, avx2_tail_mask(n - i)));
+  }
+
+  return avx2_horizontal_sum(acc);
+}
+
+__attribute__((target("avx2,fma"))) inline void avx2_linear_step(
+    __m256d w, __m256d r, __m256d& expected_return, __m256d& entropy,
+    __m256d& compensation) {
+  const __m256d valid = _mm256_cmp_pd(
+      w, _mm256_set1_pd(std::numeric_limits<double>::min()), _CMP_GE_OQ);
+  const __m256d log2_w = _mm256_and_pd(avx2_log2(w), valid);
+  expected_return = _mm256_fmadd_pd(w, r, expected_return);
+
+  // entropy - product, with the errors of the product and of the subtraction
+  // moved into the compensation.
+  const __m256d product = _mm256_mul_pd(w, log2_w);
+  const __m256d product_error = _mm256_fmsub_pd(w, log2_w, product);
+  const __m256d t = _mm256_sub_pd(entropy, product);
+  const __m256d z = _mm256_sub_pd(t, entropy);
+  const __m256d error =
+      _mm256_sub_pd(_mm256_sub_pd(entropy, _mm256_sub_pd(t, z)),
+                    _mm256_add_pd(product, z));
+  compensation =
+      _mm256_add_pd(compensation, _mm256_sub_pd(error, product_error));
+  entropy = t;
+}
+
+__attribute__((target("avx2,fma"))) Linear_Sums avx2_linear(
+    const double* key, double divisor, const double* expected_returns,
+    unsigned n, double* weight) {
+  const __m256d d = _mm256_set1_pd(divisor);
+  __m256d expected_return = _mm256_setzero_pd();
+  __m256d entropy = _mm256_setzero_pd();
+  __m256d compensation = _mm256_setzero_pd();
+  unsigned i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    const __m256d w = _mm256_div_pd(_mm256_loadu_pd(key + i), d);
+
+    if (weight != nullptr) {
+      _mm256_storeu_pd(weight + i, w);
+    }
+
+    avx2_linear_step(w, _mm256_loadu_pd(expected_returns + i),
+                     expected_return, entropy, compensation);
+  }
+
+  if (i < n) {
+    const __m256i mask = avx2_tail_mask(n - i);
+    const __m256d w = _mm256_div_pd(_mm256_maskload_pd(key + i, mask), d);
+
+    if (weight != nullptr) {
+      _mm256_maskstore_pd(weight + i, mask, w);
+    }
+
+    avx2_linear_step(w, _mm256_maskload_pd(expected_returns + i, mask),
+                     expected_return, entropy, compensation);
+  }
+
+  alignas(32) double entropy_lanes[4], compensation_lanes[4];
+  _mm256_store_pd(entropy_lanes, entropy);
+  _mm256_store_pd(compensation_lanes, compensation);
+
+  return {avx2_horizontal_sum(expected_return),
+          compensated_total(entropy_lanes, compensation_lanes, 4)};
+}
+
+__attribute__((target("avx2,fma"))) double avx2_dense(const Instance& instance,
+                                                      const double* weight) {
+  const unsigned n = instance.num_assets;
+  double result = 0.0;
+
+  for (unsigned i = 0; i < n; i++) {
+    if (weight[i] == 0.0) {
+      continue;
+    }
+
+    const double* row = instance.covariance_row(i).data();
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    unsigned j = 0;
+
+    for (; j + 8 <= n; j += 8) {
+      acc0 = _mm256_fmadd_pd(_mm256_load_pd(row + j),
+                             _mm256_loadu_pd(weight + j), acc0);
+      acc1 = _mm256_fmadd_pd(_mm256_load_pd(row + j + 4),
+                             _mm256_loadu_pd(weight + j + 4), acc1);
+    }
+
+    for (; j + 4 <= n; j += 4) {
+      acc0 = _mm256_fmadd_pd(_mm256_load_pd(row + j),
+                             _mm256_loadu_pd(weight + j), acc0);
+    }
+
+    // The row is padded with zeros up to the stride, so only the weights need
+    // a masked load.
+    if (j < n) {
+      acc1 = _mm256_fmadd_pd(
+          _mm256_load_pd(row + j),
+          _mm256_maskload_pd(weight + j, avx2_tail_mask(n - j)), acc1);
+    }
+
+    result += weight[i] * avx2_horizontal_sum(_mm256_add_pd(acc0, acc1));
+  }
+
+  return result;
+}
+
+__attribute__((target("avx2,fma"))) double avx2_packed(const Instance& instance,
+                                                       const double* weight) {
+  const unsigned n = instance.num_assets;
+  double result = 0.0;
+
+  for (unsigned i = 0; i < n; i++) {
+    if (weight[i] == 0.0) {
+      continue;
+    }
+
+    const double* row = instance.packed_covariance_row(i).data();
+    const double* tail = weight + i;
+    const unsigned length = n - i;
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    unsigned j = 1;
+
+    for (; j + 8 <= length; j += 8) {
+      acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(row + j),
+                             _mm256_loadu_pd(tail + j), acc0);
+      acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(row + j + 4),
+                             _mm256_loadu_pd(tail + j + 4), acc1);
+    }
+
+    for (; j + 4 <= length; j += 4) {
+      acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(row + j),
+                             _mm256_loadu_pd(tail + j), acc0);
+    }
+
+    if (j < length) {
+      const __m256i mask = avx2_tail_mask(length - j);
+      acc1 = _mm256_fmadd_pd(_mm256_maskload_pd(row + j, mask),
+                             _mm256_maskload_pd(tail + j, mask), acc1);
+    }
+
+    const double off_diagonal = avx2_horizontal_sum(_mm256_add_pd(acc0, acc1));
+    result += weight[i] * (row[0] * weight[i] + 2.0 * off_diagonal);
+  }
+
+  return result;
+}
+
+__attribute__((target("avx2,fma"))) double avx2_factor(
+    const Instance& instance, const double* weight) {
+  const unsigned n = instance.num_assets;
+  const double* idiosyncratic = instance.idiosyncratic_variances().data();
+  double result = 0.0;
+
+  for (unsigned f = 0; f < instance.num_factors; f++) {
+    const double* exposures = instance.factor_exposures(f).data();
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    unsigned i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+      acc0 = _mm256_fmadd_pd(_mm256_load_pd(exposures + i),
+                             _mm256_loadu_pd(weight + i), acc0);
+      acc1 = _mm256_fmadd_pd(_mm256_load_pd(exposures + i + 4),
+                             _mm256_loadu_pd(weight + i + 4), acc1);
+    }
+
+    for (; i + 4 <= n; i += 4) {
+      acc0 = _mm256_fmadd_pd(_mm256_load_pd(exposures + i),
+                             _mm256_loadu_pd(weight + i), acc0);
+    }
+
+    // The rows are padded with zeros up to the stride, so only the weights
+    // need a masked load.
+    if (i < n) {
+      acc1 = _mm256_fmadd_pd(
+          _mm256_load_pd(exposures + i),
+          _mm256_maskload_pd(weight + i, avx2_tail_mask(n - i)), acc1);
+    }
+
+    const double exposure = avx2_horizontal_sum(_mm256_add_pd(acc0, acc1));
+    result += exposure * exposure;
+  }
+
+  __m256d acc = _mm256_setzero_pd();
+  unsigned i = 0;
+
+  for (; i + 4 <= n; i += 4) {
+    const __m256d w = _mm256_loadu_pd(weight + i);
+    acc = _mm256_fmadd_pd(_mm256_mul_pd(_mm256_load_pd(idiosyncratic + i), w),
+                          w, acc);
+  }
+
+  if (i < n) {
+    const __m256d w = _mm256_maskload_pd(weight + i, avx2_tail_mask(n - i));
+    acc = _mm256_fmadd_pd(_mm256_mul_pd(_mm256_load_pd(idiosyncratic + i), w),
+                          w, acc);
+  }
+
+  return result + avx2_horizontal_sum(acc);
+}
+
+__attribute__((target("avx512f"))) inline __mmask8 avx512_tail_mask(
+    unsigned remaining) {
+  return __mmask8((1u << remaining) - 1u);
+}
+
+__attribute__((target("avx512f"))) inline __m512d avx512_log2(__m512d x) {
+  const __m512d one = _mm512_set1_pd(1.0);
+  __m512d m = _mm512_getmant_pd(x, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_zero);
+  __m512d e = _mm512_getexp_pd(x);
+  const __mmask8 above =
+      _mm512_cmp_pd_mask(m, _mm512_set1_pd(sqrt2), _CMP_GT_OQ);
+  m = _mm512_mask_mul_pd(m, above, m, _mm512_set1_pd(0.5));
+  e = _mm512_mask_add_pd(e, above, e, one);
+
+  const __m512d s = _mm512_div_pd(_mm512_sub_pd(m, one), _mm512_add_pd(m, one));
+  const __m512d s2 = _mm512_mul_pd(s, s);
+  __m512d p = _mm512_set1_pd(log2_coefficients[num_log2_coefficients - 1]);
+
+  for (int k = num_log2_coefficients - 2; k >= 0; k--) {
+    p = _mm512_fmadd_pd(p, s2, _mm512_set1_pd(log2_coefficients[k]));
+  }
+
+  return _mm512_fmadd_pd(_mm512_mul_pd(s, p), _mm512_set1_pd(two_log2e), e);
+}
+
+__attribute__((target("avx512f"))) double avx512_sum(const double* key,
+                                                     unsigned n) {
+  __m512d acc = _mm512_setzero_pd();
+  unsigned i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    acc = _mm512_add_pd(acc, _mm512_loadu_pd(key + i));
+  }
+
+  if (i < n) {
+    acc = _mm512_add_pd(
+        acc, _mm512_maskz_loadu_pd(avx512_tail_mask(n - i), key + i));
+  }
+
+  return _mm512_reduce_add_pd(acc);
+}
+
+__attribute__((target("avx512f"))) inline void avx512_linear_step(
+    __m512d w, __m512d r, __m512d& expected_return, __m512d& entropy,
+    __m512d& compensation) {
+  const __mmask8 valid = _mm512_cmp_pd_mask(
+      w, _mm512_set1_pd(std::numeric_limits<double>::min()), _CMP_GE_OQ);
+  const __m512d log2_w = _mm512_maskz_mov_pd(valid, avx512_log2(w));
+  expected_return = _mm512_fmadd_pd(w, r, expected_return);
+
+  // entropy - product, with the errors of the product and of the subtraction
+  // moved into the compensation.
+  const __m512d product = _mm512_mul_pd(w, log2_w);
+  const __m512d product_error = _mm512_fmsub_pd(w, log2_w, product);
+  const __m512d t = _mm512_sub_pd(entropy, product);
+  const __m512d z = _mm512_sub_pd(t, entropy);
+  const __m512d error =
+      _mm512_sub_pd(_mm512_sub_pd(entropy, _mm512_sub_pd(t, z)),
+                    _mm512_add_pd(product, z));
+  compensation =
+      _mm512_add_pd(compensation, _mm512_sub_pd(error, product_error));
+  entropy = t;
+}
+
+__attribute__((target("avx512f"))) Linear_Sums avx512_linear(
+    const double* key, double divisor, const double* expected_returns,
+    unsigned n, double* weight) {
+  const __m512d d = _mm512_set1_pd(divisor);
+  __m512d expected_return = _mm512_setzero_pd();
+  __m512d entropy = _mm512_setzero_pd();
+  __m512d compensation = _mm512_setzero_pd();
+  unsigned i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    const __m512d w = _mm512_div_pd(_mm512_loadu_pd(key + i), d);
+
+    if (weight != nullptr) {
+      _mm512_storeu_pd(weight + i, w);
+    }
+
+    avx512_linear_step(w, _mm512_loadu_pd(expected_returns + i),
+                       expected_return, entropy, compensation);
+  }
+
+  if (i < n) {
+    const __mmask8 mask = avx512_tail_mask(n - i);
+    const __m512d w = _mm512_div_pd(_mm512_maskz_loadu_pd(mask, key + i), d);
+
+    if (weight != nullptr) {
+      _mm512_mask_storeu_pd(weight + i, mask, w);
+    }
+
+    avx512_linear_step(w, _mm512_maskz_loadu_pd(mask, expected_returns + i),
+                       expected_return, entropy, compensation);
+  }
+
+  alignas(64) double entropy_lanes[8], compensation_lanes[8];
+  _mm512_store_pd(entropy_lanes, entropy);
+  _mm512_store_pd(compensation_lanes, compensation);
+
+  return {_mm512_reduce_add_pd(expected_return),
+          compensated_total(entropy_lanes, compensation_lanes, 8)};
+}
+
+__attribute__((target("avx512f"))) double avx512_dense(
+    const Instance& instance, const double* weight) {
+  const unsigned n = instance.num_assets;
+  double result = 0.0;
+
+  for (unsigned i = 0; i < n; i++) {
+    if (weight[i] == 0.0) {
+      continue;
+    }
+
+    const double* row = instance.covariance_row(i).data();
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    unsigned j = 0;
+
+    for (; j + 16 <= n; j += 16) {
+      acc0 = _mm512_fmadd_pd(_mm512_load_pd(row + j),
+                             _mm512_loadu_pd(weight + j), acc0);
+      acc1 = _mm512_fmadd_pd(_mm512_load_pd(row + j + 8),
+                             _mm512_loadu_pd(weight + j + 8), acc1);
+    }
+
+    for (; j + 8 <= n; j += 8) {
+      acc0 = _mm512_fmadd_pd(_mm512_load_pd(row + j),
+                             _mm512_loadu_pd(weight + j), acc0);
+    }
+
+    // The row is padded with zeros up to the stride, so only the weights need
+    // a masked load.
+    if (j < n) {
+      acc1 = _mm512_fmadd_pd(
+          _mm512_load_pd(row + j),
+          _mm512_maskz_loadu_pd(avx512_tail_mask(n - j), weight + j), acc1);
+    }
+
+    result += weight[i] * _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+  }
+
+  return result;
+}
+
+__attribute__((target("avx512f"))) double avx512_packed(
+    const Instance& instance, const double* weight) {
+  const unsigned n = instance.num_assets;
+  double result = 0.0;
+
+  for (unsigned i = 0; i < n; i++) {
+    if (weight[i] == 0.0) {
+      continue;
+    }
+
+    const double* row = instance.packed_covariance_row(i).data();
+    const double* tail = weight + i;
+    const unsigned length = n - i;
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    unsigned j = 1;
+
+    for (; j + 16 <= length; j += 16) {
+      acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(row + j),
+                             _mm512_loadu_pd(tail + j), acc0);
+      acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(row + j + 8),
+                             _mm512_loadu_pd(tail + j + 8), acc1);
+    }
+
+    for (; j + 8 <= length; j += 8) {
+      acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(row + j),
+                             _mm512_loadu_pd(tail + j), acc0);
+    }
+
+    if (j < length) {
+      const __mmask8 mask = avx512_tail_mask(length - j);
+      acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, row + j),
+                             _mm512_maskz_loadu_pd(mask, tail + j), acc1);
+    }
+
+    const double off_diagonal =
+        _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+    result += weight[i] * (row[0] * weight[i] + 2.0 * off_diagonal);
+  }
+
+  return result;
+}
+
+__attribute__((target("avx512f"))) double avx512_factor(
+    const Instance& instance, const double* weight) {
+  const unsigned n = instance.num_assets;
+  const double* idiosyncratic = instance.idiosyncratic_variances().data();
+  double result = 0.0;
+
+  for (unsigned f = 0; f < instance.num_factors; f++) {
+    const double* exposures = instance.factor_exposures(f).data();
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    unsigned i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+      acc0 = _mm512_fmadd_pd(_mm512_load_pd(exposures + i),
+                             _mm512_loadu_pd(weight + i), acc0);
+      acc1 = _mm512_fmadd_pd(_mm512_load_pd(exposures + i + 8),
+                             _mm512_loadu_pd(weight + i + 8), acc1);
+    }
+
+    for (; i + 8 <= n; i += 8) {
+      acc0 = _mm512_fmadd_pd(_mm512_load_pd(exposures + i),
+                             _mm512_loadu_pd(weight + i), acc0);
+    }
+
+    // The rows are padded with zeros up to the stride, so only the weights
+    // need a masked load.
+    if (i < n) {
+      acc1 = _mm512_fmadd_pd(
+          _mm512_load_pd(exposures + i),
+          _mm512_maskz_loadu_pd(avx512_tail_mask(n - i), weight + i), acc1);
+    }
+
+    const double exposure = _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+    result += exposure * exposure;
+  }
+
+  __m512d acc = _mm512_setzero_pd();
+  unsigned i = 0;
+
+  for (; i + 8 <= n; i += 8) {
+    const __m512d w = _mm512_loadu_pd(weight + i);
+    acc = _mm512_fmadd_pd(_mm512_mul_pd(_mm512_load_pd(idiosyncratic + i), w),
+                          w, acc);
+  }
+
+  if (i < n) {
+    const __m512d w =
+        _mm512_maskz_loadu_pd(avx512_tail_mask(n - i), weight + i);
+    acc = _mm512_fmadd_pd(_mm512_mul_pd(_mm512_load_pd(idiosyncratic + i), w),
+                          w, acc);
+  }
+
+  return result + _mm512_reduce_add_pd(acc);
+}
+
+template <bool Pair>
+__attribute__((target("avx2,fma"))) inline void avx2_tile_dots_rows(
+    const double* row0, const double* row1, const double* const* w,
+    unsigned begin, unsigned end, double* y0, double* y1) {
+  __m256d acc0[batch_tile_size], acc1[batch_tile_size];
+
+  for (unsigned t = 0; t < batch_tile_size; t++) {
+    acc0[t] = _mm256_setzero_pd();
+    acc1[t] = _mm256_setzero_pd();
+  }
+
+  unsigned j = begin;
+
+  for (; j + 4 <= end; j += 4) {
+    const __m256d r0 = _mm256_loadu_pd(row0 + j);
+    const __m256d r1 = Pair ? _mm256_loadu_pd(row1 + j) : r0;
+
+    for (unsigned t = 0; t < batch_tile_size; t++) {
+      const __m256d wt = _mm256_loadu_pd(w[t] + j);
+      acc0[t] = _mm256_fmadd_pd(r0, wt, acc0[t]);
+
+      if (Pair) {
+        acc1[t] = _mm256_fmadd_pd(r1, wt, acc1[t]);
+      }
+    }
+  }
+
+  if (j < end) {
+    const __m256i mask = avx2_tail_mask(end - j);
+    const __m256d r0 = _mm256_maskload_pd(row0 + j, mask);
+    const __m256d r1 = Pair ? _mm256_maskload_pd(row1 + j, mask) : r0;
+
+    for (unsigned t = 0; t < batch_tile_size; t++) {
+      const __m256d wt = _mm256_maskload_pd(w[t] + j, mask);
+      acc0[t] = _mm256_fmadd_pd(r0, wt, acc0[t]);
+
+      if (Pair) {
+        acc1[t] = _mm256_fmadd_pd(r1, wt, acc1[t]);
+      }
+    }
+  }
+
+  for (unsigned t = 0; t < batch_tile_size; t++) {
+    y0[t] += avx2_horizontal_sum(acc0[t]);
+
+    if (Pair) {
+      y1[t] += avx2_horizontal_sum(acc1[t]);
+    }
+  }
+}
+
+__attribute__((target("avx2,fma"))) void avx2_tile_dots(
+    const double* row0, const double* row1, const double* const* w,
+    unsigned begin, unsigned end, double* y0, double* y1) {
+  if (row1 != nullptr) {
+    avx2_tile_dots_rows<true>(row0, row1, w, begin, end, y0, y1);
+  } else {
+    avx2_tile_dots_rows<false>(row0, row1, w, begin, end, y0, y1);
+  }
+}
+
+template <bool Pair>
+__attribute__((target("avx512f"))) inline void avx512_tile_dots_rows(
+    const double* row0, const double* row1, const double* const* w,
+    unsigned begin, unsigned end, double* y0, double* y1) {
+  __m512d acc0[batch_tile_size], acc1[batch_tile_size];
+
+  for (unsigned t = 0; t < batch_tile_size; t++) {
+    acc0[t] = _mm512_setzero_pd();
+    acc1[t] = _mm512_setzero_pd();
+  }
+
+  unsigned j = begin;
+
+  for (; j + 8 <= end; j += 8) {
+    const __m512d r0 = _mm512_loadu_pd(row0 + j);
+    const __m512d r1 = Pair ? _mm512_loadu_pd(row1 + j) : r0;
+
+    for (unsigned t = 0; t < batch_tile_size; t++) {
+      const __m512d wt = _mm512_loadu_pd(w[t] + j);
+      acc0[t] = _mm512_fmadd_pd(r0, wt, acc0[t]);
+
+      if (Pair) {
+        acc1[t] = _mm512_fmadd_pd(r1, wt, acc1[t]);
+      }
+    }
+  }
+
+  if (j < end) {
+    const __mmask8 mask = avx512_tail_mask(end - j);
+    const __m512d r0 = _mm512_maskz_loadu_pd(mask, row0 + j);
+    const __m512d r1 = Pair ? _mm512_maskz_loadu_pd(mask, row1 + j) : r0;
+
+    for (unsigned t = 0; t < batch_tile_size; t++) {
+      const __m512d wt = _mm512_maskz_loadu_pd(mask, w[t] + j);
+      acc0[t] = _mm512_fmadd_pd(r0, wt, acc0[t]);
+
+      if (Pair) {
+        acc1[t] = _mm512_fmadd_pd(r1, wt, acc1[t]);
+      }
+    }
+  }
+
+  for (unsigned t = 0; t < batch_tile_size; t++) {
+    y0[t] += _mm512_reduce_add_pd(acc0[t]);
+
+    if (Pair) {
+      y1[t] += _mm512_reduce_add_pd(acc1[t]);
+    }
+  }
+}
+
+__attribute__((target("avx512f"))) void avx512_tile_dots(
+    const double* row0, const double* row1, const double* const* w,
+    unsigned begin, unsigned end, double* y0, double* y1) {
+  if (row1 != nullptr) {
+    avx512_tile_dots_rows<true>(row0, row1, w, begin, end, y0, y1);
+  } else {
+    avx512_tile_dots_rows<false>(row0, row1, w, begin, end, y0, y1);
+  }
+}
+
+#endif
+
+/**
+ * @brief The kernels of each instruction set, indexed by Instruction_Set.
+ * Without x86 intrinsics every entry falls back to the scalar kernels.
+ */
+const Kernels kernels_table[] = {
+    {scalar_sum, scalar_linear, dense_quadratic_form, packed_quadratic_form,
+     factor_quadratic_form, scalar_tile_dots},
+#ifdef MOPOP_X86_KERNELS
+    {avx2_sum, avx2_linear, avx2_dense, avx2_packed, avx2_factor,
+     avx2_tile_dots},
+    {avx512_sum, avx512_linear, avx512_dense, avx512_packed, avx512_factor,
+     avx512_tile_dots},
+#else
+    {scalar_sum, scalar_linear, dense_quadratic_form, packed_quadratic_form,
+     factor_quadratic_form, scalar_tile_dots},
+    {scalar_sum, scalar_linear, dense_quadratic_form, packed_quadratic_form,
+     factor_quadratic_form, scalar_tile_dots},
+#endif
+};
+
+/**
+ * @brief Returns the active instruction set, which starts as the widest one
+ * supported.
+ */
+Instruction_Set& active() {
+  static Instruction_Set instruction_set = supported_instruction_set();
+  return instruction_set;
+}
+
+const Kernels& kernels() { return kernels_table[int(active())]; }
+
+/**
+ * @brief Decodes a key into weights and accumulates their linear sums.
+ */
+Linear_Sums decode(const Instance& instance, const Kernels& k,
+                   const double* key, double* weight) {
+  const double total_weight = k.sum(key, instance.num_assets);
+
+  if (total_weight > 0.0) {
+    return k.linear(key, total_weight, instance.expected_returns.data(),
+                    instance.num_assets, weight);
+  }
+
+  for (unsigned i = 0; i < instance.num_assets; i++) {
+    weight[i] = 1.0 / ((double)instance.num_assets);
+  }
+
+  return k.linear(weight, 1.0, instance.expected_returns.data(),
+                  instance.num_assets, nullptr);
+}
+
+/**
+ * @brief Computes the variance of a portfolio with the kernel matching the
+ * covariance storage of the instance.
+ */
+double variance(const Instance& instance, const Kernels& k,
+                const double* weight) {
+  switch (instance.covariance_storage) {
+    case Covariance_Storage::PACKED: {
+      return k.packed(instance, weight);
+    }
+
+    case Covariance_Storage::FACTOR: {
+      return k.factor(instance, weight);
+    }
+
+    default: {
+      return k.dense(instance, weight);
+    }
+  }
+}
+
+/**
+ * @brief Fills in the ratio of the expected return to the standard deviation.
+ */
+void set_sharpe_ratio(double* value) {
+  if (value[1] > 0.0) {
+    value[2] = value[0] / std::sqrt(value[1]);
+  } else {
+    value[2] = 0.0;
+  }
+}
+
+/**
+ * @brief Fills in the objective values from the linear sums and the weights.
+ */
+void finish(const Instance& instance, const Kernels& k, const double* weight,
+            const Linear_Sums& sums, double* value) {
+  value[0] = sums.expected_return;
+  value[1] = variance(instance, k, weight);
+  value[3] = sums.entropy;
+  set_sharpe_ratio(value);
+}
+
+}  // namespace
+
+/**
+ * @brief Returns the widest instruction set the running CPU supports.
+ *
+ * @return The widest supported instruction set.
+ */
+Instruction_Set supported_instruction_set() {
+#ifdef MOPOP_X86_KERNELS
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx512f")) {
+    return Instruction_Set::AVX512;
+  }
+
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return Instruction_Set::AVX2;
+  }
+#endif
+
+  return Instruction_Set::SCALAR;
+}
+
+/**
+ * @brief Returns the instruction set the evaluation kernels currently run with.
+ *
+ * It is the widest supported one unless set_instruction_set narrowed it.
+ *
+ * @return The active instruction set.
+ */
+Instruction_Set active_instruction_set() { return active(); }
+
+/**
+ * @brief Selects the instruction set the evaluation kernels run with.
+ *
+ * It is clamped to the widest supported one. This is meant for tests and
+ * benchmarks, and must not be called while another thread is evaluating.
+ *
+ * @param instruction_set The requested instruction set.
+ * @return The instruction set actually selected.
+ */
+Instruction_Set set_instruction_set(Instruction_Set instruction_set) {
+  const Instruction_Set supported = supported_instruction_set();
+
+  if (int(instruction_set) > int(supported)) {
+    instruction_set = supported;
+  }
+
+  active() = instruction_set;
+  return instruction_set;
+}
+
+/**
+ * @brief Returns the name of an instruction set.
+ *
+ * @param instruction_set The instruction set.
+ * @return "scalar", "avx2" or "avx512".
+ */
+const char* instruction_set_name(Instruction_Set instruction_set) {
+  switch (instruction_set) {
+    case Instruction_Set::AVX2: {
+      return "avx2";
+    }
+
+    case Instruction_Set::AVX512: {
+      return "avx512";
+    }
+
+    default: {
+      return "scalar";
+    }
+  }
+}
+
+/**
+ * @brief Computes the variance of a portfolio with the kernel matching both the
+ * covariance storage of the instance and the active instruction set.
+ *
+ * @param instance The instance.
+ * @param weight The num_assets weights of the portfolio.
+ * @return The variance of the portfolio.
+ */
+double evaluate_variance(const Instance& instance, const double* weight) {
+  return variance(instance, kernels(), weight);
+}
+
+/**
+ * @brief Computes the four objective values of a portfolio given by its
+ * weights, which are taken as they are.
+ *
+ * @param instance The instance.
+ * @param weight The num_assets weights of the portfolio.
+ * @param value The 4 objective values, written by the function.
+ */
+void evaluate_weights(const Instance& instance, const double* weight,
+                      double* value) {
+  const Kernels& k = kernels();
+  const Linear_Sums sums =
+      k.linear(weight, 1.0, instance.expected_returns.data(),
+               instance.num_assets, nullptr);
+  finish(instance, k, weight, sums, value);
+}
+
+/**
+ * @brief Decodes a key into a portfolio and computes its four objective values.
+ *
+ * @param instance The instance.
+ * @param key The num_assets entries of the key.
+ * @param weight The num_assets weights of the portfolio, written by the
+ * function. It may not alias the key.
+ * @param value The 4 objective values, written by the function.
+ */
+void evaluate(const Instance& instance, const double* key, double* weight,
+              double* value) {
+  const Kernels& k = kernels();
+  finish(instance, k, weight, decode(instance, k, key, weight), value);
+}
+
+/**
+ * @brief Decodes a batch of keys into portfolios and computes their objective
+ * values.
+ *
+ * @param instance The instance.
+ * @param keys The num_portfolios x num_assets entries of the keys, row by row.
+ * @param num_portfolios The number of portfolios.
+ * @param weights The num_portfolios x num_assets weights of the portfolios, row
+ * by row, written by the function. It may not alias the keys.
+ * @param values The num_portfolios x 4 objective values, row by row, written by
+ * the function.
+ */
+void evaluate_batch(const Instance& instance, const double* keys,
+                    std::size_t num_portfolios, double* weights,
+                    double* values) {
+  const Kernels& k = kernels();
+  const unsigned n = instance.num_assets;
+
+  for (std::size_t p = 0; p < num_portfolios; p++) {
+    const Linear_Sums sums = decode(instance, k, keys + p * n, weights + p * n);
+    values[4 * p] = sums.expected_return;
+    values[4 * p + 3] = sums.entropy;
+  }
+
+  // A factor model is small enough to stay in cache across portfolios, so
+  // there is no covariance traffic for a tiled product to save.
+  if (instance.covariance_storage == Covariance_Storage::FACTOR) {
+    for (std::size_t p = 0; p < num_portfolios; p++) {
+      values[4 * p + 1] = k.factor(instance, weights + p * n);
+    }
+  } else if (instance.covariance_storage == Covariance_Storage::PACKED) {
+    batch_variances<true>(instance, k.tile_dots, weights, num_portfolios,
+                          values);
+  } else {
+    batch_variances<false>(instance, k.tile_dots, weights, num_portfolios,
+                           values);
+  }
+
+  for (std::size_t p = 0; p < num_portfolios; p++) {
+    set_sharpe_ratio(values + 4 * p);
+  }
+}
+
+}  // namespace mopop
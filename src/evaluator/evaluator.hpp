@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+
+#include "instance/instance.hpp"
+
+namespace mopop {
+/**
+ * @brief The instruction sets the evaluation kernels are compiled for.
+ */
+enum class Instruction_Set {
+  /**
+   * @brief Portable scalar code, the reference every other kernel is checked
+   * against.
+   */
+  SCALAR,
+
+  /**
+   * @brief 256-bit AVX2 vectors with fused multiply-add.
+   */
+  AVX2,
+
+  /**
+   * @brief 512-bit AVX-512F vectors.
+   */
+  AVX512
+};
+
+/**
+ * @brief Returns the widest instruction set the running CPU supports.
+ *
+ * @return The widest supported instruction set.
+ */
+Instruction_Set supported_instruction_set();
+
+/**
+ * @brief Returns the instruction set the evaluation kernels currently run with.
+ *
+ * It is the widest supported one unless set_instruction_set narrowed it.
+ *
+ * @return The active instruction set.
+ */
+Instruction_Set active_instruction_set();
+
+/**
+ * @brief Selects the instruction set the evaluation kernels run with.
+ *
+ * It is clamped to the widest supported one. This is meant for tests and
+ * benchmarks, and must not be called while another thread is evaluating.
+ *
+ * @param instruction_set The requested instruction set.
+ * @return The instruction set actually selected.
+ */
+Instruction_Set set_instruction_set(Instruction_Set instruction_set);
+
+/**
+ * @brief Returns the name of an instruction set.
+ *
+ * @param instruction_set The instruction set.
+ * @return "scalar", "avx2" or "avx512".
+ */
+const char* instruction_set_name(Instruction_Set instruction_set);
+
+/**
+ * @brief Computes the variance of a portfolio with the kernel matching both the
+ * covariance storage of the instance and the active instruction set.
+ *
+ * @param instance The instance.
+ * @param weight The num_assets weights of the portfolio.
+ * @return The variance of the portfolio.
+ */
+double evaluate_variance(const Instance& instance, const double* weight);
+
+/**
+ * @brief Computes the four objective values of a portfolio given by its
+ * weights, which are taken as they are.
+ *
+ * The weights are swept once to accumulate the expected return and the
+ * entropy, and the covariance matrix is swept once for the variance:
+ * - value[0] is the weighted sum of the expected returns of the assets.
+ * - value[1] is the variance of the portfolio.
+ * - value[2] is the ratio of value[0] to the square root of value[1], or 0.0
+ * when value[1] is not strictly positive.
+ * - value[3] is the entropy of the weights.
+ *
+ * @param instance The instance.
+ * @param weight The num_assets weights of the portfolio.
+ * @param value The 4 objective values, written by the function.
+ */
+void evaluate_weights(const Instance& instance, const double* weight,
+                      double* value);
+
+/**
+ * @brief Decodes a key into a portfolio and computes its four objective values.
+ *
+ * The weights are the entries of the key divided by their sum, and the
+ * normalization is fused into the sweep that accumulates the expected return
+ * and the entropy. A degenerate key whose entries sum to zero or less carries
+ * no information and is decoded as the uniform portfolio, so that every
+ * portfolio is valid and its weights sum to 1. The objective values are those
+ * of evaluate_weights.
+ *
+ * @param instance The instance.
+ * @param key The num_assets entries of the key.
+ * @param weight The num_assets weights of the portfolio, written by the
+ * function. It may not alias the key.
+ * @param value The 4 objective values, written by the function.
+ */
+void evaluate(const Instance& instance, const double* key, double* weight,
+              double* value);
+
+/**
+ * @brief The number of portfolios of a batch that share each load of a
+ * covariance entry. A batch split at multiples of it evaluates to the same
+ * values as the whole batch.
+ */
+constexpr unsigned batch_tile_size = 4;
+
+/**
+ * @brief Decodes a batch of keys into portfolios and computes their objective
+ * values.
+ *
+ * Each key is decoded and swept as in evaluate, but the variances of the whole
+ * batch are computed together: the portfolios are taken a few at a time, the
+ * product of their weights and the covariance matrix is built in cache-sized
+ * blocks of columns, so that every covariance entry is read once per tile
+ * instead of once per portfolio, and each variance is the dot product of the
+ * weights with the matching row of that product. A factor model already fits
+ * in cache, so its portfolios are evaluated one by one. The values agree with
+ * evaluate up to rounding.
+ *
+ * @param instance The instance.
+ * @param keys The num_portfolios x num_assets entries of the keys, row by row.
+ * @param num_portfolios The number of portfolios.
+ * @param weights The num_portfolios x num_assets weights of the portfolios, row
+ * by row, written by the function. It may not alias the keys.
+ * @param values The num_portfolios x 4 objective values, row by row, written by
+ * the function.
+ */
+void evaluate_batch(const Instance& instance, const double* keys,
+                    std::size_t num_portfolios, double* weights,
+                    double* values);
+
+}  // namespace mopop
@@ -0,0 +1,239 @@
+#include "evaluator/incremental_evaluator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "evaluator/evaluator.hpp"
+#include "evaluator/quadratic_form.hpp"
+
+namespace mopop {
+
+/**
+ * @brief Constructs a new evaluator.
+ *
+ * @param instance The instance.
+ */
+Incremental_Evaluator::Incremental_Evaluator(const Instance& instance)
+    : instance(instance),
+      key(instance.num_assets, 0.0),
+      weight(instance.num_assets, 0.0),
+      product(instance.num_assets, 0.0),
+      exposure(instance.num_factors, 0.0) {}
+
+/**
+ * @brief Computes the four objective values of a key, the same as evaluate up
+ * to rounding.
+ *
+ * The key is compared with the last one. An unchanged key gets the values of
+ * the last one back. When at most num_assets / max_changes_ratio entries
+ * changed, the cached sums and product are updated for each of them, after
+ * being rebuilt if max_num_updates updates went by. If the last key was
+ * evaluated from scratch, they are built at the new key instead, at the cost of
+ * one more evaluation from scratch. Otherwise the key is evaluated from scratch
+ * and becomes the new reference. A degenerate key whose entries sum to zero or
+ * less is always evaluated from scratch, as the uniform portfolio.
+ *
+ * @param key The num_assets entries of the key.
+ * @param value The 4 objective values, written by the function.
+ */
+void Incremental_Evaluator::evaluate(const double* key, double* value) {
+  const unsigned n = this->instance.num_assets;
+  const unsigned max_num_changes = n / Incremental_Evaluator::max_changes_ratio;
+  unsigned num_changes = 0;
+
+  if (this->has_key) {
+    for (unsigned i = 0; i < n && num_changes <= max_num_changes; i++) {
+      if (key[i] != this->key[i]) {
+        num_changes++;
+      }
+    }
+  }
+
+  if (!this->has_key || num_changes > max_num_changes) {
+    std::copy(key, key + n, this->key.begin());
+    this->has_key = true;
+    this->has_product = false;
+    this->num_full_evaluations++;
+    mopop::evaluate(this->instance, key, this->weight.data(), value);
+    std::copy(value, value + 4, this->key_value);
+    return;
+  }
+
+  this->num_incremental_evaluations++;
+
+  if (num_changes == 0) {
+    std::copy(this->key_value, this->key_value + 4, value);
+    return;
+  }
+
+  if (!this->has_product) {
+    std::copy(key, key + n, this->key.begin());
+    this->rebuild();
+  } else {
+    if (this->num_updates >= Incremental_Evaluator::max_num_updates) {
+      this->rebuild();
+    }
+
+    for (unsigned i = 0; i < n; i++) {
+      if (key[i] != this->key[i]) {
+        this->update(i, key[i]);
+      }
+    }
+  }
+
+  if (this->key_sum <= 0.0) {
+    mopop::evaluate(this->instance, key, this->weight.data(), value);
+    std::copy(value, value + 4, this->key_value);
+    return;
+  }
+
+  value[0] = this->key_return / this->key_sum;
+  value[1] = this->key_quadratic_form / (this->key_sum * this->key_sum);
+
+  if (value[1] > 0.0) {
+    value[2] = value[0] / std::sqrt(value[1]);
+  } else {
+    value[2] = 0.0;
+  }
+
+  // The entropy is never negative, but the cancellation between the two terms
+  // can leave a rounding error of either sign around a single-asset portfolio.
+  value[3] = std::max(
+      0.0, std::log2(this->key_sum) - this->key_log_sum / this->key_sum);
+  std::copy(value, value + 4, this->key_value);
+}
+
+/**
+ * @brief Rebuilds the cached sums and product of the last key.
+ */
+void Incremental_Evaluator::rebuild() {
+  const unsigned n = this->instance.num_assets;
+
+  this->key_sum = 0.0;
+  this->key_return = 0.0;
+  this->key_log_sum = 0.0;
+  this->key_quadratic_form = 0.0;
+
+  if (this->instance.covariance_storage == Covariance_Storage::FACTOR) {
+    const double* idiosyncratic =
+        this->instance.idiosyncratic_variances().data();
+
+    for (unsigned f = 0; f < this->instance.num_factors; f++) {
+      const double* exposures = this->instance.factor_exposures(f).data();
+      this->exposure[f] = 0.0;
+
+      for (unsigned i = 0; i < n; i++) {
+        this->exposure[f] += exposures[i] * this->key[i];
+      }
+
+      this->key_quadratic_form += this->exposure[f] * this->exposure[f];
+    }
+
+    for (unsigned i = 0; i < n; i++) {
+      this->key_quadratic_form +=
+          idiosyncratic[i] * this->key[i] * this->key[i];
+    }
+  } else {
+    covariance_product(this->instance, this->key.data(), this->product.data());
+
+    for (unsigned i = 0; i < n; i++) {
+      this->key_quadratic_form += this->key[i] * this->product[i];
+    }
+  }
+
+  for (unsigned i = 0; i < n; i++) {
+    this->key_sum += this->key[i];
+    this->key_return += this->key[i] * this->instance.expected_returns[i];
+
+    if (this->key[i] > 0.0) {
+      this->key_log_sum += this->key[i] * std::log2(this->key[i]);
+    }
+  }
+
+  this->has_product = true;
+  this->num_updates = 0;
+}
+
+/**
+ * @brief Returns an entry of the product of a factor model covariance matrix
+ * and the last key, from the cached exposures.
+ *
+ * @param j The index of the entry.
+ * @return The j-th entry of the product.
+ */
+double Incremental_Evaluator::factor_product(unsigned j) const {
+  double result = this->instance.idiosyncratic_variances()[j] * this->key[j];
+
+  for (unsigned f = 0; f < this->instance.num_factors; f++) {
+    result += this->instance.factor_exposures(f)[j] * this->exposure[f];
+  }
+
+  return result;
+}
+
+/**
+ * @brief Changes one entry of the last key and updates the cached sums and
+ * product.
+ *
+ * Column j of the covariance matrix is row j of the dense storage. With packed
+ * storage its entries above the diagonal are spread over the rows i < j, and
+ * the ones from the diagonal down are row j. With a factor model only the
+ * exposures change, by the exposures of asset j.
+ *
+ * @param j The index of the entry.
+ * @param entry The new value of the entry.
+ */
+void Incremental_Evaluator::update(unsigned j, double entry) {
+  const unsigned n = this->instance.num_assets;
+  const double delta = entry - this->key[j];
+
+  const double variance = this->instance.covariance(j, j);
+  const bool factor =
+      this->instance.covariance_storage == Covariance_Storage::FACTOR;
+  const double product = factor ? this->factor_product(j) : this->product[j];
+
+  this->key_quadratic_form += delta * (2.0 * product + delta * variance);
+  this->key_sum += delta;
+  this->key_return += delta * this->instance.expected_returns[j];
+
+  if (this->key[j] > 0.0) {
+    this->key_log_sum -= this->key[j] * std::log2(this->key[j]);
+  }
+
+  if (entry > 0.0) {
+    this->key_log_sum += entry * std::log2(entry);
+  }
+
+  if (factor) {
+    for (unsigned f = 0; f < this->instance.num_factors; f++) {
+      this->exposure[f] += delta * this->instance.factor_exposures(f)[j];
+    }
+  } else if (this->instance.covariance_storage == Covariance_Storage::DENSE) {
+    const double* row = this->instance.covariance_row(j).data();
+
+    for (unsigned i = 0; i < n; i++) {
+      this->product[i] += delta * row[i];
+    }
+  } else {
+    const double* data = this->instance.covariance_data.data();
+    std::size_t position = j;
+
+    // Entry (i, j) sits j - i places into row i, and the next row starts
+    // n - i places after the start of row i.
+    for (unsigned i = 0; i < j; i++) {
+      this->product[i] += delta * data[position];
+      position += n - i - 1;
+    }
+
+    const double* row = this->instance.packed_covariance_row(j).data();
+
+    for (unsigned i = j; i < n; i++) {
+      this->product[i] += delta * row[i - j];
+    }
+  }
+
+  this->key[j] = entry;
+  this->num_updates++;
+}
+
+}  // namespace mopop
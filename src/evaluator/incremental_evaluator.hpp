@@ -0,0 +1,159 @@
+#pragma once
+
+#include <vector>
+
+#include "instance/instance.hpp"
+
+namespace mopop {
+/**
+ * @class Incremental_Evaluator
+ * @brief Evaluates a sequence of keys, updating the objective values of the
+ * previous key when only a few of its entries change.
+ *
+ * The weights are the entries of the key divided by their sum s, so with
+ * y = Sigma key and q = key^T Sigma key the variance is q / s^2, the expected
+ * return is r^T key / s and the entropy is log2(s) - sum(key_i log2 key_i) / s.
+ * Changing key_j by d adds 2 d y_j + d^2 Sigma_jj to q and d Sigma_j to y, so k
+ * changed entries cost O(n k) instead of the O(n^2) of a full evaluation, and
+ * the renormalization only rescales the cached sums. Keys that differ in more
+ * entries are evaluated from scratch by evaluate(). With a factor model the
+ * exposures z of the key to the factors are cached instead of y, so that
+ * y_j = z^T B_j + D_jj key_j and each changed entry costs O(num_factors).
+ *
+ * The values of a key depend, up to rounding, on the keys evaluated before it,
+ * so reproducible values need an evaluator per sequence of related keys rather
+ * than one shared by whatever keys come along.
+ */
+class Incremental_Evaluator {
+ public:
+  /**
+   * @brief The number of incremental updates after which y and q are rebuilt
+   * from scratch, which bounds the accumulated rounding errors.
+   */
+  static constexpr unsigned max_num_updates = 256;
+
+  /**
+   * @brief A key is updated incrementally when at most num_assets divided by
+   * this ratio of its entries changed.
+   */
+  static constexpr unsigned max_changes_ratio = 16;
+
+  /**
+   * @brief The instance.
+   */
+  const Instance& instance;
+
+  /**
+   * @brief The last key evaluated.
+   */
+  std::vector<double> key;
+
+  /**
+   * @brief The weights of the last key evaluated from scratch.
+   */
+  std::vector<double> weight;
+
+  /**
+   * @brief The product of the covariance matrix and the last key.
+   */
+  std::vector<double> product;
+
+  /**
+   * @brief The exposures of the last key to the factors, when the covariance
+   * matrix is a factor model.
+   */
+  std::vector<double> exposure;
+
+  /**
+   * @brief The sum of the entries of the last key.
+   */
+  double key_sum = 0.0;
+
+  /**
+   * @brief The weighted sum of the expected returns by the last key.
+   */
+  double key_return = 0.0;
+
+  /**
+   * @brief The sum of key_i log2(key_i) over the positive entries of the last
+   * key.
+   */
+  double key_log_sum = 0.0;
+
+  /**
+   * @brief The quadratic form of the covariance matrix at the last key.
+   */
+  double key_quadratic_form = 0.0;
+
+  /**
+   * @brief The objective values of the last key.
+   */
+  double key_value[4] = {0.0, 0.0, 0.0, 0.0};
+
+  /**
+   * @brief Whether key holds a key.
+   */
+  bool has_key = false;
+
+  /**
+   * @brief Whether the cached sums and product match the last key.
+   */
+  bool has_product = false;
+
+  /**
+   * @brief The number of incremental updates since the product was rebuilt.
+   */
+  unsigned num_updates = 0;
+
+  /**
+   * @brief The number of keys evaluated incrementally.
+   */
+  unsigned long num_incremental_evaluations = 0;
+
+  /**
+   * @brief The number of keys evaluated from scratch.
+   */
+  unsigned long num_full_evaluations = 0;
+
+  /**
+   * @brief Constructs a new evaluator.
+   *
+   * @param instance The instance.
+   */
+  Incremental_Evaluator(const Instance& instance);
+
+  /**
+   * @brief Computes the four objective values of a key, the same as evaluate
+   * up to rounding.
+   *
+   * @param key The num_assets entries of the key.
+   * @param value The 4 objective values, written by the function.
+   */
+  void evaluate(const double* key, double* value);
+
+ private:
+  /**
+   * @brief Rebuilds the cached sums and product of the last key.
+   */
+  void rebuild();
+
+  /**
+   * @brief Returns an entry of the product of a factor model covariance matrix
+   * and the last key, from the cached exposures.
+   *
+   * @param j The index of the entry.
+   * @return The j-th entry of the product.
+   */
+  double factor_product(unsigned j) const;
+
+  /**
+   * @brief Changes one entry of the last key and updates the cached sums and
+   * product.
+   *
+   * @param j The index of the entry.
+   * @param entry The new value of the entry.
+   */
+  void update(unsigned j, double entry);
+};
+
+}  // namespace mopop
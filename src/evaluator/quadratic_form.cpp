@@ -0,0 +1,197 @@
+#include "evaluator/quadratic_form.hpp"
+
+namespace mopop {
+
+/**
+ * @brief Computes the quadratic form of a dense covariance matrix.
+ *
+ * Each row is swept with unit stride up to num_assets, and rows whose weight is
+ * zero are skipped altogether.
+ *
+ * @param instance The instance, whose covariance storage must be DENSE.
+ * @param weight The num_assets weights of the portfolio.
+ * @return The variance of the portfolio, the sum over every pair (i, j) of
+ * weight[i] * weight[j] * covariance(i, j).
+ */
+double dense_quadratic_form(const Instance& instance, const double* weight) {
+  double result = 0.0;
+
+  for (unsigned i = 0; i < instance.num_assets; i++) {
+    if (weight[i] == 0.0) {
+      continue;
+    }
+
+    const double* row = instance.covariance_row(i).data();
+    double row_product = 0.0;
+
+    for (unsigned j = 0; j < instance.num_assets; j++) {
+      row_product += row[j] * weight[j];
+    }
+
+    result += weight[i] * row_product;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Computes the quadratic form of a packed covariance matrix.
+ *
+ * By symmetry, the variance is the sum of covariance(i, i) * weight[i]^2 over
+ * the diagonal plus twice the sum of covariance(i, j) * weight[i] * weight[j]
+ * over the pairs i < j, so only the upper triangle is read, which halves the
+ * memory traffic of each evaluation.
+ *
+ * @param instance The instance, whose covariance storage must be PACKED.
+ * @param weight The num_assets weights of the portfolio.
+ * @return The variance of the portfolio.
+ */
+double packed_quadratic_form(const Instance& instance, const double* weight) {
+  double result = 0.0;
+
+  for (unsigned i = 0; i < instance.num_assets; i++) {
+    if (weight[i] == 0.0) {
+      continue;
+    }
+
+    const double* row = instance.packed_covariance_row(i).data();
+    const double* tail = weight + i;
+    const unsigned length = instance.num_assets - i;
+    double off_diagonal = 0.0;
+
+    for (unsigned j = 1; j < length; j++) {
+      off_diagonal += row[j] * tail[j];
+    }
+
+    result += weight[i] * (row[0] * weight[i] + 2.0 * off_diagonal);
+  }
+
+  return result;
+}
+
+/**
+ * @brief Computes the quadratic form of a factor model covariance matrix.
+ *
+ * The factors are stored uncorrelated with unit variance, so the variance is
+ * the sum of the squared exposures of the portfolio to each factor plus the
+ * sum of idiosyncratic_variances[i] * weight[i]^2, in O(num_assets *
+ * num_factors) operations instead of O(num_assets^2).
+ *
+ * @param instance The instance, whose covariance storage must be FACTOR.
+ * @param weight The num_assets weights of the portfolio.
+ * @return The variance of the portfolio.
+ */
+double factor_quadratic_form(const Instance& instance, const double* weight) {
+  const double* idiosyncratic = instance.idiosyncratic_variances().data();
+  double result = 0.0;
+
+  for (unsigned f = 0; f < instance.num_factors; f++) {
+    const double* exposures = instance.factor_exposures(f).data();
+    double exposure = 0.0;
+
+    for (unsigned i = 0; i < instance.num_assets; i++) {
+      exposure += exposures[i] * weight[i];
+    }
+
+    result += exposure * exposure;
+  }
+
+  for (unsigned i = 0; i < instance.num_assets; i++) {
+    result += idiosyncratic[i] * weight[i] * weight[i];
+  }
+
+  return result;
+}
+
+/**
+ * @brief Computes the quadratic form of the covariance matrix with the kernel
+ * that matches the storage the instance picked at load time.
+ *
+ * @param instance The instance.
+ * @param weight The num_assets weights of the portfolio.
+ * @return The variance of the portfolio.
+ */
+double quadratic_form(const Instance& instance, const double* weight) {
+  if (instance.covariance_storage == Covariance_Storage::FACTOR) {
+    return factor_quadratic_form(instance, weight);
+  }
+
+  if (instance.covariance_storage == Covariance_Storage::PACKED) {
+    return packed_quadratic_form(instance, weight);
+  }
+
+  return dense_quadratic_form(instance, weight);
+}
+
+/**
+ * @brief Computes the product of the covariance matrix and a vector.
+ *
+ * With dense storage each entry is the dot product of a row with the vector.
+ * With packed storage row i holds the columns j >= i, so it contributes its dot
+ * product with the vector to entry i and, by symmetry, covariance(i, j) *
+ * x[i] to every entry j > i. With a factor model the vector is projected on
+ * each factor and the projections are spread back over the assets.
+ *
+ * @param instance The instance.
+ * @param x The num_assets entries of the vector.
+ * @param y The num_assets entries of the product, written by the function.
+ */
+void covariance_product(const Instance& instance, const double* x, double* y) {
+  const unsigned n = instance.num_assets;
+
+  if (instance.covariance_storage == Covariance_Storage::FACTOR) {
+    const double* idiosyncratic = instance.idiosyncratic_variances().data();
+
+    for (unsigned i = 0; i < n; i++) {
+      y[i] = idiosyncratic[i] * x[i];
+    }
+
+    for (unsigned f = 0; f < instance.num_factors; f++) {
+      const double* exposures = instance.factor_exposures(f).data();
+      double exposure = 0.0;
+
+      for (unsigned i = 0; i < n; i++) {
+        exposure += exposures[i] * x[i];
+      }
+
+      for (unsigned i = 0; i < n; i++) {
+        y[i] += exposure * exposures[i];
+      }
+    }
+
+    return;
+  }
+
+  if (instance.covariance_storage == Covariance_Storage::DENSE) {
+    for (unsigned i = 0; i < n; i++) {
+      const double* row = instance.covariance_row(i).data();
+      double row_product = 0.0;
+
+      for (unsigned j = 0; j < n; j++) {
+        row_product += row[j] * x[j];
+      }
+
+      y[i] = row_product;
+    }
+
+    return;
+  }
+
+  for (unsigned i = 0; i < n; i++) {
+    y[i] = 0.0;
+  }
+
+  for (unsigned i = 0; i < n; i++) {
+    const double* row = instance.packed_covariance_row(i).data();
+    double row_product = row[0] * x[i];
+
+    for (unsigned j = i + 1; j < n; j++) {
+      row_product += row[j - i] * x[j];
+      y[j] += row[j - i] * x[i];
+    }
+
+    y[i] += row_product;
+  }
+}
+
+}  // namespace mopop
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "instance/instance.hpp"
+
+namespace mopop {
+/**
+ * @brief Computes the quadratic form of a dense covariance matrix.
+ *
+ * Each row is swept with unit stride up to num_assets, and rows whose weight is
+ * zero are skipped altogether.
+ *
+ * @param instance The instance, whose covariance storage must be DENSE.
+ * @param weight The num_assets weights of the portfolio.
+ * @return The variance of the portfolio, the sum over every pair (i, j) of
+ * weight[i] * weight[j] * covariance(i, j).
+ */
+double dense_quadratic_form(const Instance& instance, const double* weight);
+
+/**
+ * @brief Computes the quadratic form of a packed covariance matrix.
+ *
+ * By symmetry, the variance is the sum of covariance(i, i) * weight[i]^2 over
+ * the diagonal plus twice the sum of covariance(i, j) * weight[i] * weight[j]
+ * over the pairs i < j, so only the upper triangle is read, which halves the
+ * memory traffic of each evaluation.
+ *
+ * @param instance The instance, whose covariance storage must be PACKED.
+ * @param weight The num_assets weights of the portfolio.
+ * @return The variance of the portfolio.
+ */
+double packed_quadratic_form(const Instance& instance, const double* weight);
+
+/**
+ * @brief Computes the quadratic form of a factor model covariance matrix.
+ *
+ * The factors are stored uncorrelated with unit variance, so the variance is
+ * the sum of the squared exposures of the portfolio to each factor plus the
+ * sum of idiosyncratic_variances[i] * weight[i]^2, in O(num_assets *
+ * num_factors) operations instead of O(num_assets^2).
+ *
+ * @param instance The instance, whose covariance storage must be FACTOR.
+ * @param weight The num_assets weights of the portfolio.
+ * @return The variance of the portfolio.
+ */
+double factor_quadratic_form(const Instance& instance, const double* weight);
+
+/**
+ * @brief Computes the quadratic form of the covariance matrix with the kernel
+ * that matches the storage the instance picked at load time.
+ *
+ * @param instance The instance.
+ * @param weight The num_assets weights of the portfolio.
+ * @return The variance of the portfolio.
+ */
+double quadratic_form(const Instance& instance, const double* weight);
+
+/**
+ * @brief Computes the product of the covariance matrix and a vector.
+ *
+ * With dense storage each entry is the dot product of a row with the vector.
+ * With packed storage row i holds the columns j >= i, so it contributes its dot
+ * product with the vector to entry i and, by symmetry, covariance(i, j) *
+ * x[i] to every entry j > i. With a factor model the vector is projected on
+ * each factor and the projections are spread back over the assets.
+ *
+ * @param instance The instance.
+ * @param x The num_assets entries of the vector.
+ * @param y The num_assets entries of the product, written by the function.
+ */
+void covariance_product(const Instance& instance, const double* x, double* y);
+
+}  // namespace mopop
@@ -0,0 +1,245 @@
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "evaluator/evaluator.hpp"
+#include "instance/instance.hpp"
+#include "utils/argument_parser.hpp"
+
+/**
+ * @brief Builds a synthetic instance whose covariance matrix is a factor model
+ * with uncorrelated factors, which makes it symmetric positive definite.
+ *
+ * @param num_assets The number of assets.
+ * @param rng The pseudo-random number generator.
+ * @return The synthetic instance.
+ */
+static mopop::Instance synthetic_instance(unsigned num_assets,
+                                          std::mt19937& rng) {
+  const unsigned num_factors = 8;
+  std::normal_distribution<double> normal(0.0, 0.01);
+  std::vector<std::string> tickers(num_assets);
+  std::vector<double> expected_returns(num_assets);
+  std::vector<std::vector<double>> loadings(
+      num_assets, std::vector<double>(num_factors));
+  std::vector<std::vector<double>> factor_covariance(
+      num_factors, std::vector<double>(num_factors, 0.0));
+  const std::vector<double> idiosyncratic_variances(num_assets, 1e-4);
+
+  for (unsigned k = 0; k < num_factors; k++) {
+    factor_covariance[k][k] = 1.0;
+  }
+
+  for (unsigned i = 0; i < num_assets; i++) {
+    tickers[i] = "A" + std::to_string(i);
+    expected_returns[i] = normal(rng) * 0.1;
+
+    for (unsigned k = 0; k < num_factors; k++) {
+      loadings[i][k] = normal(rng);
+    }
+  }
+
+  return mopop::Instance(tickers, expected_returns, loadings,
+                         factor_covariance, idiosyncratic_variances);
+}
+
+/**
+ * @brief Returns the name of a covariance storage.
+ *
+ * @param storage The covariance storage.
+ * @return "dense", "packed" or "factor".
+ */
+static std::string storage_name(mopop::Covariance_Storage storage) {
+  switch (storage) {
+    case mopop::Covariance_Storage::PACKED: {
+      return "packed";
+    }
+
+    case mopop::Covariance_Storage::FACTOR: {
+      return "factor";
+    }
+
+    default: {
+      return "dense";
+    }
+  }
+}
+
+/**
+ * @brief Times a variance kernel over a set of portfolios.
+ *
+ * @param name The name of the kernel.
+ * @param footprint The number of bytes of covariance data the kernel reads.
+ * @param num_portfolios The number of portfolios, evaluated round-robin.
+ * @param num_evaluations The number of evaluations to time.
+ * @param kernel The kernel, called with the index of the portfolio.
+ * @return The checksum of the computed variances.
+ */
+static double benchmark(
+    const std::string& name, std::size_t footprint, std::size_t num_portfolios,
+    unsigned num_evaluations,
+    const std::function<double(std::size_t)>& kernel) {
+  double checksum = 0.0;
+  const auto start_time = std::chrono::steady_clock::now();
+
+  for (unsigned i = 0; i < num_evaluations; i++) {
+    checksum += kernel(i % num_portfolios);
+  }
+
+  const double elapsed_time =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                    start_time)
+          .count();
+
+  std::cout << std::left << std::setw(24) << name << std::right
+            << std::setw(14) << std::fixed << std::setprecision(1)
+            << num_evaluations / elapsed_time << " eval/s" << std::setw(12)
+            << std::setprecision(3) << 1e6 * elapsed_time / num_evaluations
+            << " us/eval" << std::setw(12) << footprint / 1024
+            << " KiB  checksum " << std::scientific << std::setprecision(12)
+            << checksum << std::defaultfloat << std::endl;
+
+  return checksum;
+}
+
+int main(int argc, char* argv[]) {
+  Argument_Parser arg_parser(argc, argv);
+
+  if ((arg_parser.option_exists("--expected-returns-filename") &&
+       arg_parser.option_exists("--covariance-filename")) ||
+      arg_parser.option_exists("--instance-filename") ||
+      arg_parser.option_exists("--num-assets")) {
+    unsigned seed = 305089489, num_evaluations = 1000, num_portfolios = 64;
+
+    if (arg_parser.option_exists("--seed")) {
+      seed = std::stoul(arg_parser.option_value("--seed"));
+    }
+
+    if (arg_parser.option_exists("--num-evaluations")) {
+      num_evaluations =
+          std::stoul(arg_parser.option_value("--num-evaluations"));
+    }
+
+    std::mt19937 rng(seed);
+    mopop::Instance instance =
+        arg_parser.option_exists("--num-assets")
+            ? synthetic_instance(
+                  std::stoul(arg_parser.option_value("--num-assets")), rng)
+        : arg_parser.option_exists("--instance-filename")
+            ? mopop::Instance(arg_parser.option_value("--instance-filename"))
+            : mopop::Instance(
+                  arg_parser.option_value("--expected-returns-filename"),
+                  arg_parser.option_value("--covariance-filename"));
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<std::vector<double>> weights(
+        num_portfolios, std::vector<double>(instance.num_assets));
+
+    for (std::vector<double>& weight : weights) {
+      double total_weight = 0.0;
+
+      for (double& w : weight) {
+        w = uniform(rng);
+        total_weight += w;
+      }
+
+      for (double& w : weight) {
+        w /= total_weight;
+      }
+    }
+
+    std::vector<double> keys;
+
+    for (const std::vector<double>& weight : weights) {
+      keys.insert(keys.end(), weight.begin(), weight.end());
+    }
+
+    std::vector<double> batch_weights(keys.size()),
+        batch_values(4 * num_portfolios);
+    mopop::Instance dense(instance), packed(instance);
+
+    dense.set_covariance_storage(mopop::Covariance_Storage::DENSE);
+    packed.set_covariance_storage(mopop::Covariance_Storage::PACKED);
+
+    // A factor model can be expanded into a matrix but not the other way
+    // around, so it is only timed when the instance is one.
+    std::vector<const mopop::Instance*> storages = {&dense, &packed};
+
+    if (instance.covariance_storage == mopop::Covariance_Storage::FACTOR) {
+      storages.push_back(&instance);
+    }
+
+    std::cout << "Number of assets: " << instance.num_assets << std::endl
+              << "Number of evaluations: " << num_evaluations << std::endl
+              << "Storage picked at load time: "
+              << storage_name(instance.covariance_storage) << std::endl;
+
+    const mopop::Instruction_Set supported = mopop::supported_instruction_set();
+    double reference_checksum = 0.0;
+
+    std::cout << "Widest supported instruction set: "
+              << mopop::instruction_set_name(supported) << std::endl;
+
+    for (mopop::Instruction_Set instruction_set :
+         {mopop::Instruction_Set::SCALAR, mopop::Instruction_Set::AVX2,
+          mopop::Instruction_Set::AVX512}) {
+      if (mopop::set_instruction_set(instruction_set) != instruction_set) {
+        continue;
+      }
+
+      const std::string name = mopop::instruction_set_name(instruction_set);
+
+      for (const mopop::Instance* storage : storages) {
+        const std::string prefix =
+            storage_name(storage->covariance_storage) + "/";
+        const std::size_t footprint =
+            storage->covariance_data.size() * sizeof(double);
+        std::vector<double> checksums;
+
+        checksums.push_back(benchmark(
+            prefix + name, footprint, num_portfolios, num_evaluations,
+            [&](std::size_t p) {
+              return mopop::evaluate_variance(*storage, weights[p].data());
+            }));
+
+        // The batch kernel evaluates every portfolio at the first index and
+        // then hands out the stored variances.
+        checksums.push_back(benchmark(
+            prefix + "batch/" + name, footprint, num_portfolios,
+            num_evaluations, [&](std::size_t p) {
+              if (p == 0) {
+                mopop::evaluate_batch(*storage, keys.data(), num_portfolios,
+                                      batch_weights.data(),
+                                      batch_values.data());
+              }
+
+              return batch_values[4 * p + 1];
+            }));
+
+        for (double checksum : checksums) {
+          if (reference_checksum == 0.0) {
+            reference_checksum = checksum;
+          } else {
+            std::cout << "  relative difference to dense/scalar: "
+                      << std::fabs(checksum - reference_checksum) /
+                             std::fabs(reference_checksum)
+                      << std::endl;
+          }
+        }
+      }
+    }
+
+    mopop::set_instruction_set(supported);
+  } else {
+    std::cerr << "./covariance_benchmark_exec "
+              << "--expected-returns-filename <expected_returns_filename> "
+              << "--covariance-filename <covariance_filename> "
+              << "| --instance-filename <instance_filename> "
+              << "| --num-assets <num_assets> "
+              << "--num-evaluations <num_evaluations> "
+              << "--seed <seed> " << std::endl;
+  }
+
+  return 0;
+}
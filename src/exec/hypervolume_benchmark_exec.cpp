@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <pagmo/utils/hypervolume.hpp>
+#include <random>
+
+#include "instance/instance.hpp"
+#include "metrics/hypervolume.hpp"
+#include "metrics/incremental_hypervolume.hpp"
+#include "utils/argument_parser.hpp"
+#include "utils/snapshot_file.hpp"
+#include "utils/text_reader.hpp"
+
+/**
+ * @brief Computes the hypervolume of a front with pagmo, negating the
+ * maximization objectives of both the front and the reference point.
+ *
+ * @param senses A vector indicating whether each objective is minimized or
+ * maximized.
+ * @param reference_point The reference point.
+ * @param front The front.
+ * @return The hypervolume of the front, or zero if the front is empty.
+ */
+static double pagmo_hypervolume(const std::vector<NSBRKGA::Sense>& senses,
+                                const std::vector<double>& reference_point,
+                                const std::vector<std::vector<double>>& front) {
+  if (front.empty()) {
+    return 0.0;
+  }
+
+  std::vector<double> reference_point_prime(reference_point.size());
+  std::vector<std::vector<double>> front_prime(front.size());
+
+  for (unsigned i = 0; i < reference_point.size(); i++) {
+    if (senses[i] == NSBRKGA::Sense::MINIMIZE) {
+      reference_point_prime[i] = reference_point[i];
+    } else {
+      reference_point_prime[i] = -reference_point[i];
+    }
+  }
+
+  for (unsigned i = 0; i < front.size(); i++) {
+    front_prime[i] = std::vector<double>(front[i].size());
+    for (unsigned j = 0; j < front[i].size(); j++) {
+      if (senses[j] == NSBRKGA::Sense::MINIMIZE) {
+        front_prime[i][j] = front[i][j];
+      } else {
+        front_prime[i][j] = -front[i][j];
+      }
+    }
+  }
+
+  pagmo::hypervolume hv(front_prime);
+  return hv.compute(reference_point_prime);
+}
+
+/**
+ * @brief Builds a synthetic front of mutually non-dominated points on the
+ * unit sphere, together with a reference point just beyond it.
+ *
+ * @param senses A vector indicating whether each objective is minimized or
+ * maximized.
+ * @param num_points The number of points.
+ * @param rng The pseudo-random number generator.
+ * @param reference_point The reference point, written by the function.
+ * @return The synthetic front.
+ */
+static std::vector<std::vector<double>> synthetic_front(
+    const std::vector<NSBRKGA::Sense>& senses, unsigned num_points,
+    std::mt19937& rng, std::vector<double>& reference_point) {
+  std::normal_distribution<double> normal(0.0, 1.0);
+  std::vector<std::vector<double>> front(num_points,
+                                         std::vector<double>(senses.size()));
+
+  for (std::vector<double>& value : front) {
+    double norm = 0.0;
+
+    for (double& v : value) {
+      v = std::fabs(normal(rng));
+      norm += v * v;
+    }
+
+    // Points on the sphere around the ideal point are mutually non-dominated.
+    for (unsigned i = 0; i < senses.size(); i++) {
+      value[i] = 1.0 - value[i] / std::sqrt(norm);
+
+      if (senses[i] == NSBRKGA::Sense::MAXIMIZE) {
+        value[i] = -value[i];
+      }
+    }
+  }
+
+  reference_point.assign(senses.size(), 1.1);
+
+  for (unsigned i = 0; i < senses.size(); i++) {
+    if (senses[i] == NSBRKGA::Sense::MAXIMIZE) {
+      reference_point[i] = -reference_point[i];
+    }
+  }
+
+  return front;
+}
+
+/**
+ * @brief Builds a sequence of snapshots from a front, each one a window of a
+ * shuffled copy of the front that slides by about 1% of the points, so that
+ * consecutive snapshots differ in a few points as those of a run do.
+ *
+ * @param front The front.
+ * @param num_snapshots The number of snapshots.
+ * @param rng The pseudo-random number generator.
+ * @return The snapshots.
+ */
+static std::vector<std::vector<std::vector<double>>> sliding_snapshots(
+    std::vector<std::vector<double>> front, unsigned num_snapshots,
+    std::mt19937& rng) {
+  const std::size_t step = std::max<std::size_t>(1, front.size() / 100);
+  std::vector<std::vector<std::vector<double>>> snapshots;
+
+  std::shuffle(front.begin(), front.end(), rng);
+
+  if (front.size() <= step * num_snapshots) {
+    return snapshots;
+  }
+
+  const std::size_t window = front.size() - step * num_snapshots;
+
+  for (unsigned j = 0; j < num_snapshots; j++) {
+    snapshots.emplace_back(front.begin() + j * step,
+                           front.begin() + j * step + window);
+  }
+
+  return snapshots;
+}
+
+/**
+ * @brief Times a hypervolume computation.
+ *
+ * @param name The name of the implementation.
+ * @param num_repetitions The number of times the hypervolume is computed.
+ * @param compute The computation.
+ * @return The hypervolume.
+ */
+static double benchmark(const std::string& name, unsigned num_repetitions,
+                        const std::function<double()>& compute) {
+  double hypervolume = 0.0;
+  const auto start_time = std::chrono::steady_clock::now();
+
+  for (unsigned i = 0; i < num_repetitions; i++) {
+    hypervolume = compute();
+  }
+
+  const double elapsed_time =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                    start_time)
+          .count();
+
+  std::cout << "  " << std::left << std::setw(10) << name << std::right
+            << std::setw(14) << std::fixed << std::setprecision(3)
+            << 1e3 * elapsed_time / num_repetitions << " ms"
+            << "  hypervolume " << std::scientific << std::setprecision(12)
+            << hypervolume << std::defaultfloat << std::endl;
+
+  return hypervolume;
+}
+
+int main(int argc, char* argv[]) {
+  Argument_Parser arg_parser(argc, argv);
+
+  if ((arg_parser.option_exists("--instance-filename") ||
+       (arg_parser.option_exists("--expected-returns-filename") &&
+        arg_parser.option_exists("--covariance-filename"))) &&
+      ((arg_parser.option_exists("--reference-point") &&
+        arg_parser.option_exists("--pareto-0")) ||
+       arg_parser.option_exists("--num-points"))) {
+    mopop::Instance instance =
+        arg_parser.option_exists("--instance-filename")
+            ? mopop::Instance(arg_parser.option_value("--instance-filename"))
+            : mopop::Instance(
+                  arg_parser.option_value("--expected-returns-filename"),
+                  arg_parser.option_value("--covariance-filename"));
+    mopop::Text_Reader reader;
+    unsigned num_objectives = instance.senses.size(), seed = 305089489,
+             num_repetitions = 10;
+    std::vector<double> reference_point(num_objectives, 0.0);
+    std::vector<std::vector<std::vector<double>>> paretos;
+
+    if (arg_parser.option_exists("--seed")) {
+      seed = std::stoul(arg_parser.option_value("--seed"));
+    }
+
+    if (arg_parser.option_exists("--num-repetitions")) {
+      num_repetitions =
+          std::stoul(arg_parser.option_value("--num-repetitions"));
+    }
+
+    if (arg_parser.option_exists("--num-points")) {
+      std::mt19937 rng(seed);
+
+      paretos.push_back(synthetic_front(
+          instance.senses, std::stoul(arg_parser.option_value("--num-points")),
+          rng, reference_point));
+    } else {
+      if (reader.open(arg_parser.option_value("--reference-point"))) {
+        while (reader.next_line()) {
+          for (unsigned j = 0; j < num_objectives; j++) {
+            reader.next_number(reference_point[j]);
+          }
+        }
+
+        reader.close();
+      } else {
+        throw std::runtime_error("File " +
+                                 arg_parser.option_value("--reference-point") +
+                                 " not found.");
+      }
+
+      for (unsigned i = 0;
+           arg_parser.option_exists("--pareto-" + std::to_string(i)); i++) {
+        paretos.push_back(mopop::read_front(
+            arg_parser.option_value("--pareto-" + std::to_string(i)),
+            num_objectives));
+      }
+    }
+
+    const mopop::Hypervolume engine(instance.senses, reference_point);
+    std::mt19937 rng(seed);
+
+    std::cout << "Number of repetitions: " << num_repetitions << std::endl;
+
+    for (unsigned i = 0; i < paretos.size(); i++) {
+      const std::vector<std::vector<double>>& front = paretos[i];
+
+      std::cout << "Front " << i << ": " << front.size() << " points"
+                << std::endl;
+
+      double hypervolume = benchmark("mopop", num_repetitions,
+                                     [&]() { return engine.compute(front); });
+      double expected = benchmark("pagmo", num_repetitions, [&]() {
+        return pagmo_hypervolume(instance.senses, reference_point, front);
+      });
+
+      std::cout << "  relative difference: "
+                << std::fabs(hypervolume - expected) /
+                       std::max(std::fabs(expected),
+                                std::numeric_limits<double>::min())
+                << std::endl;
+
+      const std::vector<std::vector<std::vector<double>>> snapshots =
+          sliding_snapshots(front, 30, rng);
+
+      if (snapshots.empty()) {
+        continue;
+      }
+
+      std::cout << "Snapshots of front " << i << ": " << snapshots.size()
+                << " of " << snapshots.front().size() << " points" << std::endl;
+
+      double total = benchmark("full", num_repetitions, [&]() {
+        double sum = 0.0;
+
+        for (const std::vector<std::vector<double>>& snapshot : snapshots) {
+          sum += engine.compute(snapshot);
+        }
+
+        return sum;
+      });
+      double incremental_total = benchmark("tracker", num_repetitions, [&]() {
+        mopop::Incremental_Hypervolume tracker(instance.senses,
+                                               reference_point);
+        double sum = 0.0;
+
+        for (const std::vector<std::vector<double>>& snapshot : snapshots) {
+          sum += tracker.update(snapshot);
+        }
+
+        return sum;
+      });
+
+      std::cout << "  relative difference: "
+                << std::fabs(incremental_total - total) /
+                       std::max(std::fabs(total),
+                                std::numeric_limits<double>::min())
+                << std::endl;
+    }
+  } else {
+    std::cerr << "./hypervolume_benchmark_exec "
+              << "--expected-returns-filename <expected_returns_filename> "
+              << "--covariance-filename <covariance_filename> "
+              << "| --instance-filename <instance_filename> "
+              << "--reference-point <reference_point_filename> "
+              << "--pareto-i <pareto_filename> "
+              << "| --num-points <num_points> "
+              << "--num-repetitions <num_repetitions> "
+              << "--seed <seed> " << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,37 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "instance/instance.hpp"
+#include "utils/argument_parser.hpp"
+
+int main(int argc, char* argv[]) {
+  Argument_Parser arg_parser(argc, argv);
+
+  if (arg_parser.option_exists("--expected-returns-filename") &&
+      arg_parser.option_exists("--covariance-filename") &&
+      arg_parser.option_exists("--instance-filename")) {
+    mopop::Instance instance(
+        arg_parser.option_value("--expected-returns-filename"),
+        arg_parser.option_value("--covariance-filename"));
+
+    instance.write_binary_file(arg_parser.option_value("--instance-filename"));
+
+    // Map the file back, which verifies its checksum and layout.
+    const mopop::Instance mapped(
+        arg_parser.option_value("--instance-filename"));
+
+    if (mapped.num_assets != instance.num_assets ||
+        mapped.covariance_data != instance.covariance_data) {
+      throw std::runtime_error(
+          "File " + arg_parser.option_value("--instance-filename") +
+          " does not hold the instance.");
+    }
+  } else {
+    std::cerr << "./instance_converter_exec "
+              << "--expected-returns-filename <expected_returns_filename> "
+              << "--covariance-filename <covariance_filename> "
+              << "--instance-filename <instance_filename> " << std::endl;
+  }
+
+  return 0;
+}
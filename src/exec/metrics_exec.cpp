@@ -0,0 +1,380 @@
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <utility>
+
+#include "instance/instance.hpp"
+#include "metrics/hypervolume_ratio.hpp"
+#include "metrics/incremental_hypervolume.hpp"
+#include "metrics/normalized_igd_plus.hpp"
+#include "metrics/objective_bounds.hpp"
+#include "metrics/reference_front.hpp"
+#include "utils/argument_parser.hpp"
+#include "utils/parallel_for.hpp"
+#include "utils/snapshot_file.hpp"
+
+/**
+ * @brief The fronts of a solver run.
+ */
+struct Run {
+  /**
+   * @brief The final front.
+   */
+  std::vector<std::vector<double>> pareto;
+
+  /**
+   * @brief The iteration of each snapshot.
+   */
+  std::vector<unsigned> iteration_snapshots;
+
+  /**
+   * @brief The time of each snapshot.
+   */
+  std::vector<double> time_snapshots;
+
+  /**
+   * @brief The front of each snapshot.
+   */
+  std::vector<std::vector<std::vector<double>>> best_solutions_snapshots;
+};
+
+/**
+ * @brief Loads the final front and the snapshots of a solver run.
+ *
+ * @param arg_parser The argument parser.
+ * @param i The index of the run.
+ * @param num_objectives The number of objectives.
+ * @return The run.
+ *
+ * @throws std::runtime_error If a front cannot be read.
+ */
+static Run load_run(const Argument_Parser& arg_parser, unsigned i,
+                    unsigned num_objectives) {
+  Run run;
+
+  if (arg_parser.option_exists("--pareto-" + std::to_string(i))) {
+    run.pareto = mopop::read_front(
+        arg_parser.option_value("--pareto-" + std::to_string(i)),
+        num_objectives);
+  }
+
+  if (arg_parser.option_exists("--best-solutions-snapshots-" +
+                               std::to_string(i))) {
+    mopop::Front_Snapshots snapshots = mopop::read_front_snapshots(
+        arg_parser.option_value("--best-solutions-snapshots-" +
+                                std::to_string(i)),
+        num_objectives);
+
+    run.iteration_snapshots = std::move(snapshots.iterations);
+    run.time_snapshots = std::move(snapshots.times);
+    run.best_solutions_snapshots = std::move(snapshots.fronts);
+  }
+
+  return run;
+}
+
+/**
+ * @brief Writes a value to a file, on a line of its own.
+ *
+ * @param filename The name of the file.
+ * @param value The value.
+ *
+ * @throws std::runtime_error If the file cannot be created or written.
+ */
+static void write_value(const std::string& filename, double value) {
+  std::ofstream ofs;
+
+  ofs.open(filename);
+
+  if (ofs.is_open()) {
+    ofs << value << std::endl;
+
+    if (ofs.eof() || ofs.fail() || ofs.bad()) {
+      throw std::runtime_error("Error writing file " + filename + ".");
+    }
+
+    ofs.close();
+  } else {
+    throw std::runtime_error("File " + filename + " not created.");
+  }
+}
+
+/**
+ * @brief Writes the value of each snapshot of a run to a file, one
+ * "iteration,time,value" line per snapshot.
+ *
+ * @param filename The name of the file.
+ * @param run The run.
+ * @param values The value of each snapshot.
+ *
+ * @throws std::runtime_error If the file cannot be created or written.
+ */
+static void write_snapshots(const std::string& filename, const Run& run,
+                            const std::vector<double>& values) {
+  std::ofstream ofs;
+
+  ofs.open(filename);
+
+  if (ofs.is_open()) {
+    for (unsigned j = 0; j < values.size(); j++) {
+      ofs << run.iteration_snapshots[j] << "," << run.time_snapshots[j] << ","
+          << values[j] << std::endl;
+
+      if (ofs.eof() || ofs.fail() || ofs.bad()) {
+        throw std::runtime_error("Error writing file " + filename + ".");
+      }
+    }
+
+    ofs.close();
+  } else {
+    throw std::runtime_error("File " + filename + " not created.");
+  }
+}
+
+/**
+ * @brief Writes points to a file, one point per line.
+ *
+ * @param filename The name of the file.
+ * @param front The points.
+ *
+ * @throws std::runtime_error If the file cannot be created or written.
+ */
+static void write_front(const std::string& filename,
+                        const std::vector<std::vector<double>>& front) {
+  std::ofstream ofs;
+
+  ofs.open(filename);
+
+  if (ofs.is_open()) {
+    for (const std::vector<double>& value : front) {
+      for (unsigned i = 0; i < value.size() - 1; i++) {
+        ofs << value[i] << " ";
+      }
+
+      ofs << value.back() << std::endl;
+
+      if (ofs.eof() || ofs.fail() || ofs.bad()) {
+        throw std::runtime_error("Error writing file " + filename + ".");
+      }
+    }
+
+    ofs.close();
+  } else {
+    throw std::runtime_error("File " + filename + " not created.");
+  }
+}
+
+int main(int argc, char* argv[]) {
+  Argument_Parser arg_parser(argc, argv);
+
+  if (arg_parser.option_exists("--instance-filename") ||
+      (arg_parser.option_exists("--expected-returns-filename") &&
+       arg_parser.option_exists("--covariance-filename"))) {
+    mopop::Instance instance =
+        arg_parser.option_exists("--instance-filename")
+            ? mopop::Instance(arg_parser.option_value("--instance-filename"))
+            : mopop::Instance(
+                  arg_parser.option_value("--expected-returns-filename"),
+                  arg_parser.option_value("--covariance-filename"));
+    const std::vector<std::string> final_options = {"--hypervolume-", "--hvr-",
+                                                    "--nigd-plus-"};
+    const std::vector<std::string> snapshots_options = {
+        "--hypervolume-snapshots-", "--hvr-snapshots-",
+        "--nigd-plus-snapshots-"};
+    unsigned num_objectives = instance.senses.size();
+    mopop::Objective_Bounds bounds(instance.senses);
+    std::vector<double> reference_point;
+    std::vector<std::vector<double>> reference_pareto;
+    std::vector<Run> runs;
+    unsigned num_runs, max_num_solutions = 800, num_threads = 1;
+    // Whether the hypervolume, the hypervolume ratio and the normalized IGD+
+    // are written for some run.
+    std::vector<bool> is_requested(final_options.size(), false);
+
+    if (arg_parser.option_exists("--max-num-solutions")) {
+      max_num_solutions =
+          std::stoul(arg_parser.option_value("--max-num-solutions"));
+    }
+
+    if (arg_parser.option_exists("--num-threads")) {
+      num_threads = std::max<unsigned long>(
+          1, std::stoul(arg_parser.option_value("--num-threads")));
+    }
+
+    for (num_runs = 0;; num_runs++) {
+      const std::string suffix = std::to_string(num_runs);
+      bool exists = arg_parser.option_exists("--pareto-" + suffix) ||
+                    arg_parser.option_exists("--best-solutions-snapshots-" +
+                                             suffix);
+
+      for (unsigned k = 0; k < final_options.size(); k++) {
+        if (arg_parser.option_exists(final_options[k] + suffix) ||
+            arg_parser.option_exists(snapshots_options[k] + suffix)) {
+          exists = true;
+          is_requested[k] = true;
+        }
+      }
+
+      if (!exists) {
+        break;
+      }
+    }
+
+    // Every file is read once, and the runs are read in parallel.
+    runs.resize(num_runs);
+
+    mopop::parallel_for(num_runs, num_threads, [&](unsigned i) {
+      runs[i] = load_run(arg_parser, i, num_objectives);
+    });
+
+    std::vector<std::vector<std::vector<double>>> paretos, snapshots;
+
+    for (unsigned i = 0; i < num_runs; i++) {
+      paretos.push_back(runs[i].pareto);
+      snapshots.insert(snapshots.end(),
+                       runs[i].best_solutions_snapshots.begin(),
+                       runs[i].best_solutions_snapshots.end());
+    }
+
+    for (const std::vector<std::vector<double>>& pareto : paretos) {
+      for (const std::vector<double>& value : pareto) {
+        bounds.update(value);
+      }
+    }
+
+    for (const std::vector<std::vector<double>>& snapshot : snapshots) {
+      for (const std::vector<double>& value : snapshot) {
+        bounds.update(value);
+      }
+    }
+
+    reference_pareto =
+        mopop::Reference_Front(instance.senses, max_num_solutions)
+            .compute(paretos, snapshots);
+    reference_point = bounds.reference_point();
+
+    // The separate calculators read the reference front and point back from
+    // these files, at the precision they were written, and so do the metrics
+    // below, which keeps every value the same as theirs.
+    if (arg_parser.option_exists("--reference-pareto")) {
+      write_front(arg_parser.option_value("--reference-pareto"),
+                  reference_pareto);
+      reference_pareto = mopop::read_front(
+          arg_parser.option_value("--reference-pareto"), num_objectives);
+    }
+
+    if (arg_parser.option_exists("--reference-point")) {
+      write_front(arg_parser.option_value("--reference-point"),
+                  {reference_point});
+      reference_point =
+          mopop::read_front(arg_parser.option_value("--reference-point"),
+                            num_objectives)
+              .back();
+    }
+
+    const bool with_hypervolume = is_requested[0] || is_requested[1];
+    const bool with_igd_plus = is_requested[2];
+
+    if (!with_hypervolume && !with_igd_plus) {
+      return 0;
+    }
+
+    const mopop::Hypervolume_Ratio hypervolume_ratio_engine(
+        instance.senses, reference_point, reference_pareto);
+    const mopop::Normalized_IGD_Plus normalized_igd_plus_engine(
+        instance.senses, reference_pareto, reference_point);
+    const double reference_hypervolume =
+        hypervolume_ratio_engine.reference_hypervolume;
+
+    assert(reference_hypervolume > 0.0);
+    assert(normalized_igd_plus_engine.reference_igd_plus > 0.0);
+
+    // Each run gives a unit for its final front and one for its snapshots,
+    // whose hypervolumes are tracked from one snapshot to the next.
+    mopop::parallel_for(2 * num_runs, num_threads, [&](unsigned unit) {
+      const unsigned i = unit / 2;
+      const std::string suffix = std::to_string(i);
+      const Run& run = runs[i];
+
+      if (unit % 2 == 0) {
+        const double hypervolume =
+            with_hypervolume
+                ? hypervolume_ratio_engine.engine.compute(run.pareto)
+                : 0.0;
+        const double hypervolume_ratio = hypervolume / reference_hypervolume;
+        const double normalized_igd_plus =
+            with_igd_plus ? normalized_igd_plus_engine.compute(run.pareto)
+                          : 1.0;
+
+        assert(hypervolume >= 0.0);
+        assert(hypervolume_ratio >= 0.0);
+        assert(hypervolume_ratio <= 1.0 + 1e-9);
+        assert(normalized_igd_plus >= 0.0);
+        assert(normalized_igd_plus <= 1.0 + 1e-9);
+
+        const std::vector<double> values = {hypervolume, hypervolume_ratio,
+                                            normalized_igd_plus};
+
+        for (unsigned k = 0; k < final_options.size(); k++) {
+          if (arg_parser.option_exists(final_options[k] + suffix)) {
+            write_value(arg_parser.option_value(final_options[k] + suffix),
+                        values[k]);
+          }
+        }
+      } else {
+        const unsigned num_snapshots = run.best_solutions_snapshots.size();
+        mopop::Incremental_Hypervolume hypervolume_tracker(instance.senses,
+                                                           reference_point);
+        std::vector<std::vector<double>> values(
+            snapshots_options.size(), std::vector<double>(num_snapshots));
+
+        for (unsigned j = 0; j < num_snapshots; j++) {
+          const std::vector<std::vector<double>>& snapshot =
+              run.best_solutions_snapshots[j];
+
+          values[0][j] =
+              with_hypervolume ? hypervolume_tracker.update(snapshot) : 0.0;
+          values[1][j] = values[0][j] / reference_hypervolume;
+          values[2][j] = with_igd_plus
+                             ? normalized_igd_plus_engine.compute(snapshot)
+                             : 1.0;
+
+          assert(values[0][j] >= 0.0);
+          assert(values[1][j] >= 0.0);
+          assert(values[1][j] <= 1.0 + 1e-9);
+          assert(values[2][j] >= 0.0);
+          assert(values[2][j] <= 1.0 + 1e-9);
+        }
+
+        for (unsigned k = 0; k < snapshots_options.size(); k++) {
+          if (arg_parser.option_exists(snapshots_options[k] + suffix)) {
+            write_snapshots(
+                arg_parser.option_value(snapshots_options[k] + suffix), run,
+                values[k]);
+          }
+        }
+      }
+    });
+  } else {
+    std::cerr
+        << "./metrics_exec "
+        << "--expected-returns-filename <expected_returns_filename> "
+        << "--covariance-filename <covariance_filename> "
+        << "| --instance-filename <instance_filename> "
+        << "--max-num-solutions <max_num_solutions> "
+        << "--num-threads <num_threads> "
+        << "--pareto-i <pareto_filename> "
+        << "--best-solutions-snapshots-i <best_solutions_snapshots_filename> "
+        << "--reference-pareto <reference_pareto_filename> "
+        << "--reference-point <reference_point_filename> "
+        << "--hypervolume-i <hypervolume_filename> "
+        << "--hypervolume-snapshots-i <hypervolume_snapshots_filename> "
+        << "--hvr-i <hvr_filename> "
+        << "--hvr-snapshots-i <hvr_snapshots_filename> "
+        << "--nigd-plus-i <nigd_plus_filename> "
+        << "--nigd-plus-snapshots-i <nigd_plus_snapshots_filename> "
+        << std::endl;
+  }
+
+  return 0;
+}
@@ -4,11 +4,15 @@
 int main(int argc, char* argv[]) {
   Argument_Parser arg_parser(argc, argv);
 
-  if (arg_parser.option_exists("--expected-returns-filename") &&
-      arg_parser.option_exists("--covariance-filename")) {
-    mopop::Instance instance(
-        arg_parser.option_value("--expected-returns-filename"),
-        arg_parser.option_value("--covariance-filename"));
+  if (arg_parser.option_exists("--instance-filename") ||
+      (arg_parser.option_exists("--expected-returns-filename") &&
+       arg_parser.option_exists("--covariance-filename"))) {
+    mopop::Instance instance =
+        arg_parser.option_exists("--instance-filename")
+            ? mopop::Instance(arg_parser.option_value("--instance-filename"))
+            : mopop::Instance(
+                  arg_parser.option_value("--expected-returns-filename"),
+                  arg_parser.option_value("--covariance-filename"));
     mopop::MOEAD_Solver solver(instance);
 
     if (arg_parser.option_exists("--seed")) {
@@ -74,7 +78,68 @@ int main(int argc, char* argv[]) {
     solver.preserve_diversity =
         arg_parser.option_exists("--preserve-diversity");
 
+    if (arg_parser.option_exists("--num-threads")) {
+      solver.num_threads = std::stoul(arg_parser.option_value("--num-threads"));
+    }
+
+    if (arg_parser.option_exists("--max-num-generations-per-evolve")) {
+      solver.max_num_generations_per_evolve = std::stoul(
+          arg_parser.option_value("--max-num-generations-per-evolve"));
+    }
+
+    if (arg_parser.option_exists("--reference-point")) {
+      solver.load_reference_point(arg_parser.option_value("--reference-point"));
+    }
+
+    if (arg_parser.option_exists("--hypervolume-stagnation-limit")) {
+      solver.hypervolume_stagnation_limit = std::stoul(
+          arg_parser.option_value("--hypervolume-stagnation-limit"));
+    }
+
+    mopop::Snapshot_Writer snapshot_writer(instance.senses,
+                                           solver.max_num_snapshots);
+
+    if (arg_parser.option_exists("--output-format")) {
+      const std::string output_format =
+          arg_parser.option_value("--output-format");
+
+      if (output_format != "text" && output_format != "binary") {
+        throw std::runtime_error("Invalid output format " + output_format +
+                                 ", expected text or binary.");
+      }
+
+      snapshot_writer.is_binary = output_format == "binary";
+    }
+
+    if (arg_parser.option_exists("--best-solutions-snapshots")) {
+      snapshot_writer.best_solutions_snapshots_filename =
+          arg_parser.option_value("--best-solutions-snapshots");
+    }
+
+    if (arg_parser.option_exists("--hypervolume-snapshots")) {
+      snapshot_writer.hypervolume_snapshots_filename =
+          arg_parser.option_value("--hypervolume-snapshots");
+    }
+
+    if (arg_parser.option_exists("--num-non-dominated-snapshots")) {
+      snapshot_writer.num_non_dominated_snapshots_filename =
+          arg_parser.option_value("--num-non-dominated-snapshots");
+    }
+
+    if (arg_parser.option_exists("--num-fronts-snapshots")) {
+      snapshot_writer.num_fronts_snapshots_filename =
+          arg_parser.option_value("--num-fronts-snapshots");
+    }
+
+    if (arg_parser.option_exists("--populations-snapshots")) {
+      snapshot_writer.populations_snapshots_filename =
+          arg_parser.option_value("--populations-snapshots");
+    }
+
+    snapshot_writer.start();
+    solver.snapshot_writer = &snapshot_writer;
     solver.solve();
+    snapshot_writer.close();
 
     if (arg_parser.option_exists("--statistics")) {
       std::ofstream ofs;
@@ -120,7 +185,19 @@ int main(int argc, char* argv[]) {
       }
     }
 
-    if (arg_parser.option_exists("--pareto")) {
+    if (arg_parser.option_exists("--pareto") && snapshot_writer.is_binary) {
+      mopop::Snapshot_File_Writer pareto_file;
+      std::vector<std::vector<double>> front;
+
+      for (const auto& solution : solver.best_solutions) {
+        front.push_back(solution.value);
+      }
+
+      pareto_file.open(arg_parser.option_value("--pareto"),
+                       instance.senses.size());
+      pareto_file.append(solver.num_iterations, solver.solving_time, front);
+      pareto_file.close();
+    } else if (arg_parser.option_exists("--pareto")) {
       std::ofstream ofs;
       ofs.open(arg_parser.option_value("--pareto"));
 
@@ -144,158 +221,12 @@ int main(int argc, char* argv[]) {
                                  " not created.");
       }
     }
-
-    if (arg_parser.option_exists("--best-solutions-snapshots")) {
-      std::string best_solutions_snapshots_filename =
-          arg_parser.option_value("--best-solutions-snapshots");
-
-      for (unsigned i = 0; i < solver.best_solutions_snapshots.size(); i++) {
-        std::ofstream ofs;
-        ofs.open(best_solutions_snapshots_filename + std::to_string(i) +
-                 ".txt");
-
-        if (ofs.is_open()) {
-          unsigned iteration = std::get<0>(solver.best_solutions_snapshots[i]);
-          double time = std::get<1>(solver.best_solutions_snapshots[i]);
-          std::vector<std::vector<double>> best_solutions =
-              std::get<2>(solver.best_solutions_snapshots[i]);
-
-          ofs << iteration << " " << time << std::endl;
-
-          for (unsigned j = 0; j < best_solutions.size(); j++) {
-            for (unsigned k = 0; k < best_solutions[j].size() - 1; k++) {
-              ofs << best_solutions[j][k] << " ";
-            }
-
-            ofs << best_solutions[j].back() << std::endl;
-          }
-
-          if (ofs.eof() || ofs.fail() || ofs.bad()) {
-            throw std::runtime_error("Error writing file " +
-                                     best_solutions_snapshots_filename +
-                                     std::to_string(i) + "txt.");
-          }
-
-          ofs.close();
-        } else {
-          throw std::runtime_error("File " + best_solutions_snapshots_filename +
-                                   std::to_string(i) + ".txt not created.");
-        }
-      }
-    }
-
-    if (arg_parser.option_exists("--num-non-dominated-snapshots")) {
-      std::ofstream ofs;
-      ofs.open(arg_parser.option_value("--num-non-dominated-snapshots"));
-
-      if (ofs.is_open()) {
-        for (unsigned i = 0; i < solver.num_non_dominated_snapshots.size();
-             i++) {
-          unsigned iteration =
-              std::get<0>(solver.num_non_dominated_snapshots[i]);
-          double time = std::get<1>(solver.num_non_dominated_snapshots[i]);
-          std::vector<unsigned> num_non_dominated =
-              std::get<2>(solver.num_non_dominated_snapshots[i]);
-
-          ofs << iteration << " " << time << " ";
-
-          for (unsigned j = 0; j < num_non_dominated.size() - 1; j++) {
-            ofs << num_non_dominated[j] << " ";
-          }
-
-          ofs << num_non_dominated.back() << std::endl;
-
-          if (ofs.eof() || ofs.fail() || ofs.bad()) {
-            throw std::runtime_error(
-                "Error writing file " +
-                arg_parser.option_value("--num-non-dominated-snapshots") + ".");
-          }
-        }
-
-        ofs.close();
-      } else {
-        throw std::runtime_error(
-            "File " + arg_parser.option_value("--num-non-dominated-snapshots") +
-            " not created.");
-      }
-    }
-
-    if (arg_parser.option_exists("--num-fronts-snapshots")) {
-      std::ofstream ofs;
-      ofs.open(arg_parser.option_value("--num-fronts-snapshots"));
-
-      if (ofs.is_open()) {
-        for (unsigned i = 0; i < solver.num_fronts_snapshots.size(); i++) {
-          unsigned iteration = std::get<0>(solver.num_fronts_snapshots[i]);
-          double time = std::get<1>(solver.num_fronts_snapshots[i]);
-          std::vector<unsigned> num_fronts =
-              std::get<2>(solver.num_fronts_snapshots[i]);
-
-          ofs << iteration << " " << time << " ";
-
-          for (unsigned j = 0; j < num_fronts.size() - 1; j++) {
-            ofs << num_fronts[j] << " ";
-          }
-
-          ofs << num_fronts.back() << std::endl;
-
-          if (ofs.eof() || ofs.fail() || ofs.bad()) {
-            throw std::runtime_error(
-                "Error writing file " +
-                arg_parser.option_value("--num-fronts-snapshots") + ".");
-          }
-        }
-
-        ofs.close();
-      } else {
-        throw std::runtime_error(
-            "File " + arg_parser.option_value("--num-fronts-snapshots") +
-            " not created.");
-      }
-    }
-
-    if (arg_parser.option_exists("--populations-snapshots")) {
-      std::string populations_snapshots_filename =
-          arg_parser.option_value("--populations-snapshots");
-
-      for (unsigned i = 0; i < solver.populations_snapshots.size(); i++) {
-        std::ofstream ofs;
-        ofs.open(populations_snapshots_filename + std::to_string(i) + ".txt");
-
-        if (ofs.is_open()) {
-          unsigned iteration = std::get<0>(solver.populations_snapshots[i]);
-          double time = std::get<1>(solver.populations_snapshots[i]);
-          std::vector<std::vector<std::vector<double>>> population =
-              std::get<2>(solver.populations_snapshots[i]);
-
-          ofs << iteration << " " << time << std::endl;
-
-          for (unsigned j = 0; j < population.front().size(); j++) {
-            for (unsigned k = 0; k < population.front()[j].size() - 1; k++) {
-              ofs << population.front()[j][k] << " ";
-            }
-
-            ofs << population.front()[j].back() << std::endl;
-          }
-
-          if (ofs.eof() || ofs.fail() || ofs.bad()) {
-            throw std::runtime_error("Error writing file " +
-                                     populations_snapshots_filename +
-                                     std::to_string(i) + ".txt.");
-          }
-
-          ofs.close();
-        } else {
-          throw std::runtime_error("File " + populations_snapshots_filename +
-                                   std::to_string(i) + ".txt not created.");
-        }
-      }
-    }
   } else {
     std::cerr
         << "./moead_solver_exec "
         << "--expected-returns-filename <expected_returns_filename> "
         << "--covariance-filename <covariance_filename> "
+        << "| --instance-filename <instance_filename> "
         << "--seed <seed> "
         << "--time-limit <time_limit> "
         << "--iterations-limit <iterations_limit> "
@@ -311,14 +242,20 @@ int main(int argc, char* argv[]) {
         << "--realb <realb> "
         << "--limit <limit> "
         << "--preserve-diversity "
+        << "--num-threads <num_threads> "
+        << "--max-num-generations-per-evolve <max_num_generations_per_evolve> "
+        << "--reference-point <reference_point_filename> "
+        << "--hypervolume-stagnation-limit <hypervolume_stagnation_limit> "
         << "--statistics <statistics_filename> "
         << "--solutions <solutions_filename> "
         << "--pareto <pareto_filename> "
         << "--best-solutions-snapshots <best_solutions_snapshots_filename> "
+        << "--hypervolume-snapshots <hypervolume_snapshots_filename> "
         << "--num-non-dominated-snapshots "
            "<num_non_dominated_snapshots_filename> "
         << "--num-fronts-snapshots <num_fronts_snapshots_filename> "
         << "--populations-snapshots <populations_snapshots_filename> "
+        << "--output-format <text|binary> "
         << std::endl;
   }
 
@@ -1,9 +1,12 @@
 #include <algorithm>
 #include <cmath>
+#include <filesystem>
 #include <fstream>
 #include <numeric>
 
 #include "utils/argument_parser.hpp"
+#include "utils/snapshot_file.hpp"
+#include "utils/text_reader.hpp"
 
 int main(int argc, char* argv[]) {
   Argument_Parser arg_parser(argc, argv);
@@ -26,20 +29,17 @@ int main(int argc, char* argv[]) {
   nigd_pluses.resize(num_nigd_pluses);
 
   for (unsigned i = 0; i < num_hvrs; i++) {
-    std::ifstream ifs;
-    ifs.open(arg_parser.option_value("--hvr-" + std::to_string(i)));
-
-    if (ifs.is_open()) {
-      ifs >> hvrs[i].first;
+    mopop::Text_Reader reader;
 
-      if (ifs.eof() || ifs.fail() || ifs.bad()) {
+    if (reader.open(arg_parser.option_value("--hvr-" + std::to_string(i)))) {
+      if (!reader.next_line() || !reader.next_number(hvrs[i].first)) {
         throw std::runtime_error(
             "Error reading file " +
             arg_parser.option_value("--hvr-" + std::to_string(i)) + ".");
       }
 
       hvrs[i].second = i;
-      ifs.close();
+      reader.close();
       hvr_values.push_back(hvrs[i].first);
     } else {
       throw std::runtime_error(
@@ -49,20 +49,18 @@ int main(int argc, char* argv[]) {
   }
 
   for (unsigned i = 0; i < num_nigd_pluses; i++) {
-    std::ifstream ifs;
-    ifs.open(arg_parser.option_value("--nigd-plus-" + std::to_string(i)));
+    mopop::Text_Reader reader;
 
-    if (ifs.is_open()) {
-      ifs >> nigd_pluses[i].first;
-
-      if (ifs.eof() || ifs.fail() || ifs.bad()) {
+    if (reader.open(
+            arg_parser.option_value("--nigd-plus-" + std::to_string(i)))) {
+      if (!reader.next_line() || !reader.next_number(nigd_pluses[i].first)) {
         throw std::runtime_error(
             "Error reading file " +
             arg_parser.option_value("--nigd-plus-" + std::to_string(i)) + ".");
       }
 
       nigd_pluses[i].second = i;
-      ifs.close();
+      reader.close();
       nigd_plus_values.push_back(nigd_pluses[i].first);
     } else {
       throw std::runtime_error(
@@ -418,37 +416,45 @@ int main(int argc, char* argv[]) {
         arg_parser.option_value("--best-solutions-snapshots-" +
                                 std::to_string(index_best));
 
-    for (unsigned i = 0;; i++) {
-      std::ifstream ifs;
-      ifs.open(best_solutions_snapshots_index_best_filename +
-                   std::to_string(i) + ".txt",
-               std::ios::binary);
+    if (mopop::Snapshot_File_Reader::is_snapshot_file(
+            best_solutions_snapshots_index_best_filename)) {
+      std::filesystem::copy_file(
+          best_solutions_snapshots_index_best_filename,
+          best_solutions_snapshots_best_filename,
+          std::filesystem::copy_options::overwrite_existing);
+    } else {
+      for (unsigned i = 0;; i++) {
+        std::ifstream ifs;
+        ifs.open(best_solutions_snapshots_index_best_filename +
+                     std::to_string(i) + ".txt",
+                 std::ios::binary);
 
-      if (ifs.is_open()) {
-        std::ofstream ofs;
-        ofs.open(
-            best_solutions_snapshots_best_filename + std::to_string(i) + ".txt",
-            std::ios::binary);
+        if (ifs.is_open()) {
+          std::ofstream ofs;
+          ofs.open(best_solutions_snapshots_best_filename + std::to_string(i) +
+                       ".txt",
+                   std::ios::binary);
 
-        if (ofs.is_open()) {
-          ofs << ifs.rdbuf();
+          if (ofs.is_open()) {
+            ofs << ifs.rdbuf();
 
-          if (ofs.eof() || ofs.fail() || ofs.bad()) {
-            throw std::runtime_error("Error writing file " +
+            if (ofs.eof() || ofs.fail() || ofs.bad()) {
+              throw std::runtime_error("Error writing file " +
+                                       best_solutions_snapshots_best_filename +
+                                       std::to_string(i) + ".txt.");
+            }
+
+            ofs.close();
+          } else {
+            throw std::runtime_error("File " +
                                      best_solutions_snapshots_best_filename +
-                                     std::to_string(i) + ".txt.");
+                                     std::to_string(i) + ".txt not created.");
           }
 
-          ofs.close();
+          ifs.close();
         } else {
-          throw std::runtime_error("File " +
-                                   best_solutions_snapshots_best_filename +
-                                   std::to_string(i) + ".txt not created.");
+          break;
         }
-
-        ifs.close();
-      } else {
-        break;
       }
     }
   }
@@ -462,37 +468,46 @@ int main(int argc, char* argv[]) {
         arg_parser.option_value("--best-solutions-snapshots-" +
                                 std::to_string(index_median));
 
-    for (unsigned i = 0;; i++) {
-      std::ifstream ifs;
-      ifs.open(best_solutions_snapshots_index_median_filename +
-                   std::to_string(i) + ".txt",
-               std::ios::binary);
-
-      if (ifs.is_open()) {
-        std::ofstream ofs;
-        ofs.open(best_solutions_snapshots_median_filename + std::to_string(i) +
-                     ".txt",
+    if (mopop::Snapshot_File_Reader::is_snapshot_file(
+            best_solutions_snapshots_index_median_filename)) {
+      std::filesystem::copy_file(
+          best_solutions_snapshots_index_median_filename,
+          best_solutions_snapshots_median_filename,
+          std::filesystem::copy_options::overwrite_existing);
+    } else {
+      for (unsigned i = 0;; i++) {
+        std::ifstream ifs;
+        ifs.open(best_solutions_snapshots_index_median_filename +
+                     std::to_string(i) + ".txt",
                  std::ios::binary);
 
-        if (ofs.is_open()) {
-          ofs << ifs.rdbuf();
-
-          if (ofs.eof() || ofs.fail() || ofs.bad()) {
-            throw std::runtime_error("Error writing file " +
+        if (ifs.is_open()) {
+          std::ofstream ofs;
+          ofs.open(best_solutions_snapshots_median_filename +
+                       std::to_string(i) + ".txt",
+                   std::ios::binary);
+
+          if (ofs.is_open()) {
+            ofs << ifs.rdbuf();
+
+            if (ofs.eof() || ofs.fail() || ofs.bad()) {
+              throw std::runtime_error(
+                  "Error writing file " +
+                  best_solutions_snapshots_median_filename +
+                  std::to_string(i) + ".txt.");
+            }
+
+            ofs.close();
+          } else {
+            throw std::runtime_error("File " +
                                      best_solutions_snapshots_median_filename +
-                                     std::to_string(i) + ".txt.");
+                                     std::to_string(i) + ".txt not created.");
           }
 
-          ofs.close();
+          ifs.close();
         } else {
-          throw std::runtime_error("File " +
-                                   best_solutions_snapshots_median_filename +
-                                   std::to_string(i) + ".txt not created.");
+          break;
         }
-
-        ifs.close();
-      } else {
-        break;
       }
     }
   }
@@ -667,37 +682,45 @@ int main(int argc, char* argv[]) {
         arg_parser.option_value("--populations-snapshots-" +
                                 std::to_string(index_best));
 
-    for (unsigned i = 0;; i++) {
-      std::ifstream ifs;
-      ifs.open(populations_snapshots_index_best_filename + std::to_string(i) +
-                   ".txt",
-               std::ios::binary);
+    if (mopop::Snapshot_File_Reader::is_snapshot_file(
+            populations_snapshots_index_best_filename)) {
+      std::filesystem::copy_file(
+          populations_snapshots_index_best_filename,
+          populations_snapshots_best_filename,
+          std::filesystem::copy_options::overwrite_existing);
+    } else {
+      for (unsigned i = 0;; i++) {
+        std::ifstream ifs;
+        ifs.open(populations_snapshots_index_best_filename + std::to_string(i) +
+                     ".txt",
+                 std::ios::binary);
+
+        if (ifs.is_open()) {
+          std::ofstream ofs;
+          ofs.open(
+              populations_snapshots_best_filename + std::to_string(i) + ".txt",
+              std::ios::binary);
 
-      if (ifs.is_open()) {
-        std::ofstream ofs;
-        ofs.open(
-            populations_snapshots_best_filename + std::to_string(i) + ".txt",
-            std::ios::binary);
+          if (ofs.is_open()) {
+            ofs << ifs.rdbuf();
 
-        if (ofs.is_open()) {
-          ofs << ifs.rdbuf();
+            if (ofs.eof() || ofs.fail() || ofs.bad()) {
+              throw std::runtime_error("Error writing file " +
+                                       populations_snapshots_best_filename +
+                                       std::to_string(i) + ".txt.");
+            }
 
-          if (ofs.eof() || ofs.fail() || ofs.bad()) {
-            throw std::runtime_error("Error writing file " +
+            ofs.close();
+          } else {
+            throw std::runtime_error("File " +
                                      populations_snapshots_best_filename +
-                                     std::to_string(i) + ".txt.");
+                                     std::to_string(i) + ".txt not created.");
           }
 
-          ofs.close();
+          ifs.close();
         } else {
-          throw std::runtime_error("File " +
-                                   populations_snapshots_best_filename +
-                                   std::to_string(i) + ".txt not created.");
+          break;
         }
-
-        ifs.close();
-      } else {
-        break;
       }
     }
   }
@@ -711,37 +734,45 @@ int main(int argc, char* argv[]) {
         arg_parser.option_value("--populations-snapshots-" +
                                 std::to_string(index_median));
 
-    for (unsigned i = 0;; i++) {
-      std::ifstream ifs;
-      ifs.open(populations_snapshots_index_median_filename + std::to_string(i) +
-                   ".txt",
-               std::ios::binary);
+    if (mopop::Snapshot_File_Reader::is_snapshot_file(
+            populations_snapshots_index_median_filename)) {
+      std::filesystem::copy_file(
+          populations_snapshots_index_median_filename,
+          populations_snapshots_median_filename,
+          std::filesystem::copy_options::overwrite_existing);
+    } else {
+      for (unsigned i = 0;; i++) {
+        std::ifstream ifs;
+        ifs.open(populations_snapshots_index_median_filename +
+                     std::to_string(i) + ".txt",
+                 std::ios::binary);
+
+        if (ifs.is_open()) {
+          std::ofstream ofs;
+          ofs.open(populations_snapshots_median_filename + std::to_string(i) +
+                       ".txt",
+                   std::ios::binary);
 
-      if (ifs.is_open()) {
-        std::ofstream ofs;
-        ofs.open(
-            populations_snapshots_median_filename + std::to_string(i) + ".txt",
-            std::ios::binary);
+          if (ofs.is_open()) {
+            ofs << ifs.rdbuf();
 
-        if (ofs.is_open()) {
-          ofs << ifs.rdbuf();
+            if (ofs.eof() || ofs.fail() || ofs.bad()) {
+              throw std::runtime_error("Error writing file " +
+                                       populations_snapshots_median_filename +
+                                       std::to_string(i) + ".txt.");
+            }
 
-          if (ofs.eof() || ofs.fail() || ofs.bad()) {
-            throw std::runtime_error("Error writing file " +
+            ofs.close();
+          } else {
+            throw std::runtime_error("File " +
                                      populations_snapshots_median_filename +
-                                     std::to_string(i) + ".txt.");
+                                     std::to_string(i) + ".txt not created.");
           }
 
-          ofs.close();
+          ifs.close();
         } else {
-          throw std::runtime_error("File " +
-                                   populations_snapshots_median_filename +
-                                   std::to_string(i) + ".txt not created.");
+          break;
         }
-
-        ifs.close();
-      } else {
-        break;
       }
     }
   }
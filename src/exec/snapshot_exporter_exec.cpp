@@ -0,0 +1,94 @@
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "utils/argument_parser.hpp"
+#include "utils/snapshot_file.hpp"
+
+/**
+ * @brief Writes the points of a snapshot to a file, one point per line, as the
+ * solver execs write their text files.
+ *
+ * @param ofs The file.
+ * @param snapshot_file The binary snapshot file.
+ * @param j The index of the snapshot.
+ */
+static void write_points(std::ofstream& ofs,
+                         const mopop::Snapshot_File_Reader& snapshot_file,
+                         std::size_t j) {
+  for (std::size_t i = 0; i < snapshot_file.count(j); i++) {
+    for (unsigned k = 0; k < snapshot_file.num_objectives; k++) {
+      ofs << snapshot_file.column(j, k)[i]
+          << (k + 1 < snapshot_file.num_objectives ? " " : "");
+    }
+
+    ofs << std::endl;
+  }
+}
+
+int main(int argc, char* argv[]) {
+  Argument_Parser arg_parser(argc, argv);
+
+  if (arg_parser.option_exists("--snapshot-file") &&
+      (arg_parser.option_exists("--snapshots") ||
+       arg_parser.option_exists("--pareto"))) {
+    const mopop::Snapshot_File_Reader snapshot_file(
+        arg_parser.option_value("--snapshot-file"));
+
+    // One text file per snapshot, named and laid out as the solver execs name
+    // and lay out the best solutions and populations snapshots.
+    if (arg_parser.option_exists("--snapshots")) {
+      for (std::size_t j = 0; j < snapshot_file.num_snapshots(); j++) {
+        const std::string filename = arg_parser.option_value("--snapshots") +
+                                     std::to_string(j) + ".txt";
+        std::ofstream ofs;
+
+        ofs.open(filename);
+
+        if (ofs.is_open()) {
+          ofs << snapshot_file.iteration(j) << " " << snapshot_file.time(j)
+              << std::endl;
+          write_points(ofs, snapshot_file, j);
+
+          if (ofs.eof() || ofs.fail() || ofs.bad()) {
+            throw std::runtime_error("Error writing file " + filename + ".");
+          }
+
+          ofs.close();
+        } else {
+          throw std::runtime_error("File " + filename + " not created.");
+        }
+      }
+    }
+
+    // The last snapshot, without its iteration and time, as a pareto file.
+    if (arg_parser.option_exists("--pareto")) {
+      std::ofstream ofs;
+
+      ofs.open(arg_parser.option_value("--pareto"));
+
+      if (ofs.is_open()) {
+        if (snapshot_file.num_snapshots() > 0) {
+          write_points(ofs, snapshot_file, snapshot_file.num_snapshots() - 1);
+        }
+
+        if (ofs.eof() || ofs.fail() || ofs.bad()) {
+          throw std::runtime_error("Error writing file " +
+                                   arg_parser.option_value("--pareto") + ".");
+        }
+
+        ofs.close();
+      } else {
+        throw std::runtime_error("File " + arg_parser.option_value("--pareto") +
+                                 " not created.");
+      }
+    }
+  } else {
+    std::cerr << "./snapshot_exporter_exec "
+              << "--snapshot-file <snapshot_filename> "
+              << "--snapshots <snapshots_filename> "
+              << "--pareto <pareto_filename> " << std::endl;
+  }
+
+  return 0;
+}
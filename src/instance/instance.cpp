@@ -1,17 +1,299 @@
 #include "instance.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <memory>
 #include <stdexcept>
 
+#include "utils/mapped_file.hpp"
+
 namespace mopop {
 
+namespace {
+
+/**
+ * @brief The first bytes of every binary instance file.
+ */
+constexpr char binary_file_magic[8] = {'M', 'O', 'P', 'O', 'P', 'I', 'N', 'S'};
+
+/**
+ * @brief A value whose bytes, as stored, tell the byte order of the writer.
+ */
+constexpr std::uint32_t binary_file_byte_order = 0x01020304;
+
+/**
+ * @brief The header of a binary instance file. The offsets are in bytes from
+ * the start of the file, and the sections follow the header in the order of
+ * their fields.
+ */
+struct Binary_File_Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t num_assets;
+  std::uint32_t num_factors;
+  std::uint32_t covariance_storage;
+  std::uint32_t covariance_stride;
+  std::uint64_t tickers_offset;
+  std::uint64_t tickers_size;
+  std::uint64_t expected_returns_offset;
+  std::uint64_t covariance_offset;
+  std::uint64_t covariance_size;
+  std::uint64_t file_size;
+  std::uint64_t checksum;
+  std::uint64_t reserved[5];
+};
+
+static_assert(sizeof(Binary_File_Header) == 128,
+              "The binary instance file header must not change size");
+
+/**
+ * @brief Rounds an offset up to a whole number of covariance_alignment-byte
+ * blocks.
+ */
+std::uint64_t aligned_offset(std::uint64_t offset) {
+  const std::uint64_t alignment = Instance::covariance_alignment;
+  return ((offset + alignment - 1) / alignment) * alignment;
+}
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash of a block, one 8-byte word at a
+ * time, which is fast enough to verify a mapped file on every load.
+ *
+ * @param first The first byte of the block.
+ * @param size The size of the block, a multiple of 8.
+ * @return The hash.
+ */
+std::uint64_t binary_file_checksum(const unsigned char* first,
+                                   std::size_t size) {
+  std::uint64_t hash = 14695981039346656037ULL;
+
+  for (std::size_t i = 0; i + 8 <= size; i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, first + i, sizeof(word));
+    hash = (hash ^ word) * 1099511628211ULL;
+  }
+
+  return hash;
+}
+
+}  // namespace
+
+/**
+ * @brief Returns the row stride of a covariance matrix with the given number of
+ * assets.
+ *
+ * @param num_assets The number of assets.
+ * @return num_assets rounded up to a multiple of the number of doubles in
+ * covariance_alignment bytes.
+ */
+unsigned Instance::padded_stride(unsigned num_assets) {
+  const unsigned block = Instance::covariance_alignment / sizeof(double);
+  return ((num_assets + block - 1) / block) * block;
+}
+
+/**
+ * @brief Copies a covariance matrix into the aligned row-major storage.
+ *
+ * @param covariance_matrix A 2D vector of doubles representing the covariance
+ * matrix of the assets.
+ */
+void Instance::set_covariance_matrix(
+    const std::vector<std::vector<double>> &covariance_matrix) {
+  this->covariance_storage = Covariance_Storage::DENSE;
+  this->covariance_stride = Instance::padded_stride(covariance_matrix.size());
+  this->covariance_data.assign(
+      covariance_matrix.size() * std::size_t(this->covariance_stride), 0.0);
+
+  for (std::size_t i = 0; i < covariance_matrix.size(); i++) {
+    std::copy(covariance_matrix[i].begin(),
+              covariance_matrix[i].begin() +
+                  std::min(covariance_matrix[i].size(),
+                           covariance_matrix.size()),
+              this->covariance_data.mutable_data() +
+                  i * this->covariance_stride);
+  }
+}
+
+/**
+ * @brief Returns the covariance storage the loading constructors pick for a
+ * given number of assets.
+ *
+ * @param num_assets The number of assets.
+ * @return PACKED from packed_covariance_min_num_assets assets on, DENSE
+ * otherwise.
+ */
+Covariance_Storage Instance::default_covariance_storage(unsigned num_assets) {
+  if (num_assets >= Instance::packed_covariance_min_num_assets) {
+    return Covariance_Storage::PACKED;
+  }
+
+  return Covariance_Storage::DENSE;
+}
+
+/**
+ * @brief Stores a factor model of the covariance matrix.
+ *
+ * The factor covariance matrix F is factored as L L^T and folded into the
+ * loadings, so that the variance of a portfolio is a sum of squared exposures
+ * plus its idiosyncratic variance.
+ *
+ * @param factor_loadings The num_assets x num_factors loadings B.
+ * @param factor_covariance The num_factors x num_factors covariance matrix F of
+ * the factors.
+ * @param idiosyncratic_variances The num_assets diagonal entries of D.
+ *
+ * @throws std::runtime_error If the dimensions do not match or F is not
+ * positive semidefinite.
+ */
+void Instance::set_factor_model(
+    const std::vector<std::vector<double>> &factor_loadings,
+    const std::vector<std::vector<double>> &factor_covariance,
+    const std::vector<double> &idiosyncratic_variances) {
+  const unsigned k = factor_covariance.size();
+
+  if (factor_loadings.size() != this->num_assets ||
+      idiosyncratic_variances.size() != this->num_assets) {
+    throw std::runtime_error("Factor model does not match the assets");
+  }
+
+  for (const std::vector<double> &row : factor_covariance) {
+    if (row.size() != k) {
+      throw std::runtime_error("Factor covariance matrix is not square");
+    }
+  }
+
+  for (const std::vector<double> &row : factor_loadings) {
+    if (row.size() != k) {
+      throw std::runtime_error("Factor loadings do not match the factors");
+    }
+  }
+
+  // Cholesky factorization F = L L^T. A zero pivot leaves its column of L at
+  // zero, which is exact when F is positive semidefinite.
+  std::vector<std::vector<double>> lower(k, std::vector<double>(k, 0.0));
+
+  for (unsigned a = 0; a < k; a++) {
+    double pivot = factor_covariance[a][a];
+
+    for (unsigned c = 0; c < a; c++) {
+      pivot -= lower[a][c] * lower[a][c];
+    }
+
+    const double tolerance = 1e-12 * std::fabs(factor_covariance[a][a]);
+
+    if (pivot < -tolerance) {
+      throw std::runtime_error(
+          "Factor covariance matrix is not positive semidefinite");
+    }
+
+    if (pivot <= tolerance) {
+      continue;
+    }
+
+    lower[a][a] = std::sqrt(pivot);
+
+    for (unsigned b = a + 1; b < k; b++) {
+      double entry = factor_covariance[b][a];
+
+      for (unsigned c = 0; c < a; c++) {
+        entry -= lower[b][c] * lower[a][c];
+      }
+
+      lower[b][a] = entry / lower[a][a];
+    }
+  }
+
+  this->covariance_storage = Covariance_Storage::FACTOR;
+  this->covariance_stride = Instance::padded_stride(this->num_assets);
+  this->num_factors = k;
+  this->covariance_data.assign(
+      std::size_t(k + 1) * this->covariance_stride, 0.0);
+
+  // Row a holds column a of B L, and L is lower triangular.
+  for (unsigned a = 0; a < k; a++) {
+    double *exposures = this->covariance_data.mutable_data() +
+                        std::size_t(a) * this->covariance_stride;
+
+    for (unsigned i = 0; i < this->num_assets; i++) {
+      for (unsigned b = a; b < k; b++) {
+        exposures[i] += factor_loadings[i][b] * lower[b][a];
+      }
+    }
+  }
+
+  std::copy(idiosyncratic_variances.begin(), idiosyncratic_variances.end(),
+            this->covariance_data.mutable_data() +
+                std::size_t(k) * this->covariance_stride);
+}
+
+/**
+ * @brief Loads a factor model from the rows of a factor model file that follow
+ * its header.
+ *
+ * @param file The factor model file, positioned after the header.
+ * @param num_factors The number of factors named in the header.
+ *
+ * @throws std::runtime_error If the file does not hold num_factors rows of
+ * factor covariances followed by one row of loadings and idiosyncratic variance
+ * per asset.
+ */
+void Instance::load_factor_model(Text_Reader &file, unsigned num_factors) {
+  std::vector<std::vector<double>> factor_covariance, factor_loadings;
+  std::vector<double> idiosyncratic_variances;
+  std::string_view name;
+  double value;
+
+  while (file.next_line()) {
+    std::vector<double> row;
+
+    if (!file.next_field(name)) {
+      continue;
+    }
+
+    while (file.next_number(value, ',')) {
+      row.push_back(value);
+    }
+
+    if (factor_covariance.size() < num_factors) {
+      if (row.size() != num_factors) {
+        throw std::runtime_error(
+            "Factor covariance matrix has a row of the wrong size");
+      }
+
+      factor_covariance.push_back(row);
+      continue;
+    }
+
+    if (row.size() != num_factors + 1) {
+      throw std::runtime_error("Factor loadings have a row of the wrong size");
+    }
+
+    idiosyncratic_variances.push_back(row.back());
+    row.pop_back();
+    factor_loadings.push_back(row);
+  }
+
+  if (factor_covariance.size() != num_factors) {
+    throw std::runtime_error("Factor covariance matrix has too few rows");
+  }
+
+  this->set_factor_model(factor_loadings, factor_covariance,
+                         idiosyncratic_variances);
+}
+
 /**
  * @brief Loads the instance data from the given files.
  *
  * This function reads the expected returns and covariance matrix from the
- * specified files and populates the corresponding member variables.
+ * specified files and populates the corresponding member variables. A
+ * covariance file whose header ends with an Idiosyncratic column holds a factor
+ * model instead of a matrix: one row per factor with the factor covariances,
+ * then one row per asset with its loadings and its idiosyncratic variance.
  *
  * @param expected_returns_filename The path to the file containing the expected
  * returns.
@@ -19,62 +301,92 @@ namespace mopop {
  * matrix.
  *
  * @throws std::runtime_error If either the expected returns file or the
- * covariance file cannot be opened.
+ * covariance file cannot be opened, or if the covariance matrix is not a square
+ * matrix over the assets of the expected returns file.
  */
 void Instance::load_instance(const std::string &expected_returns_filename,
                              const std::string &covariance_filename) {
-  std::ifstream expected_returns_file(expected_returns_filename),
-      covariance_file(covariance_filename);
-  std::string line;
+  Text_Reader expected_returns_file, covariance_file;
+  std::string_view ticker;
+  double value;
 
-  if (!expected_returns_file.is_open()) {
+  if (!expected_returns_file.open(expected_returns_filename)) {
     throw std::runtime_error("Unable to open expected returns file");
   }
 
-  std::getline(expected_returns_file, line);
+  expected_returns_file.next_line();
   this->tickers.clear();
 
-  while (std::getline(expected_returns_file, line)) {
-    std::istringstream linestream(line);
-    std::string ticker, expected_return_str;
-    double expected_return;
-
-    if (std::getline(linestream, ticker, ',') &&
-        std::getline(linestream, expected_return_str, ',')) {
-      this->tickers.push_back(ticker);
-      expected_return = std::stod(expected_return_str);
-      this->expected_returns.push_back(expected_return);
+  while (expected_returns_file.next_line()) {
+    if (expected_returns_file.next_field(ticker) &&
+        expected_returns_file.next_number(value, ',')) {
+      this->tickers.emplace_back(ticker);
+      this->expected_returns.push_back(value);
     }
   }
 
   expected_returns_file.close();
+  this->num_assets = tickers.size();
+  this->senses = {NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE,
+                  NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE};
 
-  if (!covariance_file.is_open()) {
+  if (!covariance_file.open(covariance_filename)) {
     throw std::runtime_error("Unable to open covariance file");
   }
 
-  std::getline(covariance_file, line);
-  this->covariance_matrix.clear();
+  covariance_file.next_line();
 
-  while (std::getline(covariance_file, line)) {
-    std::istringstream linestream(line);
-    std::string ticker;
-    std::vector<double> row;
-    std::string value_str;
+  const std::string_view header = covariance_file.rest_of_line();
+  const std::size_t last_column = header.rfind(',');
+
+  if (last_column != std::string_view::npos &&
+      header.substr(last_column + 1) == "Idiosyncratic") {
+    this->load_factor_model(
+        covariance_file, std::count(header.begin(), header.end(), ',') - 1);
+    return;
+  }
+
+  this->num_factors = 0;
+  this->covariance_storage = Covariance_Storage::DENSE;
+  this->covariance_stride = Instance::padded_stride(this->num_assets);
+  this->covariance_data.assign(
+      std::size_t(this->num_assets) * this->covariance_stride, 0.0);
+
+  double *data = this->covariance_data.mutable_data();
+  unsigned i = 0;
+
+  while (covariance_file.next_line()) {
+    unsigned j = 0;
+
+    if (!covariance_file.next_field(ticker)) {
+      continue;
+    }
+
+    if (i >= this->num_assets) {
+      throw std::runtime_error("Covariance matrix has too many rows");
+    }
+
+    while (covariance_file.next_number(value, ',')) {
+      if (j >= this->num_assets) {
+        throw std::runtime_error("Covariance matrix has too many columns");
+      }
 
-    std::getline(linestream, ticker, ',');
+      data[std::size_t(i) * this->covariance_stride + j] = value;
+      j++;
+    }
 
-    while (std::getline(linestream, value_str, ',')) {
-      row.push_back(std::stod(value_str));
+    if (j != this->num_assets) {
+      throw std::runtime_error("Covariance matrix has too few columns");
     }
 
-    this->covariance_matrix.push_back(row);
+    i++;
+  }
+
+  if (i != this->num_assets) {
+    throw std::runtime_error("Covariance matrix has too few rows");
   }
 
   covariance_file.close();
-  this->num_assets = tickers.size();
-  this->senses = {NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE,
-                  NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE};
 }
 
 /**
@@ -93,16 +405,54 @@ Instance::Instance(const std::vector<std::string> &tickers,
     : num_assets(covariance_matrix.size()),
       tickers(tickers),
       expected_returns(expected_returns),
-      covariance_matrix(covariance_matrix),
+      covariance_storage(Covariance_Storage::DENSE),
+      covariance_stride(0),
+      num_factors(0),
+      covariance_data(),
+      senses({NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE,
+              NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE}) {
+  this->set_covariance_matrix(covariance_matrix);
+  this->set_covariance_storage(
+      Instance::default_covariance_storage(this->num_assets));
+}
+
+/**
+ * @brief Constructs an Instance object with the given tickers, expected
+ * returns, and factor model of the covariance matrix B F B^T + D.
+ *
+ * @param tickers A vector of strings representing the asset tickers.
+ * @param expected_returns A vector of doubles representing the expected returns
+ * for each asset.
+ * @param factor_loadings The num_assets x num_factors loadings B.
+ * @param factor_covariance The num_factors x num_factors covariance matrix F of
+ * the factors.
+ * @param idiosyncratic_variances The num_assets diagonal entries of D.
+ */
+Instance::Instance(const std::vector<std::string> &tickers,
+                   const std::vector<double> &expected_returns,
+                   const std::vector<std::vector<double>> &factor_loadings,
+                   const std::vector<std::vector<double>> &factor_covariance,
+                   const std::vector<double> &idiosyncratic_variances)
+    : num_assets(factor_loadings.size()),
+      tickers(tickers),
+      expected_returns(expected_returns),
+      covariance_storage(Covariance_Storage::DENSE),
+      covariance_stride(0),
+      num_factors(0),
+      covariance_data(),
       senses({NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE,
-              NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE}) {}
+              NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE}) {
+  this->set_factor_model(factor_loadings, factor_covariance,
+                         idiosyncratic_variances);
+}
 
 /**
  * @brief Constructs an Instance object and initializes its data members.
  *
  * This constructor initializes the number of assets, tickers, expected returns,
  * covariance matrix, and senses. It then loads the instance data from the
- * specified files.
+ * specified files and, unless they hold a factor model, picks the covariance
+ * storage with default_covariance_storage.
  *
  * @param returns_filename The filename containing the expected returns data.
  * @param covariance_filename The filename containing the covariance matrix
@@ -113,9 +463,116 @@ Instance::Instance(const std::string &returns_filename,
     : num_assets(0),
       tickers(),
       expected_returns(),
-      covariance_matrix(),
+      covariance_storage(Covariance_Storage::DENSE),
+      covariance_stride(0),
+      num_factors(0),
+      covariance_data(),
       senses() {
   this->load_instance(returns_filename, covariance_filename);
+
+  if (this->covariance_storage != Covariance_Storage::FACTOR) {
+    this->set_covariance_storage(
+        Instance::default_covariance_storage(this->num_assets));
+  }
+}
+
+/**
+ * @brief Constructs an Instance object by memory-mapping a binary instance file
+ * written by write_binary_file.
+ *
+ * The file is mapped read-only and shared, so the processes that load the same
+ * instance share its pages, and the covariance block is used in place without
+ * being parsed or copied. Only the tickers and the expected returns are copied
+ * out of it.
+ *
+ * @param instance_filename The path to the binary instance file.
+ *
+ * @throws std::runtime_error If the file cannot be mapped, is not a binary
+ * instance file of the current version, is truncated, or fails its checksum.
+ */
+Instance::Instance(const std::string &instance_filename)
+    : num_assets(0),
+      tickers(),
+      expected_returns(),
+      covariance_storage(Covariance_Storage::DENSE),
+      covariance_stride(0),
+      num_factors(0),
+      covariance_data(),
+      senses({NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE,
+              NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE}) {
+  const std::shared_ptr<const Mapped_File> file =
+      std::make_shared<const Mapped_File>(instance_filename);
+  Binary_File_Header header;
+
+  if (file->size < sizeof(header)) {
+    throw std::runtime_error("Instance file is truncated");
+  }
+
+  std::memcpy(&header, file->first, sizeof(header));
+
+  if (std::memcmp(header.magic, binary_file_magic, sizeof(header.magic)) !=
+      0) {
+    throw std::runtime_error("Not a binary instance file");
+  }
+
+  if (header.byte_order != binary_file_byte_order) {
+    throw std::runtime_error("Instance file has another byte order");
+  }
+
+  if (header.version != Instance::binary_file_version) {
+    throw std::runtime_error("Unsupported instance file version");
+  }
+
+  if (header.file_size != file->size) {
+    throw std::runtime_error("Instance file is truncated");
+  }
+
+  if (header.tickers_offset < sizeof(header) ||
+      header.tickers_offset + header.tickers_size >
+          header.expected_returns_offset ||
+      header.expected_returns_offset % sizeof(double) != 0 ||
+      header.expected_returns_offset +
+              std::uint64_t(header.num_assets) * sizeof(double) >
+          header.covariance_offset ||
+      header.covariance_offset % Instance::covariance_alignment != 0 ||
+      header.covariance_offset + header.covariance_size * sizeof(double) >
+          header.file_size ||
+      header.covariance_storage > std::uint32_t(Covariance_Storage::FACTOR)) {
+    throw std::runtime_error("Instance file has inconsistent sections");
+  }
+
+  if (binary_file_checksum(file->first + sizeof(header),
+                           file->size - sizeof(header)) != header.checksum) {
+    throw std::runtime_error("Instance file fails its checksum");
+  }
+
+  const char *table =
+      reinterpret_cast<const char *>(file->first + header.tickers_offset);
+  const char *table_end = table + header.tickers_size;
+
+  while (table < table_end) {
+    const char *name_end = std::find(table, table_end, '\0');
+    this->tickers.emplace_back(table, name_end);
+    table = name_end + 1;
+  }
+
+  const double *expected_returns = reinterpret_cast<const double *>(
+      file->first + header.expected_returns_offset);
+
+  this->num_assets = header.num_assets;
+  this->expected_returns.assign(expected_returns,
+                                expected_returns + header.num_assets);
+  this->covariance_storage =
+      static_cast<Covariance_Storage>(header.covariance_storage);
+  this->covariance_stride = header.covariance_stride;
+  this->num_factors = header.num_factors;
+  this->covariance_data.view(
+      reinterpret_cast<const double *>(file->first + header.covariance_offset),
+      header.covariance_size, file);
+
+  if (!this->is_valid()) {
+    throw std::runtime_error("Instance file holds an invalid instance");
+  }
 }
 
 /**
@@ -135,14 +592,20 @@ Instance::Instance(const Instance &instance) = default;
  * - num_assets is set to 0.
  * - tickers is initialized as an empty container.
  * - expected_returns is initialized as an empty container.
- * - covariance_matrix is initialized as an empty container.
+ * - covariance_storage is set to DENSE.
+ * - covariance_stride is set to 0.
+ * - num_factors is set to 0.
+ * - covariance_data is initialized as an empty container.
  * - senses is initialized as an empty container.
  */
 Instance::Instance()
     : num_assets(0),
       tickers(),
       expected_returns(),
-      covariance_matrix(),
+      covariance_storage(Covariance_Storage::DENSE),
+      covariance_stride(0),
+      num_factors(0),
+      covariance_data(),
       senses() {}
 
 /**
@@ -160,7 +623,10 @@ Instance &Instance::operator=(const Instance &instance) {
     this->num_assets = instance.num_assets;
     this->tickers = instance.tickers;
     this->expected_returns = instance.expected_returns;
-    this->covariance_matrix = instance.covariance_matrix;
+    this->covariance_storage = instance.covariance_storage;
+    this->covariance_stride = instance.covariance_stride;
+    this->num_factors = instance.num_factors;
+    this->covariance_data = instance.covariance_data;
     this->senses = instance.senses;
   }
 
@@ -176,10 +642,14 @@ Instance &Instance::operator=(const Instance &instance) {
  * - The size of the `tickers` vector must be equal to the number of assets.
  * - The size of the `expected_returns` vector must be equal to the number of
  * assets.
- * - The size of the `covariance_matrix` vector must be equal to the number of
- * assets.
- * - Each row in the `covariance_matrix` must have a size equal to the number of
- * assets.
+ * - When dense, the covariance row stride must be at least the number of assets
+ * and the size of the `covariance_data` vector must be equal to the number of
+ * assets times the covariance row stride.
+ * - When packed, the size of the `covariance_data` vector must be equal to the
+ * number of entries of the upper triangle of the covariance matrix.
+ * - When a factor model, the covariance row stride must be at least the number
+ * of assets and the size of the `covariance_data` vector must be equal to
+ * num_factors + 1 times the covariance row stride.
  * - The size of the `senses` vector must be equal to 4.
  *
  * @return true if all conditions are met, false otherwise.
@@ -201,15 +671,29 @@ bool Instance::is_valid() const {
     return false;
   }
 
-  if (this->covariance_matrix.size() != this->num_assets) {
-    std::cout << "this->covariance_matrix.size() != this->num_assets"
-              << std::endl;
-    return false;
-  }
+  if (this->covariance_storage == Covariance_Storage::PACKED) {
+    if (this->covariance_data.size() != this->packed_offset(this->num_assets)) {
+      std::cout << "this->covariance_data.size() != "
+                   "this->packed_offset(this->num_assets)"
+                << std::endl;
+      return false;
+    }
+  } else {
+    const unsigned num_rows =
+        this->covariance_storage == Covariance_Storage::FACTOR
+            ? this->num_factors + 1
+            : this->num_assets;
+
+    if (this->covariance_stride < this->num_assets) {
+      std::cout << "this->covariance_stride < this->num_assets" << std::endl;
+      return false;
+    }
 
-  for (const auto &row : this->covariance_matrix) {
-    if (row.size() != this->num_assets) {
-      std::cout << "row.size() != this->num_assets" << std::endl;
+    if (this->covariance_data.size() !=
+        std::size_t(num_rows) * this->covariance_stride) {
+      std::cout << "this->covariance_data.size() != num_rows * "
+                   "this->covariance_stride"
+                << std::endl;
       return false;
     }
   }
@@ -222,6 +706,154 @@ bool Instance::is_valid() const {
   return true;
 }
 
+/**
+ * @brief Writes the instance to a binary instance file.
+ *
+ * The file holds a fixed-size header, the tickers table, the expected returns
+ * and the covariance block in its current storage, each section starting on a
+ * covariance_alignment-byte boundary, followed by nothing else. The header
+ * records the format version, the dimensions, the offset and size of every
+ * section, and a checksum of everything after it. The numbers are written in
+ * the byte order of the running machine.
+ *
+ * @param instance_filename The path to the binary instance file.
+ *
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void Instance::write_binary_file(const std::string &instance_filename) const {
+  Binary_File_Header header = {};
+  std::string table;
+
+  for (const std::string &ticker : this->tickers) {
+    table += ticker;
+    table.push_back('\0');
+  }
+
+  std::memcpy(header.magic, binary_file_magic, sizeof(header.magic));
+  header.version = Instance::binary_file_version;
+  header.byte_order = binary_file_byte_order;
+  header.num_assets = this->num_assets;
+  header.num_factors = this->num_factors;
+  header.covariance_storage = std::uint32_t(this->covariance_storage);
+  header.covariance_stride = this->covariance_stride;
+  header.tickers_offset = aligned_offset(sizeof(header));
+  header.tickers_size = table.size();
+  header.expected_returns_offset =
+      aligned_offset(header.tickers_offset + header.tickers_size);
+  header.covariance_offset =
+      aligned_offset(header.expected_returns_offset +
+                     std::uint64_t(this->num_assets) * sizeof(double));
+  header.covariance_size = this->covariance_data.size();
+  header.file_size = aligned_offset(header.covariance_offset +
+                                    header.covariance_size * sizeof(double));
+
+  std::vector<unsigned char> body(header.file_size - sizeof(header), 0);
+  std::memcpy(body.data() + header.tickers_offset - sizeof(header),
+              table.data(), table.size());
+  std::memcpy(body.data() + header.expected_returns_offset - sizeof(header),
+              this->expected_returns.data(),
+              this->expected_returns.size() * sizeof(double));
+  std::memcpy(body.data() + header.covariance_offset - sizeof(header),
+              this->covariance_data.data(),
+              this->covariance_data.size() * sizeof(double));
+  header.checksum = binary_file_checksum(body.data(), body.size());
+
+  std::ofstream file(instance_filename, std::ios::binary | std::ios::trunc);
+
+  if (!file.is_open()) {
+    throw std::runtime_error("Unable to open instance file");
+  }
+
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char *>(body.data()), body.size());
+  file.close();
+
+  if (file.fail()) {
+    throw std::runtime_error("Error writing instance file");
+  }
+}
+
+/**
+ * @brief Converts the covariance matrix to the given storage, in place.
+ *
+ * A dense matrix is packed from its upper triangle, so it is assumed to be
+ * symmetric, which every covariance matrix is. A factor model is expanded into
+ * a dense matrix first, but a matrix cannot be turned into a factor model.
+ *
+ * @param storage The new layout of the covariance matrix.
+ *
+ * @throws std::runtime_error If storage is FACTOR and the covariance matrix is
+ * not already a factor model.
+ */
+void Instance::set_covariance_storage(Covariance_Storage storage) {
+  if (storage == this->covariance_storage) {
+    return;
+  }
+
+  if (storage == Covariance_Storage::FACTOR) {
+    throw std::runtime_error(
+        "A covariance matrix cannot be converted to a factor model");
+  }
+
+  if (storage == Covariance_Storage::PACKED &&
+      this->covariance_storage == Covariance_Storage::FACTOR) {
+    this->set_covariance_storage(Covariance_Storage::DENSE);
+  }
+
+  Aligned_Buffer<double, covariance_alignment>::Vector data;
+
+  if (storage == Covariance_Storage::PACKED) {
+    data.resize(this->packed_offset(this->num_assets));
+
+    for (unsigned i = 0; i < this->num_assets; i++) {
+      Span<const double> row = this->covariance_row(i);
+      std::copy(row.begin() + i, row.end(),
+                data.begin() + this->packed_offset(i));
+    }
+
+    this->covariance_stride = 0;
+  } else {
+    const unsigned stride = Instance::padded_stride(this->num_assets);
+    data.assign(std::size_t(this->num_assets) * stride, 0.0);
+
+    for (unsigned i = 0; i < this->num_assets; i++) {
+      for (unsigned j = 0; j < this->num_assets; j++) {
+        data[std::size_t(i) * stride + j] = this->covariance(i, j);
+      }
+    }
+
+    this->covariance_stride = stride;
+  }
+
+  this->covariance_data.swap(data);
+  this->covariance_storage = storage;
+  this->num_factors = 0;
+}
+
+/**
+ * @brief Returns a copy of the covariance matrix as a 2D vector.
+ *
+ * This is a compatibility shim for code written against the former nested
+ * vector representation. It allocates one vector per row, so it must not be
+ * used in any evaluation path; use covariance or a view of the current
+ * storage instead.
+ *
+ * @return A 2D vector of doubles representing the covariance matrix.
+ */
+std::vector<std::vector<double>> Instance::covariance_matrix() const {
+  std::vector<std::vector<double>> covariance_matrix(this->num_assets);
+
+  for (unsigned i = 0; i < this->num_assets; i++) {
+    covariance_matrix[i].resize(this->num_assets);
+
+    for (unsigned j = 0; j < this->num_assets; j++) {
+      covariance_matrix[i][j] = this->covariance(i, j);
+    }
+  }
+
+  return covariance_matrix;
+}
+
 /**
  * @brief Overloads the << operator to print the details of an Instance object.
  *
@@ -247,9 +879,9 @@ std::ostream &operator<<(std::ostream &os, const Instance &instance) {
 
   os << "Covariance matrix:" << std::endl;
 
-  for (const auto &row : instance.covariance_matrix) {
-    for (const auto &value : row) {
-      os << value << " ";
+  for (unsigned i = 0; i < instance.num_assets; i++) {
+    for (unsigned j = 0; j < instance.num_assets; j++) {
+      os << instance.covariance(i, j) << " ";
     }
 
     os << std::endl;
@@ -2,13 +2,39 @@
 
 #define NSBRKGA_MULTIPLE_INCLUSIONS
 
-#include <istream>
 #include <ostream>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include "nsbrkga.hpp"
+#include "utils/aligned_buffer.hpp"
+#include "utils/span.hpp"
+#include "utils/text_reader.hpp"
 
 namespace mopop {
+/**
+ * @brief The layouts in which an Instance can store its covariance matrix.
+ */
+enum class Covariance_Storage {
+  /**
+   * @brief Every entry, row-major, with each row padded to a whole number of
+   * covariance_alignment-byte blocks.
+   */
+  DENSE,
+
+  /**
+   * @brief The upper triangle, diagonal included, row-major and unpadded.
+   */
+  PACKED,
+
+  /**
+   * @brief A factor model B F B^T + D, held as the num_factors columns of
+   * B L, with F = L L^T, followed by the diagonal of D, each as a padded row.
+   */
+  FACTOR
+};
+
 /**
  * @class Instance
  * @brief The Instance class represents an instance of the Multi-Objective
@@ -32,9 +58,56 @@ class Instance {
   std::vector<double> expected_returns;
 
   /**
-   * @brief The 2D vector to store the covariance matrix.
+   * @brief The alignment in bytes of the covariance matrix storage and of the
+   * start of each of its dense rows.
+   */
+  static constexpr unsigned covariance_alignment = 64;
+
+  /**
+   * @brief The number of assets from which the loading constructors store the
+   * covariance matrix packed. Below it the dense matrix stays in cache and its
+   * unit-stride rows are the cheaper ones to sweep.
+   */
+  static constexpr unsigned packed_covariance_min_num_assets = 256;
+
+  /**
+   * @brief The version of the binary instance file format written by
+   * write_binary_file, bumped whenever its layout changes.
    */
-  std::vector<std::vector<double>> covariance_matrix;
+  static constexpr unsigned binary_file_version = 1;
+
+  /**
+   * @brief The layout of the covariance matrix in covariance_data.
+   */
+  Covariance_Storage covariance_storage;
+
+  /**
+   * @brief The number of entries between the starts of two consecutive rows of
+   * the dense covariance matrix. It is num_assets rounded up to a whole number
+   * of covariance_alignment-byte blocks, or 0 when the matrix is packed.
+   */
+  unsigned covariance_stride;
+
+  /**
+   * @brief The number of factors of the factor model, or 0 when the matrix is
+   * dense or packed.
+   */
+  unsigned num_factors;
+
+  /**
+   * @brief The covariance matrix, in a single aligned block.
+   *
+   * When dense, it holds num_assets rows of covariance_stride entries each,
+   * whose entries past num_assets are padding kept at zero. When packed, it
+   * holds the num_assets * (num_assets + 1) / 2 entries of the upper triangle,
+   * row i starting at packed_offset(i) with its diagonal entry. When a factor
+   * model, it holds num_factors + 1 rows of covariance_stride entries: the
+   * exposures of the assets to each factor, scaled so that the factors are
+   * uncorrelated with unit variance, and then the idiosyncratic variances.
+   * An instance loaded from a binary instance file views the block of the
+   * mapped file instead of owning a copy.
+   */
+  Aligned_Buffer<double, covariance_alignment> covariance_data;
 
   /**
    * @brief The vector that holds the senses for the optimization algorithm.
@@ -42,11 +115,92 @@ class Instance {
   std::vector<NSBRKGA::Sense> senses;
 
  private:
+  /**
+   * @brief Checks that the covariance matrix is stored in a given layout,
+   * before a view of that layout is handed out.
+   *
+   * @param storage The layout the view is read in.
+   *
+   * @throws std::runtime_error If covariance_storage is not storage.
+   */
+  void check_covariance_storage(Covariance_Storage storage) const {
+    if (this->covariance_storage != storage) {
+      throw std::runtime_error(
+          "Covariance matrix is not stored in the requested layout");
+    }
+  }
+
+  /**
+   * @brief Returns the row stride of a covariance matrix with the given number
+   * of assets.
+   *
+   * @param num_assets The number of assets.
+   * @return num_assets rounded up to a multiple of the number of doubles in
+   * covariance_alignment bytes.
+   */
+  static unsigned padded_stride(unsigned num_assets);
+
+  /**
+   * @brief Copies a covariance matrix into the aligned row-major storage.
+   *
+   * @param covariance_matrix A 2D vector of doubles representing the covariance
+   * matrix of the assets.
+   */
+  void set_covariance_matrix(
+      const std::vector<std::vector<double>>& covariance_matrix);
+
+  /**
+   * @brief Returns the covariance storage the loading constructors pick for a
+   * given number of assets.
+   *
+   * @param num_assets The number of assets.
+   * @return PACKED from packed_covariance_min_num_assets assets on, DENSE
+   * otherwise.
+   */
+  static Covariance_Storage default_covariance_storage(unsigned num_assets);
+
+  /**
+   * @brief Stores a factor model of the covariance matrix.
+   *
+   * The factor covariance matrix F is factored as L L^T and folded into the
+   * loadings, so that the variance of a portfolio is a sum of squared
+   * exposures plus its idiosyncratic variance.
+   *
+   * @param factor_loadings The num_assets x num_factors loadings B.
+   * @param factor_covariance The num_factors x num_factors covariance matrix F
+   * of the factors.
+   * @param idiosyncratic_variances The num_assets diagonal entries of D.
+   *
+   * @throws std::runtime_error If the dimensions do not match or F is not
+   * positive semidefinite.
+   */
+  void set_factor_model(
+      const std::vector<std::vector<double>>& factor_loadings,
+      const std::vector<std::vector<double>>& factor_covariance,
+      const std::vector<double>& idiosyncratic_variances);
+
+  /**
+   * @brief Loads a factor model from the rows of a factor model file that
+   * follow its header.
+   *
+   * @param file The factor model file, positioned after the header.
+   * @param num_factors The number of factors named in the header.
+   *
+   * @throws std::runtime_error If the file does not hold num_factors rows of
+   * factor covariances followed by one row of loadings and idiosyncratic
+   * variance per asset.
+   */
+  void load_factor_model(Text_Reader& file, unsigned num_factors);
+
   /**
    * @brief Loads the instance data from the given files.
    *
    * This function reads the expected returns and covariance matrix from the
-   * specified files and populates the corresponding member variables.
+   * specified files and populates the corresponding member variables. A
+   * covariance file whose header ends with an Idiosyncratic column holds a
+   * factor model instead of a matrix: one row per factor with the factor
+   * covariances, then one row per asset with its loadings and its
+   * idiosyncratic variance.
    *
    * @param expected_returns_filename The path to the file containing the
    * expected returns.
@@ -54,7 +208,8 @@ class Instance {
    * matrix.
    *
    * @throws std::runtime_error If either the expected returns file or the
-   * covariance file cannot be opened.
+   * covariance file cannot be opened, or if the covariance matrix is not a
+   * square matrix over the assets of the expected returns file.
    */
   void load_instance(const std::string& expected_returns_filename,
                      const std::string& covariance_filename);
@@ -64,6 +219,8 @@ class Instance {
    * @brief Constructs an Instance object with the given tickers, expected
    * returns, and covariance matrix.
    *
+   * The covariance storage is picked by default_covariance_storage.
+   *
    * @param tickers A vector of strings representing the asset tickers.
    * @param expected_returns A vector of doubles representing the expected
    * returns for each asset.
@@ -74,12 +231,31 @@ class Instance {
            const std::vector<double>& expected_returns,
            const std::vector<std::vector<double>>& covariance_matrix);
 
+  /**
+   * @brief Constructs an Instance object with the given tickers, expected
+   * returns, and factor model of the covariance matrix B F B^T + D.
+   *
+   * @param tickers A vector of strings representing the asset tickers.
+   * @param expected_returns A vector of doubles representing the expected
+   * returns for each asset.
+   * @param factor_loadings The num_assets x num_factors loadings B.
+   * @param factor_covariance The num_factors x num_factors covariance matrix F
+   * of the factors.
+   * @param idiosyncratic_variances The num_assets diagonal entries of D.
+   */
+  Instance(const std::vector<std::string>& tickers,
+           const std::vector<double>& expected_returns,
+           const std::vector<std::vector<double>>& factor_loadings,
+           const std::vector<std::vector<double>>& factor_covariance,
+           const std::vector<double>& idiosyncratic_variances);
+
   /**
    * @brief Constructs an Instance object and initializes its data members.
    *
    * This constructor initializes the number of assets, tickers, expected
    * returns, covariance matrix, and senses. It then loads the instance data
-   * from the specified files.
+   * from the specified files and, unless they hold a factor model, picks the
+   * covariance storage with default_covariance_storage.
    *
    * @param returns_filename The filename containing the expected returns data.
    * @param covariance_filename The filename containing the covariance matrix
@@ -88,6 +264,23 @@ class Instance {
   Instance(const std::string& expected_returns_filename,
            const std::string& covariance_filename);
 
+  /**
+   * @brief Constructs an Instance object by memory-mapping a binary instance
+   * file written by write_binary_file.
+   *
+   * The file is mapped read-only and shared, so the processes that load the
+   * same instance share its pages, and the covariance block is used in place
+   * without being parsed or copied. Only the tickers and the expected returns
+   * are copied out of it.
+   *
+   * @param instance_filename The path to the binary instance file.
+   *
+   * @throws std::runtime_error If the file cannot be mapped, is not a binary
+   * instance file of the current version, is truncated, or fails its
+   * checksum.
+   */
+  explicit Instance(const std::string& instance_filename);
+
   /**
    * @brief Copy constructor for the Instance class.
    *
@@ -105,7 +298,10 @@ class Instance {
    * - num_assets is set to 0.
    * - tickers is initialized as an empty container.
    * - expected_returns is initialized as an empty container.
-   * - covariance_matrix is initialized as an empty container.
+   * - covariance_storage is set to DENSE.
+   * - covariance_stride is set to 0.
+   * - num_factors is set to 0.
+   * - covariance_data is initialized as an empty container.
    * - senses is initialized as an empty container.
    */
   Instance();
@@ -131,16 +327,172 @@ class Instance {
    * - The size of the `tickers` vector must be equal to the number of assets.
    * - The size of the `expected_returns` vector must be equal to the number of
    * assets.
-   * - The size of the `covariance_matrix` vector must be equal to the number of
-   * assets.
-   * - Each row in the `covariance_matrix` must have a size equal to the number
-   * of assets.
+   * - When dense, the covariance row stride must be at least the number of
+   * assets and the size of the `covariance_data` vector must be equal to the
+   * number of assets times the covariance row stride.
+   * - When packed, the size of the `covariance_data` vector must be equal to
+   * the number of entries of the upper triangle of the covariance matrix.
+   * - When a factor model, the covariance row stride must be at least the
+   * number of assets and the size of the `covariance_data` vector must be
+   * equal to num_factors + 1 times the covariance row stride.
    * - The size of the `senses` vector must be equal to 4.
    *
    * @return true if all conditions are met, false otherwise.
    */
   bool is_valid() const;
 
+  /**
+   * @brief Writes the instance to a binary instance file.
+   *
+   * The file holds a fixed-size header, the tickers table, the expected
+   * returns and the covariance block in its current storage, each section
+   * starting on a covariance_alignment-byte boundary, followed by nothing
+   * else. The header records the format version, the dimensions, the offset
+   * and size of every section, and a checksum of everything after it. The
+   * numbers are written in the byte order of the running machine.
+   *
+   * @param instance_filename The path to the binary instance file.
+   *
+   * @throws std::runtime_error If the file cannot be written.
+   */
+  void write_binary_file(const std::string& instance_filename) const;
+
+  /**
+   * @brief Converts the covariance matrix to the given storage, in place.
+   *
+   * A factor model can be expanded into a dense or packed matrix, but a matrix
+   * cannot be turned into a factor model.
+   *
+   * @param storage The new layout of the covariance matrix.
+   *
+   * @throws std::runtime_error If storage is FACTOR and the covariance matrix
+   * is not already a factor model.
+   */
+  void set_covariance_storage(Covariance_Storage storage);
+
+  /**
+   * @brief Returns a view of a row of the dense covariance matrix.
+   *
+   * The view starts on a covariance_alignment-byte boundary and spans the
+   * num_assets entries of the row, without the padding. Code that does not
+   * know the storage reads the entries through covariance instead.
+   *
+   * @param i The index of the row.
+   * @return A view of the i-th row of the covariance matrix.
+   *
+   * @throws std::runtime_error If covariance_storage is not DENSE.
+   */
+  Span<const double> covariance_row(unsigned i) const {
+    this->check_covariance_storage(Covariance_Storage::DENSE);
+
+    return Span<const double>(
+        this->covariance_data.data() + std::size_t(i) * this->covariance_stride,
+        this->num_assets);
+  }
+
+  /**
+   * @brief Returns the position in covariance_data of the diagonal entry of a
+   * row of the packed covariance matrix.
+   *
+   * @param i The index of the row.
+   * @return The number of upper triangle entries in the rows before i.
+   */
+  std::size_t packed_offset(unsigned i) const {
+    return (std::size_t(i) * (2 * std::size_t(this->num_assets) - i + 1)) / 2;
+  }
+
+  /**
+   * @brief Returns a view of the upper triangle part of a row of the packed
+   * covariance matrix.
+   *
+   * The view spans the num_assets - i entries of the row from its diagonal
+   * entry on.
+   *
+   * @param i The index of the row.
+   * @return A view of the entries (i, i), ..., (i, num_assets - 1).
+   *
+   * @throws std::runtime_error If covariance_storage is not PACKED.
+   */
+  Span<const double> packed_covariance_row(unsigned i) const {
+    this->check_covariance_storage(Covariance_Storage::PACKED);
+
+    return Span<const double>(
+        this->covariance_data.data() + this->packed_offset(i),
+        this->num_assets - i);
+  }
+
+  /**
+   * @brief Returns a view of the scaled exposures of the assets to a factor.
+   *
+   * @param f The index of the factor.
+   * @return A view of the num_assets exposures to the f-th factor.
+   *
+   * @throws std::runtime_error If covariance_storage is not FACTOR.
+   */
+  Span<const double> factor_exposures(unsigned f) const {
+    this->check_covariance_storage(Covariance_Storage::FACTOR);
+
+    return Span<const double>(
+        this->covariance_data.data() + std::size_t(f) * this->covariance_stride,
+        this->num_assets);
+  }
+
+  /**
+   * @brief Returns a view of the idiosyncratic variances of the assets.
+   *
+   * @return A view of the num_assets diagonal entries of D.
+   *
+   * @throws std::runtime_error If covariance_storage is not FACTOR.
+   */
+  Span<const double> idiosyncratic_variances() const {
+    return this->factor_exposures(this->num_factors);
+  }
+
+  /**
+   * @brief Returns an entry of the covariance matrix, whatever its storage.
+   *
+   * With a factor model the entry is computed from the exposures, in
+   * O(num_factors) operations.
+   *
+   * @param i The index of the row.
+   * @param j The index of the column.
+   * @return The covariance between the i-th and the j-th assets.
+   */
+  double covariance(unsigned i, unsigned j) const {
+    if (this->covariance_storage == Covariance_Storage::FACTOR) {
+      double result = i == j ? this->idiosyncratic_variances()[i] : 0.0;
+
+      for (unsigned f = 0; f < this->num_factors; f++) {
+        const double* exposures = this->factor_exposures(f).data();
+        result += exposures[i] * exposures[j];
+      }
+
+      return result;
+    }
+
+    if (this->covariance_storage == Covariance_Storage::PACKED) {
+      if (i > j) {
+        std::swap(i, j);
+      }
+
+      return this->covariance_data[this->packed_offset(i) + (j - i)];
+    }
+
+    return this->covariance_data[std::size_t(i) * this->covariance_stride + j];
+  }
+
+  /**
+   * @brief Returns a copy of the covariance matrix as a 2D vector.
+   *
+   * This is a compatibility shim for code written against the former nested
+   * vector representation. It allocates one vector per row, so it must not be
+   * used in any evaluation path; use covariance or a view of the current
+   * storage instead.
+   *
+   * @return A 2D vector of doubles representing the covariance matrix.
+   */
+  std::vector<std::vector<double>> covariance_matrix() const;
+
   /**
    * @brief Overloads the << operator to print the details of an Instance
    * object.
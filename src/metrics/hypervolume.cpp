@@ -0,0 +1,310 @@
+#include "metrics/hypervolume.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace mopop {
+/**
+ * @brief Adds a point to a two-dimensional staircase, removing the points it
+ * dominates.
+ *
+ * The staircase is sorted by increasing first coordinate, and so by decreasing
+ * second coordinate. The area the point adds lies above it and below the lower
+ * envelope of the staircase, from its own first coordinate to that of the
+ * first point of the staircase it does not dominate.
+ *
+ * @param staircase The staircase, sorted by increasing first coordinate.
+ * @param x The first coordinate of the point.
+ * @param y The second coordinate of the point.
+ * @param reference_x The first coordinate of the reference point.
+ * @param reference_y The second coordinate of the reference point.
+ * @return The area the point adds to the staircase.
+ */
+double Hypervolume::add_to_staircase(
+    std::vector<std::pair<double, double>>& staircase, double x, double y,
+    double reference_x, double reference_y) {
+  auto it = std::lower_bound(
+      staircase.begin(), staircase.end(), x,
+      [](const std::pair<double, double>& step, double value) {
+        return step.first < value;
+      });
+  double height = reference_y;
+
+  if (it != staircase.begin()) {
+    height = std::prev(it)->second;
+
+    if (height <= y) {
+      return 0.0;
+    }
+  }
+
+  if (it != staircase.end() && it->first == x && it->second <= y) {
+    return 0.0;
+  }
+
+  const auto first_dominated = it;
+  double area = 0.0, left = x;
+
+  for (; it != staircase.end() && it->second >= y; it++) {
+    area += (it->first - left) * (height - y);
+    left = it->first;
+    height = it->second;
+  }
+
+  area += ((it == staircase.end() ? reference_x : it->first) - left) *
+          (height - y);
+
+  if (first_dominated == it) {
+    staircase.emplace(it, x, y);
+  } else {
+    *first_dominated = std::make_pair(x, y);
+    staircase.erase(std::next(first_dominated), it);
+  }
+
+  return area;
+}
+
+/**
+ * @brief Computes the exclusive contribution of a point to the volume of a
+ * three-dimensional front, on the first three objectives.
+ *
+ * The points of the front are projected onto the first two objectives and
+ * clipped to the box of the point, in increasing order of the third objective.
+ * Between two consecutive values of the third objective, the contribution grows
+ * by the area of the box the staircase leaves uncovered.
+ *
+ * @param point The point.
+ * @param front The front, sorted by increasing third objective.
+ * @param staircase A scratch staircase.
+ * @param is_dominated Whether some point of the front dominates the point,
+ * written by the function.
+ * @return The contribution.
+ */
+double Hypervolume::slice_contribution(
+    const Point& point, const std::vector<Point>& front,
+    std::vector<std::pair<double, double>>& staircase,
+    bool& is_dominated) const {
+  const double reference_x = this->reference_point[0],
+               reference_y = this->reference_point[1];
+  double uncovered_area =
+      (reference_x - point[0]) * (reference_y - point[1]);
+  double volume = 0.0, z = point[2];
+  std::size_t i = 0;
+
+  staircase.clear();
+  is_dominated = false;
+
+  for (; i < front.size() && front[i][2] <= point[2]; i++) {
+    if (front[i][0] <= point[0] && front[i][1] <= point[1]) {
+      is_dominated = true;
+      return 0.0;
+    }
+
+    uncovered_area -= Hypervolume::add_to_staircase(
+        staircase, std::max(front[i][0], point[0]),
+        std::max(front[i][1], point[1]), reference_x, reference_y);
+  }
+
+  for (; i < front.size(); i++) {
+    volume += uncovered_area * (front[i][2] - z);
+    z = front[i][2];
+
+    // From here on the box of the point is covered.
+    if (front[i][0] <= point[0] && front[i][1] <= point[1]) {
+      return volume;
+    }
+
+    uncovered_area -= Hypervolume::add_to_staircase(
+        staircase, std::max(front[i][0], point[0]),
+        std::max(front[i][1], point[1]), reference_x, reference_y);
+  }
+
+  return volume + uncovered_area * (this->reference_point[2] - z);
+}
+
+/**
+ * @brief Computes the hypervolume of points strictly better than the reference
+ * point on every objective.
+ *
+ * @param points The points, sorted by the function.
+ * @return The hypervolume.
+ */
+double Hypervolume::sweep(std::vector<Point>& points) const {
+  std::sort(points.begin(), points.end(), [](const Point& a, const Point& b) {
+    return a[3] < b[3];
+  });
+
+  // The three-dimensional front of the points swept so far, sorted by the
+  // third objective.
+  std::vector<Point> swept;
+  std::vector<std::pair<double, double>> staircase;
+  double hypervolume = 0.0;
+
+  for (const Point& point : points) {
+    bool is_dominated;
+    double volume = this->slice_contribution(point, swept, staircase,
+                                             is_dominated);
+
+    if (is_dominated) {
+      continue;
+    }
+
+    hypervolume += volume * (this->reference_point[3] - point[3]);
+
+    // The points the new one dominates on the first three objectives no longer
+    // bound any contribution.
+    swept.erase(std::remove_if(swept.begin(), swept.end(),
+                               [&](const Point& other) {
+                                 return other[0] >= point[0] &&
+                                        other[1] >= point[1] &&
+                                        other[2] >= point[2];
+                               }),
+                swept.end());
+    swept.insert(std::upper_bound(swept.begin(), swept.end(), point,
+                                  [](const Point& a, const Point& b) {
+                                    return a[2] < b[2];
+                                  }),
+                 point);
+  }
+
+  return hypervolume;
+}
+
+/**
+ * @brief Constructs a new hypervolume engine.
+ *
+ * @param senses The optimisation senses.
+ * @param reference_point The reference point.
+ *
+ * @throws std::runtime_error If there are not num_objectives senses and
+ * reference values.
+ */
+Hypervolume::Hypervolume(const std::vector<NSBRKGA::Sense>& senses,
+                         const std::vector<double>& reference_point)
+    : senses(senses) {
+  if (senses.size() != num_objectives ||
+      reference_point.size() != num_objectives) {
+    throw std::runtime_error("The hypervolume engine needs " +
+                             std::to_string(num_objectives) + " objectives.");
+  }
+
+  this->reference_point = to_objective_point(reference_point, this->senses);
+}
+
+/**
+ * @brief Computes the hypervolume of a front. The points need not be mutually
+ * non-dominated, and those not strictly better than the reference point on
+ * every objective contribute nothing.
+ *
+ * @param front The front.
+ * @return The hypervolume, or zero if the front is empty.
+ */
+double Hypervolume::compute(
+    const std::vector<std::vector<double>>& front) const {
+  std::vector<Point> points;
+
+  points.reserve(front.size());
+
+  for (const std::vector<double>& value : front) {
+    const Point point = to_objective_point(value, this->senses);
+    bool is_inside = true;
+
+    for (unsigned i = 0; i < num_objectives; i++) {
+      if (point[i] >= this->reference_point[i]) {
+        is_inside = false;
+      }
+    }
+
+    if (is_inside) {
+      points.push_back(point);
+    }
+  }
+
+  return this->sweep(points);
+}
+
+/**
+ * @brief Computes the exclusive contribution of a point to the hypervolume of
+ * a front, that is, the hypervolume the front gains by adding the point.
+ *
+ * The front is clipped to the box between the point and the reference point,
+ * and the contribution is the volume of the box minus the hypervolume of the
+ * clipped front. Only the points of the front that are close to the point
+ * leave anything non-dominated in the box, so that is usually much cheaper
+ * than the hypervolume of the whole front.
+ *
+ * @param value The objective values of the point.
+ * @param front The front, which may or may not contain the point.
+ * @return The contribution, which is zero if the point is already covered by
+ * the front or is not strictly better than the reference point.
+ */
+double Hypervolume::contribution(
+    const std::vector<double>& value,
+    const std::vector<std::vector<double>>& front) const {
+  const Point point = to_objective_point(value, this->senses);
+  double volume = 1.0;
+
+  for (unsigned i = 0; i < num_objectives; i++) {
+    if (point[i] >= this->reference_point[i]) {
+      return 0.0;
+    }
+
+    volume *= this->reference_point[i] - point[i];
+  }
+
+  // A clipped point that is worse than the point on a single objective is
+  // the point moved along that objective, and it dominates every clipped point
+  // at least as far along it. Only the closest one along each objective is
+  // kept, and it bounds the others.
+  std::vector<Point> clipped;
+  Point bounds = this->reference_point;
+
+  for (const std::vector<double>& other_value : front) {
+    Point other = to_objective_point(other_value, this->senses);
+    unsigned num_worse = 0, worse = 0;
+
+    for (unsigned i = 0; i < num_objectives; i++) {
+      if (other[i] > point[i]) {
+        num_worse++;
+        worse = i;
+      } else {
+        other[i] = point[i];
+      }
+    }
+
+    if (num_worse == 0) {
+      return 0.0;
+    }
+
+    if (num_worse == 1) {
+      bounds[worse] = std::min(bounds[worse], other[worse]);
+    } else {
+      clipped.push_back(other);
+    }
+  }
+
+  clipped.erase(std::remove_if(clipped.begin(), clipped.end(),
+                               [&](const Point& other) {
+                                 for (unsigned i = 0; i < num_objectives;
+                                      i++) {
+                                   if (other[i] >= bounds[i]) {
+                                     return true;
+                                   }
+                                 }
+
+                                 return false;
+                               }),
+                clipped.end());
+
+  for (unsigned i = 0; i < num_objectives; i++) {
+    if (bounds[i] < this->reference_point[i]) {
+      clipped.push_back(point);
+      clipped.back()[i] = bounds[i];
+    }
+  }
+
+  return std::max(volume - this->sweep(clipped), 0.0);
+}
+
+}  // namespace mopop
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "nsbrkga.hpp"
+#include "solution/objective_point.hpp"
+
+namespace mopop {
+/**
+ * @class Hypervolume
+ * @brief Computes the hypervolume of fronts of four objectives with respect to
+ * a reference point.
+ *
+ * The points are swept in increasing order of the fourth objective, all
+ * objectives taken as minimised. Each point adds the volume of the slab between
+ * its fourth objective and the reference point times its exclusive
+ * contribution to the three-dimensional front of the points swept before it.
+ * That contribution is computed by a sweep over the third objective, which
+ * keeps the two-dimensional staircase of the earlier points clipped to the box
+ * of the point. The whole computation takes O(n^2) time in practice for a
+ * front of n points.
+ */
+class Hypervolume {
+ public:
+  /**
+   * @brief The number of objectives the engine is specialised for.
+   */
+  static constexpr unsigned num_objectives = 4;
+
+ private:
+  /**
+   * @brief The objective values of a point, all to be minimised.
+   */
+  typedef Objective_Point Point;
+
+  /**
+   * @brief The optimisation senses.
+   */
+  std::vector<NSBRKGA::Sense> senses;
+
+  /**
+   * @brief The reference point, with every objective to be minimised.
+   */
+  Point reference_point;
+
+  /**
+   * @brief Adds a point to a two-dimensional staircase, removing the points it
+   * dominates.
+   *
+   * @param staircase The staircase, sorted by increasing first coordinate.
+   * @param x The first coordinate of the point.
+   * @param y The second coordinate of the point.
+   * @param reference_x The first coordinate of the reference point.
+   * @param reference_y The second coordinate of the reference point.
+   * @return The area the point adds to the staircase.
+   */
+  static double add_to_staircase(
+      std::vector<std::pair<double, double>>& staircase, double x, double y,
+      double reference_x, double reference_y);
+
+  /**
+   * @brief Computes the exclusive contribution of a point to the volume of a
+   * three-dimensional front, on the first three objectives.
+   *
+   * @param point The point.
+   * @param front The front, sorted by increasing third objective.
+   * @param staircase A scratch staircase.
+   * @param is_dominated Whether some point of the front dominates the point,
+   * written by the function.
+   * @return The contribution.
+   */
+  double slice_contribution(
+      const Point& point, const std::vector<Point>& front,
+      std::vector<std::pair<double, double>>& staircase,
+      bool& is_dominated) const;
+
+  /**
+   * @brief Computes the hypervolume of points strictly better than the
+   * reference point on every objective.
+   *
+   * @param points The points, sorted by the function.
+   * @return The hypervolume.
+   */
+  double sweep(std::vector<Point>& points) const;
+
+ public:
+  /**
+   * @brief Constructs a new hypervolume engine.
+   *
+   * @param senses The optimisation senses.
+   * @param reference_point The reference point.
+   *
+   * @throws std::runtime_error If there are not num_objectives senses and
+   * reference values.
+   */
+  Hypervolume(const std::vector<NSBRKGA::Sense>& senses,
+              const std::vector<double>& reference_point);
+
+  /**
+   * @brief Computes the hypervolume of a front. The points need not be
+   * mutually non-dominated, and those not strictly better than the reference
+   * point on every objective contribute nothing.
+   *
+   * @param front The front.
+   * @return The hypervolume, or zero if the front is empty.
+   */
+  double compute(const std::vector<std::vector<double>>& front) const;
+
+  /**
+   * @brief Computes the exclusive contribution of a point to the hypervolume
+   * of a front, that is, the hypervolume the front gains by adding the point.
+   *
+   * @param value The objective values of the point.
+   * @param front The front, which may or may not contain the point.
+   * @return The contribution, which is zero if the point is already covered by
+   * the front or is not strictly better than the reference point.
+   */
+  double contribution(const std::vector<double>& value,
+                      const std::vector<std::vector<double>>& front) const;
+};
+
+}  // namespace mopop
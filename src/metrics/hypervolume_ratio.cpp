@@ -0,0 +1,33 @@
+#include "metrics/hypervolume_ratio.hpp"
+
+namespace mopop {
+/**
+ * @brief Constructs a new hypervolume ratio.
+ *
+ * @param senses The optimisation senses.
+ * @param reference_point The reference point.
+ * @param reference_front The reference front.
+ *
+ * @throws std::runtime_error If there are not Hypervolume::num_objectives
+ * senses and reference values.
+ */
+Hypervolume_Ratio::Hypervolume_Ratio(
+    const std::vector<NSBRKGA::Sense>& senses,
+    const std::vector<double>& reference_point,
+    const std::vector<std::vector<double>>& reference_front)
+    : engine(senses, reference_point),
+      reference_hypervolume(this->engine.compute(reference_front)) {}
+
+/**
+ * @brief Computes the hypervolume ratio of a front.
+ *
+ * @param front The front.
+ * @return The hypervolume of the front divided by the hypervolume of the
+ * reference front, which is zero if the front is empty.
+ */
+double Hypervolume_Ratio::compute(
+    const std::vector<std::vector<double>>& front) const {
+  return this->engine.compute(front) / this->reference_hypervolume;
+}
+
+}  // namespace mopop
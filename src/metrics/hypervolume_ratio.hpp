@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+#include "metrics/hypervolume.hpp"
+
+namespace mopop {
+/**
+ * @class Hypervolume_Ratio
+ * @brief Computes the hypervolume of fronts relative to that of a reference
+ * front.
+ */
+class Hypervolume_Ratio {
+ public:
+  /**
+   * @brief The hypervolume engine.
+   */
+  const Hypervolume engine;
+
+  /**
+   * @brief The hypervolume of the reference front.
+   */
+  const double reference_hypervolume;
+
+  /**
+   * @brief Constructs a new hypervolume ratio.
+   *
+   * @param senses The optimisation senses.
+   * @param reference_point The reference point.
+   * @param reference_front The reference front.
+   *
+   * @throws std::runtime_error If there are not Hypervolume::num_objectives
+   * senses and reference values.
+   */
+  Hypervolume_Ratio(const std::vector<NSBRKGA::Sense>& senses,
+                    const std::vector<double>& reference_point,
+                    const std::vector<std::vector<double>>& reference_front);
+
+  /**
+   * @brief Computes the hypervolume ratio of a front.
+   *
+   * @param front The front.
+   * @return The hypervolume of the front divided by the hypervolume of the
+   * reference front, which is zero if the front is empty.
+   */
+  double compute(const std::vector<std::vector<double>>& front) const;
+};
+
+}  // namespace mopop
@@ -0,0 +1,302 @@
+#include "metrics/igd_plus.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "evaluator/evaluator.hpp"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define MOPOP_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace mopop {
+
+namespace {
+
+/**
+ * @brief Finds the smallest squared modified distance from a reference point
+ * to a range of points, starting from the smallest one found so far. The
+ * objective values of the points lie stride apart.
+ */
+typedef double (*Leaf_Kernel)(const double* points, unsigned stride,
+                              unsigned begin, unsigned end,
+                              const double* reference, double best);
+
+/**
+ * @brief Computes the squared modified distance from a reference point to a
+ * point, charging only the objectives on which the point is worse.
+ */
+inline double squared_distance(const double* value, unsigned stride,
+                               const double* reference) {
+  double distance = 0.0;
+
+  for (unsigned i = 0; i < IGD_Plus::num_objectives; i++) {
+    const double delta =
+        value[i * stride] > reference[i] ? value[i * stride] - reference[i]
+                                         : 0.0;
+    distance += delta * delta;
+  }
+
+  return distance;
+}
+
+double scalar_leaf(const double* points, unsigned stride, unsigned begin,
+                   unsigned end, const double* reference, double best) {
+  for (unsigned j = begin; j < end; j++) {
+    best = std::min(best, squared_distance(points + j, stride, reference));
+  }
+
+  return best;
+}
+
+#ifdef MOPOP_X86_KERNELS
+
+// The compiler must not contract the products and sums into fused operations
+// the scalar formula lacks, so the AVX2 kernel leaves out FMA and the AVX-512
+// one, whose instruction set implies it, turns contraction off.
+
+__attribute__((target("avx2"))) double avx2_leaf(
+    const double* points, unsigned stride, unsigned begin, unsigned end,
+    const double* reference, double best) {
+  const __m256d zero = _mm256_setzero_pd();
+  __m256d minimum = _mm256_set1_pd(best);
+  unsigned j = begin;
+
+  for (; j + 4 <= end; j += 4) {
+    __m256d distance = zero;
+
+    for (unsigned i = 0; i < IGD_Plus::num_objectives; i++) {
+      const __m256d delta =
+          _mm256_max_pd(_mm256_sub_pd(_mm256_loadu_pd(points + i * stride + j),
+                                      _mm256_set1_pd(reference[i])),
+                        zero);
+      distance = _mm256_add_pd(distance, _mm256_mul_pd(delta, delta));
+    }
+
+    minimum = _mm256_min_pd(minimum, distance);
+  }
+
+  alignas(32) double lanes[4];
+  _mm256_store_pd(lanes, minimum);
+  best = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+
+  return scalar_leaf(points, stride, j, end, reference, best);
+}
+
+__attribute__((target("avx512f"), optimize("fp-contract=off"))) double
+avx512_leaf(
+    const double* points, unsigned stride, unsigned begin, unsigned end,
+    const double* reference, double best) {
+  const __m512d zero = _mm512_setzero_pd();
+  __m512d minimum = _mm512_set1_pd(best);
+  unsigned j = begin;
+
+  for (; j + 8 <= end; j += 8) {
+    __m512d distance = zero;
+
+    for (unsigned i = 0; i < IGD_Plus::num_objectives; i++) {
+      const __m512d delta =
+          _mm512_max_pd(_mm512_sub_pd(_mm512_loadu_pd(points + i * stride + j),
+                                      _mm512_set1_pd(reference[i])),
+                        zero);
+      distance = _mm512_add_pd(distance, _mm512_mul_pd(delta, delta));
+    }
+
+    minimum = _mm512_min_pd(minimum, distance);
+  }
+
+  return scalar_leaf(points, stride, j, end, reference,
+                     _mm512_reduce_min_pd(minimum));
+}
+
+#endif
+
+/**
+ * @brief The leaf kernels of each instruction set, indexed by Instruction_Set.
+ * Without x86 intrinsics every entry falls back to the scalar kernel.
+ */
+const Leaf_Kernel leaf_kernels[] = {
+    scalar_leaf,
+#ifdef MOPOP_X86_KERNELS
+    avx2_leaf,
+    avx512_leaf,
+#else
+    scalar_leaf,
+    scalar_leaf,
+#endif
+};
+
+}  // namespace
+
+/**
+ * @brief Builds the node holding a range of points, and the nodes below it,
+ * reordering the points so that the points of every node are contiguous.
+ *
+ * Inner nodes split their points at the median of the objective along which
+ * they spread the most.
+ *
+ * @param points The points.
+ * @param begin The first point of the node.
+ * @param end One past the last point of the node.
+ * @param nodes The nodes, to which the new ones are appended.
+ * @return The index of the node.
+ */
+unsigned IGD_Plus::build(std::vector<Point>& points, unsigned begin,
+                         unsigned end, std::vector<Node>& nodes) {
+  const unsigned index = nodes.size();
+  Point ideal = points[begin], nadir = points[begin];
+
+  for (unsigned j = begin + 1; j < end; j++) {
+    for (unsigned i = 0; i < num_objectives; i++) {
+      ideal[i] = std::min(ideal[i], points[j][i]);
+      nadir[i] = std::max(nadir[i], points[j][i]);
+    }
+  }
+
+  nodes.push_back({ideal, begin, end, {0, 0}});
+
+  if (end - begin <= max_leaf_size) {
+    return index;
+  }
+
+  unsigned split = 0;
+
+  for (unsigned i = 1; i < num_objectives; i++) {
+    if (nadir[i] - ideal[i] > nadir[split] - ideal[split]) {
+      split = i;
+    }
+  }
+
+  const unsigned middle = begin + (end - begin) / 2;
+
+  std::nth_element(points.begin() + begin, points.begin() + middle,
+                   points.begin() + end,
+                   [split](const Point& a, const Point& b) {
+                     return a[split] < b[split];
+                   });
+
+  const unsigned left = IGD_Plus::build(points, begin, middle, nodes);
+  const unsigned right = IGD_Plus::build(points, middle, end, nodes);
+
+  nodes[index].children = {left, right};
+
+  return index;
+}
+
+/**
+ * @brief Constructs a new IGD+ engine.
+ *
+ * @param senses The optimisation senses.
+ * @param reference_front The reference front.
+ *
+ * @throws std::runtime_error If there are not num_objectives senses.
+ */
+IGD_Plus::IGD_Plus(const std::vector<NSBRKGA::Sense>& senses,
+                   const std::vector<std::vector<double>>& reference_front)
+    : senses(senses) {
+  if (senses.size() != num_objectives) {
+    throw std::runtime_error("The IGD+ engine needs " +
+                             std::to_string(num_objectives) + " objectives.");
+  }
+
+  this->reference_front.reserve(reference_front.size());
+
+  for (const std::vector<double>& value : reference_front) {
+    this->reference_front.push_back(to_objective_point(value, this->senses));
+  }
+}
+
+/**
+ * @brief Computes the modified inverted generational distance of a front.
+ *
+ * @param front The front.
+ * @return The mean modified distance from each reference front point to its
+ * closest point in the front, or infinity if the front is empty.
+ */
+double IGD_Plus::compute(const std::vector<std::vector<double>>& front) const {
+  if (front.empty()) {
+    return std::numeric_limits<double>::infinity();
+  }
+
+  std::vector<Point> points;
+  std::vector<Node> nodes;
+
+  points.reserve(front.size());
+
+  for (const std::vector<double>& value : front) {
+    points.push_back(to_objective_point(value, this->senses));
+  }
+
+  IGD_Plus::build(points, 0, points.size(), nodes);
+
+  // The leaves are scanned objective by objective, so the points are stored
+  // one objective after the other, in the order of the tree.
+  const unsigned stride = points.size();
+  std::vector<double> columns(num_objectives * stride);
+
+  for (unsigned j = 0; j < stride; j++) {
+    for (unsigned i = 0; i < num_objectives; i++) {
+      columns[i * stride + j] = points[j][i];
+    }
+  }
+
+  const Leaf_Kernel leaf = leaf_kernels[int(active_instruction_set())];
+  std::vector<std::pair<double, unsigned>> stack;
+  double sum = 0.0;
+
+  for (const Point& reference : this->reference_front) {
+    // The bound of a node is computed the same way as the distances, and the
+    // rounding is monotone, so no point of a pruned node is strictly closer.
+    const auto bound = [&](const Node& node) {
+      return squared_distance(node.ideal.data(), 1, reference.data());
+    };
+    double best = std::numeric_limits<double>::infinity();
+
+    stack.clear();
+    stack.emplace_back(bound(nodes[0]), 0);
+
+    while (!stack.empty()) {
+      const auto [node_bound, index] = stack.back();
+      const Node& node = nodes[index];
+
+      stack.pop_back();
+
+      if (node_bound >= best) {
+        continue;
+      }
+
+      if (node.children[0] == 0) {
+        best = leaf(columns.data(), stride, node.begin, node.end,
+                    reference.data(), best);
+        continue;
+      }
+
+      double left_bound = bound(nodes[node.children[0]]),
+             right_bound = bound(nodes[node.children[1]]);
+      unsigned near = node.children[0], far = node.children[1];
+
+      if (right_bound < left_bound) {
+        std::swap(left_bound, right_bound);
+        std::swap(near, far);
+      }
+
+      if (right_bound < best) {
+        stack.emplace_back(right_bound, far);
+      }
+
+      if (left_bound < best) {
+        stack.emplace_back(left_bound, near);
+      }
+    }
+
+    sum += std::sqrt(best);
+  }
+
+  return sum / this->reference_front.size();
+}
+
+}  // namespace mopop
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "nsbrkga.hpp"
+#include "solution/objective_point.hpp"
+
+namespace mopop {
+/**
+ * @class IGD_Plus
+ * @brief Computes the modified inverted generational distance (IGD+) of fronts
+ * of four objectives with respect to a reference front.
+ *
+ * Every objective is taken as minimised. The modified distance from a reference
+ * point r to a point p only charges the objectives on which p is worse than r,
+ * so it never decreases when p gets worse on any objective. The points of the
+ * front are therefore indexed by a k-d tree whose nodes keep the
+ * componentwise minimum of the points below them: the modified distance from r
+ * to that minimum bounds the distance from r to every point of the node, and a
+ * node whose bound is no better than the closest point found so far is
+ * skipped. The leaves are scanned a vector of points at a time.
+ *
+ * The squared distances are summed objective by objective in the same order as
+ * the scalar formula and without fused multiply-adds, and the square root is
+ * only taken of the smallest one, so the result is the same, bit for bit, as
+ * the brute-force mean of the minimum modified distances.
+ */
+class IGD_Plus {
+ public:
+  /**
+   * @brief The number of objectives the engine is specialised for.
+   */
+  static constexpr unsigned num_objectives = 4;
+
+  /**
+   * @brief The number of points above which a node of the tree is split.
+   */
+  static constexpr unsigned max_leaf_size = 32;
+
+ private:
+  /**
+   * @brief The objective values of a point, all to be minimised.
+   */
+  typedef Objective_Point Point;
+
+  /**
+   * @brief A node of the k-d tree.
+   */
+  struct Node {
+    /**
+     * @brief The componentwise minimum of the points below the node.
+     */
+    Point ideal;
+
+    /**
+     * @brief The first point of the node.
+     */
+    unsigned begin;
+
+    /**
+     * @brief One past the last point of the node.
+     */
+    unsigned end;
+
+    /**
+     * @brief The two children of an inner node, or zero for a leaf.
+     */
+    std::array<unsigned, 2> children;
+  };
+
+  /**
+   * @brief The optimisation senses.
+   */
+  std::vector<NSBRKGA::Sense> senses;
+
+  /**
+   * @brief The points of the reference front.
+   */
+  std::vector<Point> reference_front;
+
+  /**
+   * @brief Builds the node holding a range of points, and the nodes below it,
+   * reordering the points so that the points of every node are contiguous.
+   *
+   * @param points The points.
+   * @param begin The first point of the node.
+   * @param end One past the last point of the node.
+   * @param nodes The nodes, to which the new ones are appended.
+   * @return The index of the node.
+   */
+  static unsigned build(std::vector<Point>& points, unsigned begin,
+                        unsigned end, std::vector<Node>& nodes);
+
+ public:
+  /**
+   * @brief Constructs a new IGD+ engine.
+   *
+   * @param senses The optimisation senses.
+   * @param reference_front The reference front.
+   *
+   * @throws std::runtime_error If there are not num_objectives senses.
+   */
+  IGD_Plus(const std::vector<NSBRKGA::Sense>& senses,
+           const std::vector<std::vector<double>>& reference_front);
+
+  /**
+   * @brief Computes the modified inverted generational distance of a front.
+   *
+   * @param front The front.
+   * @return The mean modified distance from each reference front point to its
+   * closest point in the front, or infinity if the front is empty.
+   */
+  double compute(const std::vector<std::vector<double>>& front) const;
+};
+
+}  // namespace mopop
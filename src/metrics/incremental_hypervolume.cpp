@@ -0,0 +1,87 @@
+#include "metrics/incremental_hypervolume.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace mopop {
+/**
+ * @brief Constructs a new tracker, starting from an empty front.
+ *
+ * @param senses The optimisation senses.
+ * @param reference_point The reference point.
+ *
+ * @throws std::runtime_error If there are not Hypervolume::num_objectives
+ * senses and reference values.
+ */
+Incremental_Hypervolume::Incremental_Hypervolume(
+    const std::vector<NSBRKGA::Sense>& senses,
+    const std::vector<double>& reference_point)
+    : engine(senses, reference_point) {}
+
+/**
+ * @brief Moves on to a new front and computes its hypervolume, the same as
+ * Hypervolume::compute up to rounding.
+ *
+ * @param front The new front.
+ * @return The hypervolume of the new front.
+ */
+double Incremental_Hypervolume::update(
+    const std::vector<std::vector<double>>& front) {
+  std::vector<std::vector<double>> sorted_front(front), removed, added;
+
+  std::sort(sorted_front.begin(), sorted_front.end());
+  std::set_difference(this->front.begin(), this->front.end(),
+                      sorted_front.begin(), sorted_front.end(),
+                      std::back_inserter(removed));
+  std::set_difference(sorted_front.begin(), sorted_front.end(),
+                      this->front.begin(), this->front.end(),
+                      std::back_inserter(added));
+
+  if (removed.empty() && added.empty()) {
+    return this->hypervolume;
+  }
+
+  if (this->num_updates >= max_num_updates ||
+      max_changes_ratio * (removed.size() + added.size()) >
+          sorted_front.size()) {
+    this->hypervolume = this->engine.compute(sorted_front);
+    this->front = std::move(sorted_front);
+    this->num_updates = 0;
+    this->num_full_updates++;
+
+    return this->hypervolume;
+  }
+
+  // The front goes through every intermediate state, so that each point is
+  // compared with exactly the points around it when it is removed or added.
+  for (const std::vector<double>& value : removed) {
+    this->front.erase(
+        std::lower_bound(this->front.begin(), this->front.end(), value));
+    this->hypervolume -= this->engine.contribution(value, this->front);
+  }
+
+  for (const std::vector<double>& value : added) {
+    this->hypervolume += this->engine.contribution(value, this->front);
+    this->front.insert(
+        std::upper_bound(this->front.begin(), this->front.end(), value),
+        value);
+  }
+
+  this->hypervolume = std::max(this->hypervolume, 0.0);
+  this->num_updates++;
+  this->num_incremental_updates++;
+
+  return this->hypervolume;
+}
+
+/**
+ * @brief Forgets the previous front, so that the next one is computed from
+ * scratch.
+ */
+void Incremental_Hypervolume::clear() {
+  this->front.clear();
+  this->hypervolume = 0.0;
+  this->num_updates = 0;
+}
+
+}  // namespace mopop
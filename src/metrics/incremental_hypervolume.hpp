@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+
+#include "metrics/hypervolume.hpp"
+
+namespace mopop {
+/**
+ * @class Incremental_Hypervolume
+ * @brief Tracks the hypervolume of a sequence of fronts, updating the
+ * hypervolume of the previous front when only a few of its points change.
+ *
+ * The points of the previous front missing from the new one are removed one at
+ * a time, each taking away its exclusive contribution to the points that
+ * remain, and then the points of the new front missing from the previous one
+ * are added, each bringing its exclusive contribution to the points already
+ * there. A contribution only depends on the points near the one added or
+ * removed, so consecutive snapshots of the same run cost much less than a full
+ * hypervolume each. Fronts that differ in more points are computed from
+ * scratch.
+ */
+class Incremental_Hypervolume {
+ public:
+  /**
+   * @brief The number of incremental updates after which the hypervolume is
+   * computed from scratch, which bounds the accumulated rounding errors.
+   */
+  static constexpr unsigned max_num_updates = 64;
+
+  /**
+   * @brief A front is updated incrementally when at most its size divided by
+   * this ratio of points were added or removed.
+   */
+  static constexpr unsigned max_changes_ratio = 4;
+
+  /**
+   * @brief The hypervolume engine.
+   */
+  const Hypervolume engine;
+
+  /**
+   * @brief The previous front, sorted lexicographically.
+   */
+  std::vector<std::vector<double>> front;
+
+  /**
+   * @brief The hypervolume of the previous front.
+   */
+  double hypervolume = 0.0;
+
+  /**
+   * @brief The number of incremental updates since the hypervolume was
+   * computed from scratch.
+   */
+  unsigned num_updates = 0;
+
+  /**
+   * @brief The number of fronts updated incrementally.
+   */
+  unsigned long num_incremental_updates = 0;
+
+  /**
+   * @brief The number of fronts computed from scratch.
+   */
+  unsigned long num_full_updates = 0;
+
+  /**
+   * @brief Constructs a new tracker, starting from an empty front.
+   *
+   * @param senses The optimisation senses.
+   * @param reference_point The reference point.
+   *
+   * @throws std::runtime_error If there are not Hypervolume::num_objectives
+   * senses and reference values.
+   */
+  Incremental_Hypervolume(const std::vector<NSBRKGA::Sense>& senses,
+                          const std::vector<double>& reference_point);
+
+  /**
+   * @brief Moves on to a new front and computes its hypervolume, the same as
+   * Hypervolume::compute up to rounding.
+   *
+   * @param front The new front.
+   * @return The hypervolume of the new front.
+   */
+  double update(const std::vector<std::vector<double>>& front);
+
+  /**
+   * @brief Forgets the previous front, so that the next one is computed from
+   * scratch.
+   */
+  void clear();
+};
+
+}  // namespace mopop
@@ -0,0 +1,37 @@
+#include "metrics/normalized_igd_plus.hpp"
+
+namespace mopop {
+/**
+ * @brief Constructs a new normalized IGD+.
+ *
+ * @param senses The optimisation senses.
+ * @param reference_front The reference front.
+ * @param reference_point The reference point.
+ *
+ * @throws std::runtime_error If there are not IGD_Plus::num_objectives senses.
+ */
+Normalized_IGD_Plus::Normalized_IGD_Plus(
+    const std::vector<NSBRKGA::Sense>& senses,
+    const std::vector<std::vector<double>>& reference_front,
+    const std::vector<double>& reference_point)
+    : engine(senses, reference_front),
+      reference_igd_plus(this->engine.compute({reference_point})) {}
+
+/**
+ * @brief Computes the normalized modified inverted generational distance of a
+ * front.
+ *
+ * @param front The front.
+ * @return The modified inverted generational distance of the front divided by
+ * the reference one, or one if the front is empty.
+ */
+double Normalized_IGD_Plus::compute(
+    const std::vector<std::vector<double>>& front) const {
+  if (front.empty()) {
+    return 1.0;
+  }
+
+  return this->engine.compute(front) / this->reference_igd_plus;
+}
+
+}  // namespace mopop
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+
+#include "metrics/igd_plus.hpp"
+
+namespace mopop {
+/**
+ * @class Normalized_IGD_Plus
+ * @brief Computes the modified inverted generational distance of fronts
+ * relative to that of the front made of the reference point alone, which is the
+ * largest value any front can attain.
+ */
+class Normalized_IGD_Plus {
+ public:
+  /**
+   * @brief The IGD+ engine of the reference front.
+   */
+  const IGD_Plus engine;
+
+  /**
+   * @brief The modified inverted generational distance of the front made of
+   * the reference point alone.
+   */
+  const double reference_igd_plus;
+
+  /**
+   * @brief Constructs a new normalized IGD+.
+   *
+   * @param senses The optimisation senses.
+   * @param reference_front The reference front.
+   * @param reference_point The reference point.
+   *
+   * @throws std::runtime_error If there are not IGD_Plus::num_objectives
+   * senses.
+   */
+  Normalized_IGD_Plus(const std::vector<NSBRKGA::Sense>& senses,
+                      const std::vector<std::vector<double>>& reference_front,
+                      const std::vector<double>& reference_point);
+
+  /**
+   * @brief Computes the normalized modified inverted generational distance of a
+   * front.
+   *
+   * @param front The front.
+   * @return The modified inverted generational distance of the front divided by
+   * the reference one, or one if the front is empty.
+   */
+  double compute(const std::vector<std::vector<double>>& front) const;
+};
+
+}  // namespace mopop
@@ -0,0 +1,93 @@
+#include "metrics/objective_bounds.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace mopop {
+/**
+ * @brief Constructs new bounds, which no point has attained yet.
+ *
+ * @param senses The optimisation senses.
+ */
+Objective_Bounds::Objective_Bounds(const std::vector<NSBRKGA::Sense>& senses)
+    : senses(senses),
+      worst_values(senses.size(), 0.0),
+      best_values(senses.size(), 0.0) {
+  for (unsigned i = 0; i < senses.size(); i++) {
+    if (senses[i] == NSBRKGA::Sense::MINIMIZE) {
+      this->worst_values[i] = std::numeric_limits<double>::lowest();
+      this->best_values[i] = std::numeric_limits<double>::max();
+    } else {  // senses[i] == NSBRKGA::Sense::MAXIMIZE
+      this->worst_values[i] = std::numeric_limits<double>::max();
+      this->best_values[i] = std::numeric_limits<double>::lowest();
+    }
+  }
+}
+
+/**
+ * @brief Updates the bounds with a point.
+ *
+ * @param value The objective values of the point.
+ */
+void Objective_Bounds::update(const std::vector<double>& value) {
+  for (unsigned i = 0; i < this->senses.size(); i++) {
+    if (this->senses[i] == NSBRKGA::Sense::MINIMIZE) {
+      if (this->worst_values[i] < value[i]) {
+        this->worst_values[i] = value[i];
+      }
+
+      if (this->best_values[i] > value[i]) {
+        this->best_values[i] = value[i];
+      }
+    } else {  // this->senses[i] == NSBRKGA::Sense::MAXIMIZE
+      if (this->worst_values[i] > value[i]) {
+        this->worst_values[i] = value[i];
+      }
+
+      if (this->best_values[i] < value[i]) {
+        this->best_values[i] = value[i];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Builds the reference point from the attained bounds.
+ *
+ * Each coordinate is the worst attained value of that objective pushed outward
+ * by 5% of the objective's attained range. The padding keeps every attained
+ * point strictly better than the reference point, so that the extreme points of
+ * a front still contribute a positive hypervolume and both the hypervolume
+ * ratio and the normalized IGD+ stay within [0, 1]. It is additive on the
+ * range, so it remains well defined when an objective takes negative values.
+ *
+ * @return The reference point.
+ */
+std::vector<double> Objective_Bounds::reference_point() const {
+  std::vector<double> reference_point(this->senses.size(), 0.0);
+
+  for (unsigned i = 0; i < this->senses.size(); i++) {
+    double padding =
+        0.05 * std::fabs(this->best_values[i] - this->worst_values[i]);
+
+    // The objective took a single value across every front.
+    if (padding < std::numeric_limits<double>::epsilon()) {
+      padding = 0.05 * std::fabs(this->worst_values[i]);
+    }
+
+    // That single value was zero.
+    if (padding < std::numeric_limits<double>::epsilon()) {
+      padding = 0.05;
+    }
+
+    if (this->senses[i] == NSBRKGA::Sense::MINIMIZE) {
+      reference_point[i] = this->worst_values[i] + padding;
+    } else {  // this->senses[i] == NSBRKGA::Sense::MAXIMIZE
+      reference_point[i] = this->worst_values[i] - padding;
+    }
+  }
+
+  return reference_point;
+}
+
+}  // namespace mopop
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+
+#include "nsbrkga.hpp"
+
+namespace mopop {
+/**
+ * @class Objective_Bounds
+ * @brief Tracks the worst and best attained value of each objective over a set
+ * of points, and builds the reference point from them.
+ *
+ * The worst bound of a maximization objective is its minimum attained value and
+ * the worst bound of a minimization objective is its maximum attained value.
+ */
+class Objective_Bounds {
+ public:
+  /**
+   * @brief The optimisation senses.
+   */
+  std::vector<NSBRKGA::Sense> senses;
+
+  /**
+   * @brief The worst attained value of each objective.
+   */
+  std::vector<double> worst_values;
+
+  /**
+   * @brief The best attained value of each objective.
+   */
+  std::vector<double> best_values;
+
+  /**
+   * @brief Constructs new bounds, which no point has attained yet.
+   *
+   * @param senses The optimisation senses.
+   */
+  Objective_Bounds(const std::vector<NSBRKGA::Sense>& senses);
+
+  /**
+   * @brief Updates the bounds with a point.
+   *
+   * @param value The objective values of the point.
+   */
+  void update(const std::vector<double>& value);
+
+  /**
+   * @brief Builds the reference point from the attained bounds.
+   *
+   * Each coordinate is the worst attained value of that objective pushed
+   * outward by 5% of the objective's attained range. The padding keeps every
+   * attained point strictly better than the reference point, so that the
+   * extreme points of a front still contribute a positive hypervolume and both
+   * the hypervolume ratio and the normalized IGD+ stay within [0, 1]. It is
+   * additive on the range, so it remains well defined when an objective takes
+   * negative values.
+   *
+   * @return The reference point.
+   */
+  std::vector<double> reference_point() const;
+};
+
+}  // namespace mopop
@@ -0,0 +1,64 @@
+#include "metrics/reference_front.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "solver/nd_tree.hpp"
+
+namespace mopop {
+/**
+ * @brief Constructs a new reference front builder.
+ *
+ * @param senses The optimisation senses.
+ * @param max_num_solutions The maximum number of points of the reference
+ * front, or the largest unsigned value for none.
+ *
+ * @throws std::runtime_error If there are not four senses.
+ */
+Reference_Front::Reference_Front(const std::vector<NSBRKGA::Sense>& senses,
+                                 unsigned max_num_solutions)
+    : senses(senses), max_num_solutions(max_num_solutions) {
+  if (senses.size() != ND_Tree::num_objectives) {
+    throw std::runtime_error("The reference front needs " +
+                             std::to_string(ND_Tree::num_objectives) +
+                             " objectives.");
+  }
+}
+
+/**
+ * @brief Builds the reference front of some runs.
+ *
+ * @param paretos The final front of each run, in order.
+ * @param best_solutions_snapshots The snapshots of the runs, in order, which
+ * are added after the final fronts.
+ * @return The points of the archive, in its order.
+ */
+Reference_Front::Front Reference_Front::compute(
+    const std::vector<Front>& paretos,
+    const std::vector<Front>& best_solutions_snapshots) const {
+  ND_Tree archive(this->senses);
+  const std::vector<double> chromosome;
+  Front result;
+
+  archive.set_max_size(this->max_num_solutions);
+
+  for (const std::vector<Front>* fronts :
+       {&paretos, &best_solutions_snapshots}) {
+    for (const Front& front : *fronts) {
+      for (const std::vector<double>& value : front) {
+        archive.update(Span<const double>(value.data(), value.size()),
+                       Span<const double>(chromosome.data(), 0));
+      }
+    }
+  }
+
+  result.reserve(archive.size());
+
+  for (const ND_Tree::Individual& individual : archive) {
+    result.push_back(individual.first);
+  }
+
+  return result;
+}
+
+}  // namespace mopop
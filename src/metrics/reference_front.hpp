@@ -0,0 +1,66 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "nsbrkga.hpp"
+
+namespace mopop {
+/**
+ * @class Reference_Front
+ * @brief Merges the final fronts and the snapshots of some runs into a
+ * reference front: every final front and then every snapshot, in order, is
+ * added to an archive of at most a maximum number of points, which evicts its
+ * most crowded point whenever it grows past that number.
+ *
+ * An archive that evicts while it is being fed keeps points that depend on the
+ * order they are added in, and may even keep a point dominated by an evicted
+ * one, so the points are added one at a time, in the order of the runs,
+ * however many threads read them. The reference front is the archive, in its
+ * own order, which is what the reference front calculator has always written.
+ */
+class Reference_Front {
+ public:
+  /**
+   * @brief The objective values of the points of a front.
+   */
+  typedef std::vector<std::vector<double>> Front;
+
+ private:
+  /**
+   * @brief The optimisation senses.
+   */
+  std::vector<NSBRKGA::Sense> senses;
+
+  /**
+   * @brief The maximum number of points of the reference front.
+   */
+  unsigned max_num_solutions;
+
+ public:
+  /**
+   * @brief Constructs a new reference front builder.
+   *
+   * @param senses The optimisation senses.
+   * @param max_num_solutions The maximum number of points of the reference
+   * front, or the largest unsigned value for none.
+   *
+   * @throws std::runtime_error If there are not four senses.
+   */
+  Reference_Front(
+      const std::vector<NSBRKGA::Sense>& senses,
+      unsigned max_num_solutions = std::numeric_limits<unsigned>::max());
+
+  /**
+   * @brief Builds the reference front of some runs.
+   *
+   * @param paretos The final front of each run, in order.
+   * @param best_solutions_snapshots The snapshots of the runs, in order, which
+   * are added after the final fronts.
+   * @return The points of the archive, in its order.
+   */
+  Front compute(const std::vector<Front>& paretos,
+                const std::vector<Front>& best_solutions_snapshots) const;
+};
+
+}  // namespace mopop
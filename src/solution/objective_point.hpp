@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "nsbrkga.hpp"
+
+#if defined(__SSE2__)
+#define MOPOP_SSE2_DOMINANCE
+#include <emmintrin.h>
+#endif
+
+namespace mopop {
+/**
+ * @brief The objective values of a point in canonical form, with the maximised
+ * objectives negated so that every objective is minimised. A point is
+ * converted once, and the comparisons no longer depend on the senses.
+ */
+typedef std::array<double, 4> Objective_Point;
+
+/**
+ * @brief Converts objective values to canonical form.
+ *
+ * @param value The objective values, one for each sense.
+ * @param senses The optimisation senses.
+ * @return The point.
+ */
+inline Objective_Point to_objective_point(
+    const double* value, const std::vector<NSBRKGA::Sense>& senses) {
+  Objective_Point point;
+
+  for (unsigned i = 0; i < point.size(); i++) {
+    point[i] = senses[i] == NSBRKGA::Sense::MINIMIZE ? value[i] : -value[i];
+  }
+
+  return point;
+}
+
+/**
+ * @brief Converts objective values to canonical form.
+ *
+ * @param value The objective values, one for each sense.
+ * @param senses The optimisation senses.
+ * @return The point.
+ */
+inline Objective_Point to_objective_point(
+    const std::vector<double>& value,
+    const std::vector<NSBRKGA::Sense>& senses) {
+  return to_objective_point(value.data(), senses);
+}
+
+/**
+ * @brief Determines whether a point dominates another, that is, whether it is
+ * no worse than the other by more than a tolerance on every objective and
+ * better than it by more than the tolerance on at least one.
+ *
+ * On x86-64 each half of the points is compared at once, and the masks of the
+ * two halves are combined, so the test takes no branch per objective.
+ *
+ * @param a The first point.
+ * @param b The second point.
+ * @param epsilon The tolerance, machine epsilon as in Solution::dominates, or
+ * zero for an exact test.
+ * @return true if `a` dominates `b`, false otherwise.
+ */
+inline bool dominates(
+    const Objective_Point& a, const Objective_Point& b,
+    double epsilon = std::numeric_limits<double>::epsilon()) {
+#ifdef MOPOP_SSE2_DOMINANCE
+  const __m128d tolerance = _mm_set1_pd(epsilon);
+  const __m128d a_low = _mm_loadu_pd(a.data()),
+                a_high = _mm_loadu_pd(a.data() + 2),
+                b_low = _mm_loadu_pd(b.data()),
+                b_high = _mm_loadu_pd(b.data() + 2);
+  const int no_worse = _mm_movemask_pd(
+      _mm_and_pd(_mm_cmpngt_pd(a_low, _mm_add_pd(b_low, tolerance)),
+                 _mm_cmpngt_pd(a_high, _mm_add_pd(b_high, tolerance))));
+  const int better = _mm_movemask_pd(
+      _mm_or_pd(_mm_cmplt_pd(a_low, _mm_sub_pd(b_low, tolerance)),
+                _mm_cmplt_pd(a_high, _mm_sub_pd(b_high, tolerance))));
+
+  return no_worse == 3 && better != 0;
+#else
+  bool no_worse = true, better = false;
+
+  for (unsigned i = 0; i < a.size(); i++) {
+    no_worse &= !(a[i] > b[i] + epsilon);
+    better |= a[i] < b[i] - epsilon;
+  }
+
+  return no_worse && better;
+#endif
+}
+
+/**
+ * @brief Determines whether a point covers another, that is, whether it
+ * dominates the other or is equal to it up to the tolerance on every
+ * objective.
+ *
+ * @param a The first point.
+ * @param b The second point.
+ * @param epsilon The tolerance.
+ * @return true if `a` covers `b`, false otherwise.
+ */
+inline bool covers(const Objective_Point& a, const Objective_Point& b,
+                   double epsilon = std::numeric_limits<double>::epsilon()) {
+#ifdef MOPOP_SSE2_DOMINANCE
+  const __m128d tolerance = _mm_set1_pd(epsilon);
+  const __m128d sign = _mm_set1_pd(-0.0);
+  const __m128d a_low = _mm_loadu_pd(a.data()),
+                a_high = _mm_loadu_pd(a.data() + 2),
+                b_low = _mm_loadu_pd(b.data()),
+                b_high = _mm_loadu_pd(b.data() + 2);
+  const int no_worse = _mm_movemask_pd(
+      _mm_and_pd(_mm_cmpngt_pd(a_low, _mm_add_pd(b_low, tolerance)),
+                 _mm_cmpngt_pd(a_high, _mm_add_pd(b_high, tolerance))));
+  const int better = _mm_movemask_pd(
+      _mm_or_pd(_mm_cmplt_pd(a_low, _mm_sub_pd(b_low, tolerance)),
+                _mm_cmplt_pd(a_high, _mm_sub_pd(b_high, tolerance))));
+  const int equal = _mm_movemask_pd(_mm_and_pd(
+      _mm_cmpnge_pd(_mm_andnot_pd(sign, _mm_sub_pd(a_low, b_low)), tolerance),
+      _mm_cmpnge_pd(_mm_andnot_pd(sign, _mm_sub_pd(a_high, b_high)),
+                    tolerance)));
+
+  return no_worse == 3 && (better != 0 || equal == 3);
+#else
+  bool no_worse = true, better = false, equal = true;
+
+  for (unsigned i = 0; i < a.size(); i++) {
+    no_worse &= !(a[i] > b[i] + epsilon);
+    better |= a[i] < b[i] - epsilon;
+    equal &= !(std::fabs(a[i] - b[i]) >= epsilon);
+  }
+
+  return no_worse && (better || equal);
+#endif
+}
+
+}  // namespace mopop
@@ -4,6 +4,10 @@
 #include <cmath>
 #include <limits>
 
+#include "evaluator/evaluator.hpp"
+#include "solution/objective_point.hpp"
+#include "utils/text_reader.hpp"
+
 namespace mopop {
 
 /**
@@ -13,7 +17,8 @@ namespace mopop {
  * This function checks if `valueA` dominates `valueB` according to the
  * optimization senses provided. Domination is defined as `valueA` being at
  * least as good as `valueB` in all objectives and strictly better in at least
- * one objective.
+ * one objective. Values of four objectives are compared in canonical form,
+ * without branching on the senses, by the same test as the archives use.
  *
  * @param valueA A vector of double values representing the first solution.
  * @param valueB A vector of double values representing the second solution.
@@ -28,6 +33,12 @@ bool Solution::dominates(const std::vector<double>& valueA,
     return false;
   }
 
+  if (valueA.size() == std::tuple_size<Objective_Point>::value &&
+      senses.size() == valueA.size()) {
+    return mopop::dominates(to_objective_point(valueA, senses),
+                            to_objective_point(valueB, senses));
+  }
+
   bool at_least_as_good = true, better = false;
 
   for (std::size_t i = 0; i < valueA.size() && at_least_as_good; i++) {
@@ -58,7 +69,8 @@ bool Solution::dominates(const std::vector<double>& valueA,
  * - The first value (value[0]) is the weighted sum of the expected returns of
  * the assets.
  * - The second value (value[1]) is the weighted sum of the covariances between
- * the assets.
+ * the assets, computed by the quadratic form kernel matching the covariance
+ * storage of the instance and the instruction set of the CPU.
  * - The third value (value[2]) is the ratio of the first value to the square
  * root of the second value, or 0.0 when the second value is not strictly
  * positive (which happens only for the degenerate all-zero weight vector, where
@@ -66,32 +78,11 @@ bool Solution::dominates(const std::vector<double>& valueA,
  * - The fourth value (value[3]) is the entropy of the weights.
  *
  * The function assumes that the `weight`, `instance.expected_returns`, and
- * `instance.covariance_matrix` are properly initialized and that `value` is a
+ * `instance.covariance_data` are properly initialized and that `value` is a
  * vector of at least three elements.
  */
 void Solution::compute_value() {
-  this->value[0] = 0.0;
-  this->value[1] = 0.0;
-  this->value[3] = 0.0;
-
-  for (unsigned i = 0; i < this->instance.num_assets; i++) {
-    this->value[0] += this->weight[i] * this->instance.expected_returns[i];
-
-    for (unsigned j = 0; j < this->instance.num_assets; j++) {
-      this->value[1] += this->weight[i] * this->weight[j] *
-                        this->instance.covariance_matrix[i][j];
-    }
-
-    if (this->weight[i] > 0.0) {
-      this->value[3] -= this->weight[i] * std::log2(this->weight[i]);
-    }
-  }
-
-  if (this->value[1] > 0.0) {
-    this->value[2] = this->value[0] / std::sqrt(this->value[1]);
-  } else {
-    this->value[2] = 0.0;
-  }
+  evaluate_weights(this->instance, this->weight.data(), this->value.data());
 }
 
 /**
@@ -115,24 +106,7 @@ Solution::Solution(const Instance& instance, const std::vector<double>& key)
     throw std::runtime_error("Invalid key size");
   }
 
-  double total_weight = 0.0;
-
-  for (unsigned i = 0; i < instance.num_assets; i++) {
-    this->weight[i] = key[i];
-    total_weight += this->weight[i];
-  }
-
-  if (total_weight > 0.0) {
-    for (unsigned i = 0; i < instance.num_assets; i++) {
-      this->weight[i] /= total_weight;
-    }
-  } else {
-    for (unsigned i = 0; i < instance.num_assets; i++) {
-      this->weight[i] = 1.0 / ((double)instance.num_assets);
-    }
-  }
-
-  this->compute_value();
+  evaluate(instance, key.data(), this->weight.data(), this->value.data());
 }
 
 /**
@@ -151,23 +125,18 @@ Solution::Solution(const Instance& instance, const std::vector<double>& key)
  */
 Solution::Solution(Instance& instance, const std::string& filename)
     : instance(instance), value(4, 0.0), weight(instance.num_assets, 0.0) {
-  std::ifstream file(filename);
-  std::string line;
+  Text_Reader file;
+  std::string_view ticker;
 
-  if (!file.is_open()) {
+  if (!file.open(filename)) {
     throw std::runtime_error("Unable to open file");
   }
 
-  std::getline(file, line);
-
-  for (unsigned i = 0; i < instance.num_assets; i++) {
-    std::getline(file, line);
-    std::istringstream linestream(line);
-    std::string ticker, weight_str;
+  file.next_line();
 
-    if (std::getline(linestream, ticker, ',') &&
-        std::getline(linestream, weight_str, ',')) {
-      this->weight[i] = std::stod(weight_str);
+  for (unsigned i = 0; i < instance.num_assets && file.next_line(); i++) {
+    if (file.next_field(ticker)) {
+      file.next_number(this->weight[i], ',');
     }
   }
 
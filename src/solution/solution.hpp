@@ -17,7 +17,8 @@ class Solution {
    * This function checks if `valueA` dominates `valueB` according to the
    * optimization senses provided. Domination is defined as `valueA` being at
    * least as good as `valueB` in all objectives and strictly better in at least
-   * one objective.
+   * one objective. Values of four objectives are compared in canonical form,
+   * without branching on the senses, by the same test as the archives use.
    *
    * @param valueA A vector of double values representing the first solution.
    * @param valueB A vector of double values representing the second solution.
@@ -54,13 +55,14 @@ class Solution {
    * - The first value (value[0]) is the weighted sum of the expected returns of
    * the assets.
    * - The second value (value[1]) is the weighted sum of the covariances
-   * between the assets.
+   * between the assets, computed by the quadratic form kernel matching the
+   * covariance storage of the instance and the instruction set of the CPU.
    * - The third value (value[2]) is the ratio of the first value to the square
    * root of the second value.
    * - The fourth value (value[3]) is the entropy of the weights.
    *
    * The function assumes that the `weight`, `instance.expected_returns`, and
-   * `instance.covariance_matrix` are properly initialized and that `value` is a
+   * `instance.covariance_data` are properly initialized and that `value` is a
    * vector of at least three elements.
    */
   void compute_value();
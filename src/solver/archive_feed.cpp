@@ -0,0 +1,134 @@
+#include "solver/archive_feed.hpp"
+
+#include <algorithm>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include "evaluator/evaluator.hpp"
+
+namespace mopop {
+/**
+ * @brief Constructs a new feed, bounding the archive.
+ *
+ * @param archive The archive to be fed.
+ * @param max_num_individuals The maximum number of individuals of the archive.
+ */
+Archive_Feed::Archive_Feed(ND_Tree& archive, unsigned max_num_individuals)
+    : archive(archive), is_modified(archive.size() > max_num_individuals) {
+  if (archive.max_size() != max_num_individuals) {
+    archive.set_max_size(max_num_individuals);
+  }
+}
+
+/**
+ * @brief Offers an evaluated individual to the archive.
+ *
+ * @param value The objective values of the individual.
+ * @param x The decision vector of the individual.
+ */
+void Archive_Feed::add(const std::vector<double>& value,
+                       const std::vector<double>& x) {
+  if (this->archive.update(Span<const double>(value.data(), value.size()),
+                           Span<const double>(x.data(), x.size()))) {
+    this->is_modified = true;
+  }
+}
+
+/**
+ * @brief Offers a batch of evaluated individuals to the archive, in the order
+ * of the batch. Each individual is read in place, and only copied if the
+ * archive admits it.
+ *
+ * @param values The objective values of the individuals, one after the other.
+ * @param xs The decision vectors of the individuals, one after the other.
+ */
+void Archive_Feed::add_batch(const std::vector<double>& values,
+                             const std::vector<double>& xs) {
+  const std::size_t num_individuals = values.size() / ND_Tree::num_objectives;
+
+  if (num_individuals == 0) {
+    return;
+  }
+
+  const std::size_t num_variables = xs.size() / num_individuals;
+
+  for (std::size_t i = 0; i < num_individuals; i++) {
+    if (this->archive.update(
+            Span<const double>(values.data() + i * ND_Tree::num_objectives,
+                               ND_Tree::num_objectives),
+            Span<const double>(xs.data() + i * num_variables,
+                               num_variables))) {
+      this->is_modified = true;
+    }
+  }
+}
+
+/**
+ * @brief Returns whether the archive has changed since the last call, and
+ * clears the flag.
+ *
+ * @return true if the archive has changed; false otherwise.
+ */
+bool Archive_Feed::take_modified() {
+  const bool result = this->is_modified;
+
+  this->is_modified = false;
+
+  return result;
+}
+
+/**
+ * @brief Constructs a new evaluator.
+ *
+ * @param instance The instance the problem evaluates.
+ * @param feed The feed of the evaluated individuals.
+ */
+Archive_Feed_Bfe::Archive_Feed_Bfe(const Instance& instance, Archive_Feed& feed)
+    : instance(&instance), feed(&feed) {}
+
+/**
+ * @brief Constructs a new empty evaluator, as pagmo requires.
+ */
+Archive_Feed_Bfe::Archive_Feed_Bfe() = default;
+
+/**
+ * @brief Evaluates a batch of decision vectors and feeds them, in order.
+ *
+ * The batch is split at multiples of batch_tile_size, so each worker evaluates
+ * the same tiles evaluate_batch would, and the values are those of the whole
+ * batch. The feed is only offered the batch once the workers are done.
+ *
+ * @param prob The problem, whose evaluation count is increased.
+ * @param dvs The decision vectors, one after the other.
+ * @return The objective values, one after the other.
+ */
+pagmo::vector_double Archive_Feed_Bfe::operator()(
+    pagmo::problem& prob, const pagmo::vector_double& dvs) const {
+  const std::size_t num_assets = this->instance->num_assets;
+  const std::size_t num_dvs = dvs.size() / num_assets;
+  const std::size_t num_tiles =
+      (num_dvs + batch_tile_size - 1) / batch_tile_size;
+  pagmo::vector_double weights(dvs.size()), fitnesses(num_dvs * 4);
+
+  const auto evaluate_tiles =
+      [&](const tbb::blocked_range<std::size_t>& range) {
+        const std::size_t first = range.begin() * batch_tile_size;
+        const std::size_t last =
+            std::min(num_dvs, range.end() * batch_tile_size);
+
+        evaluate_batch(*this->instance, dvs.data() + first * num_assets,
+                       last - first, weights.data() + first * num_assets,
+                       fitnesses.data() + first * 4);
+      };
+
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, num_tiles),
+                    evaluate_tiles);
+
+  prob.increment_fevals(num_dvs);
+  this->feed->add_batch(fitnesses, dvs);
+
+  return fitnesses;
+}
+
+}  // namespace mopop
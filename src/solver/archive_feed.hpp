@@ -0,0 +1,123 @@
+#pragma once
+
+#include <pagmo/problem.hpp>
+#include <pagmo/types.hpp>
+#include <vector>
+
+#include "instance/instance.hpp"
+#include "solver/nd_tree.hpp"
+
+namespace mopop {
+/**
+ * @class Archive_Feed
+ * @brief Offers every individual a pagmo problem evaluates to an archive, as it
+ * is evaluated, so that the solvers need not copy the population after every
+ * call to evolve.
+ *
+ * The individuals are offered on the solver thread, in the order they are
+ * evaluated. With several threads the batches are evaluated by an
+ * Archive_Feed_Bfe, which only offers a batch once all of it is evaluated, in
+ * the order of the batch, so a bounded archive ends up the same whatever the
+ * number of threads.
+ */
+class Archive_Feed {
+ private:
+  /**
+   * @brief The archive fed.
+   */
+  ND_Tree& archive;
+
+  /**
+   * @brief Whether the archive has changed since it was last asked.
+   */
+  bool is_modified;
+
+ public:
+  /**
+   * @brief Constructs a new feed, bounding the archive.
+   *
+   * @param archive The archive to be fed.
+   * @param max_num_individuals The maximum number of individuals of the
+   * archive.
+   */
+  Archive_Feed(ND_Tree& archive, unsigned max_num_individuals);
+
+  Archive_Feed(const Archive_Feed&) = delete;
+
+  Archive_Feed& operator=(const Archive_Feed&) = delete;
+
+  /**
+   * @brief Offers an evaluated individual to the archive.
+   *
+   * @param value The objective values of the individual.
+   * @param x The decision vector of the individual.
+   */
+  void add(const std::vector<double>& value, const std::vector<double>& x);
+
+  /**
+   * @brief Offers a batch of evaluated individuals to the archive, in the
+   * order of the batch.
+   *
+   * @param values The objective values of the individuals, one after the
+   * other.
+   * @param xs The decision vectors of the individuals, one after the other.
+   */
+  void add_batch(const std::vector<double>& values,
+                 const std::vector<double>& xs);
+
+  /**
+   * @brief Returns whether the archive has changed since the last call, and
+   * clears the flag.
+   *
+   * @return true if the archive has changed; false otherwise.
+   */
+  bool take_modified();
+};
+
+/**
+ * @class Archive_Feed_Bfe
+ * @brief A pagmo batch fitness evaluator that spreads the evaluation of a
+ * batch over the TBB workers and then offers the batch to a feed.
+ *
+ * The workers evaluate whole tiles of the batch as the problem's batch_fitness
+ * does, without going through the problem, which would feed each individual
+ * from the worker that evaluated it. The values are therefore those of a
+ * single thread, and the individuals reach the archive in the same order.
+ */
+class Archive_Feed_Bfe {
+ public:
+  /**
+   * @brief The instance the problem evaluates.
+   */
+  const Instance* instance = nullptr;
+
+  /**
+   * @brief The feed of the evaluated individuals.
+   */
+  Archive_Feed* feed = nullptr;
+
+  /**
+   * @brief Constructs a new evaluator.
+   *
+   * @param instance The instance the problem evaluates.
+   * @param feed The feed of the evaluated individuals.
+   */
+  Archive_Feed_Bfe(const Instance& instance, Archive_Feed& feed);
+
+  /**
+   * @brief Constructs a new empty evaluator, as pagmo requires.
+   */
+  Archive_Feed_Bfe();
+
+  /**
+   * @brief Evaluates a batch of decision vectors and feeds them, in order.
+   *
+   * @param prob The problem, whose evaluation count is increased.
+   * @param dvs The decision vectors, one after the other.
+   * @return The objective values, one after the other.
+   */
+  pagmo::vector_double operator()(pagmo::problem& prob,
+                                  const pagmo::vector_double& dvs) const;
+};
+
+}  // namespace mopop
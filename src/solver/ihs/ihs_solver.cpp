@@ -1,6 +1,7 @@
 #include "solver/ihs/ihs_solver.hpp"
 
 #include <pagmo/algorithms/ihs.hpp>
+#include <tbb/global_control.h>
 
 #include "solver/ihs/problem.hpp"
 
@@ -21,101 +22,44 @@ IHS_Solver::IHS_Solver() = default;
  * @brief Solves the instance.
  */
 void IHS_Solver::solve() {
-  this->start_time = std::chrono::steady_clock::now();
+  this->start_solving();
 
   std::vector<std::vector<double>> initial_chromosomes =
       this->build_initial_chromosomes(this->population_size);
 
-  pagmo::problem prob{Problem(this->instance)};
-  pagmo::algorithm algo{pagmo::ihs(1, this->phmcr, this->ppar_min,
-                                   this->ppar_max, this->bw_min, this->bw_max,
-                                   this->seed)};
-  pagmo::population pop{
-      prob, this->population_size - initial_chromosomes.size(), this->seed};
+  tbb::global_control parallelism(
+      tbb::global_control::max_allowed_parallelism,
+      std::max(this->num_threads, 1u));
+  Archive_Feed feed(this->best_individuals, this->max_num_solutions);
+  const pagmo::bfe bfe = this->build_bfe(feed);
+  pagmo::problem prob{Problem(this->instance, &feed)};
+  const auto build_algorithm = [&](unsigned num_generations, unsigned seed) {
+    return pagmo::algorithm{pagmo::ihs(num_generations, this->phmcr,
+                                       this->ppar_min, this->ppar_max,
+                                       this->bw_min, this->bw_max, seed)};
+  };
+  pagmo::population pop{prob, bfe,
+                        this->population_size - initial_chromosomes.size(),
+                        this->seed};
 
   for (const std::vector<double> &x : initial_chromosomes) {
     pop.push_back(x);
   }
 
-  this->update_best_individuals(pop);
+  this->update_best_individuals(feed);
+  this->read_clock();
 
-  if (this->max_num_snapshots > this->num_snapshots + 1) {
+  if (this->snapshot_scheduler.is_due(this->num_iterations,
+                                      this->current_time)) {
     this->capture_snapshot(pop);
-
-    if (this->time_limit < std::numeric_limits<double>::max()) {
-      this->time_snapshot_factor =
-          std::pow(this->time_limit / this->time_last_snapshot,
-                   1.0 / (this->max_num_snapshots - this->num_snapshots));
-      this->time_next_snapshot =
-          this->time_last_snapshot * this->time_snapshot_factor;
-    } else {
-      this->time_next_snapshot = std::numeric_limits<double>::max();
-      this->time_snapshot_factor = 1.0;
-    }
-
-    if (this->iterations_limit < std::numeric_limits<unsigned>::max()) {
-      this->iteration_snapshot_factor = std::pow(
-          this->iterations_limit / (this->iteration_last_snapshot + 1.0),
-          1.0 / (this->max_num_snapshots - this->num_snapshots));
-      this->iteration_next_snapshot =
-          unsigned(std::round(double(this->iteration_last_snapshot) *
-                              this->iteration_snapshot_factor));
-    } else {
-      this->iteration_next_snapshot = std::numeric_limits<unsigned>::max();
-      this->iteration_snapshot_factor = 1.0;
-    }
-  } else {
-    this->time_next_snapshot = 0.0;
-    this->iteration_next_snapshot = 0;
-    this->time_snapshot_factor = 1.0;
-    this->iteration_snapshot_factor = 1.0;
   }
 
   while (!this->are_termination_criteria_met()) {
-    this->num_iterations++;
-    pop = algo.evolve(pop);
-    this->update_best_individuals(pop);
-
-    if (this->max_num_snapshots > this->num_snapshots + 1) {
-      if (this->num_iterations >= this->iteration_next_snapshot) {
-        this->capture_snapshot(pop);
-
-        if (this->time_limit < std::numeric_limits<double>::max()) {
-          this->time_next_snapshot =
-              this->time_last_snapshot * this->time_snapshot_factor;
-          this->time_snapshot_factor =
-              std::pow(this->time_limit / this->time_last_snapshot,
-                       1.0 / (this->max_num_snapshots - this->num_snapshots));
-        }
-
-        if (this->iterations_limit < std::numeric_limits<unsigned>::max()) {
-          this->iteration_next_snapshot =
-              unsigned(std::round(double(this->iteration_last_snapshot) *
-                                  this->iteration_snapshot_factor));
-          this->iteration_snapshot_factor =
-              std::pow(this->iterations_limit / this->iteration_last_snapshot,
-                       1.0 / (this->max_num_snapshots - this->num_snapshots));
-        }
-      } else if (this->elapsed_time() >= this->time_next_snapshot) {
-        this->capture_snapshot(pop);
-
-        if (this->time_limit < std::numeric_limits<double>::max()) {
-          this->time_next_snapshot =
-              this->time_last_snapshot * this->time_snapshot_factor;
-          this->time_snapshot_factor =
-              std::pow(this->time_limit / this->time_last_snapshot,
-                       1.0 / (this->max_num_snapshots - this->num_snapshots));
-        }
-
-        if (this->iterations_limit < std::numeric_limits<unsigned>::max()) {
-          this->iteration_next_snapshot =
-              unsigned(std::round(double(this->iteration_last_snapshot) *
-                                  this->iteration_snapshot_factor));
-          this->iteration_snapshot_factor =
-              std::pow(this->iterations_limit / this->iteration_last_snapshot,
-                       1.0 / (this->max_num_snapshots - this->num_snapshots));
-        }
-      }
+    this->evolve(pop, feed, build_algorithm);
+
+    if (this->snapshot_scheduler.is_due(this->num_iterations,
+                                        this->current_time)) {
+      this->capture_snapshot(pop);
     }
   }
 
@@ -123,6 +67,8 @@ void IHS_Solver::solve() {
     this->capture_snapshot(pop);
   }
 
+  this->complete_snapshots();
+
   this->best_solutions.clear();
 
   for (const auto &best_individual : this->best_individuals) {
@@ -131,6 +77,7 @@ void IHS_Solver::solve() {
   }
 
   this->solving_time = this->elapsed_time();
+  this->update_hypervolume();
 }
 
 /**
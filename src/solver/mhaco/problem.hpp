@@ -1,8 +1,10 @@
 #pragma once
 
+#include <pagmo/threading.hpp>
 #include <pagmo/types.hpp>
 
 #include "instance/instance.hpp"
+#include "solver/archive_feed.hpp"
 
 namespace mopop {
 
@@ -10,15 +12,21 @@ class Problem {
  public:
   const Instance instance;
 
-  Problem(const Instance& instance);
+  Archive_Feed* archive_feed = nullptr;
+
+  Problem(const Instance& instance, Archive_Feed* archive_feed = nullptr);
 
   Problem();
 
   pagmo::vector_double fitness(const pagmo::vector_double& dv) const;
 
+  pagmo::vector_double batch_fitness(const pagmo::vector_double& dvs) const;
+
   std::pair<pagmo::vector_double, pagmo::vector_double> get_bounds() const;
 
   pagmo::vector_double::size_type get_nobj() const;
+
+  pagmo::thread_safety get_thread_safety() const;
 };
 
 }  // namespace mopop
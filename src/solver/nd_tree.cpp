@@ -0,0 +1,974 @@
+#include "solver/nd_tree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace mopop {
+/**
+ * @brief Creates an empty node.
+ *
+ * @param parent The parent of the node.
+ * @param is_leaf Whether the node is a leaf.
+ * @return The node.
+ */
+unsigned ND_Tree::new_node(unsigned parent, bool is_leaf) {
+  unsigned node;
+
+  if (this->free_nodes.empty()) {
+    node = this->nodes.size();
+    this->nodes.emplace_back();
+  } else {
+    node = this->free_nodes.back();
+    this->free_nodes.pop_back();
+  }
+
+  this->nodes[node].ideal.fill(std::numeric_limits<double>::infinity());
+  this->nodes[node].nadir.fill(-std::numeric_limits<double>::infinity());
+  this->nodes[node].parent = parent;
+  this->nodes[node].is_leaf = is_leaf;
+  this->nodes[node].children.clear();
+  this->nodes[node].members.clear();
+
+  return node;
+}
+
+/**
+ * @brief Returns the squared distance between a point and the centre of the
+ * box of a node, with every objective scaled by the range of the archive.
+ *
+ * @param node The node.
+ * @param point The point.
+ * @return The distance.
+ */
+double ND_Tree::distance(unsigned node, const Point& point) const {
+  const Node& box = this->nodes[node];
+  const Node& bounds = this->nodes[this->root];
+  double result = 0.0;
+
+  for (unsigned i = 0; i < num_objectives; i++) {
+    double range = bounds.nadir[i] - bounds.ideal[i];
+    double difference = point[i] - 0.5 * (box.ideal[i] + box.nadir[i]);
+
+    if (range > 0.0) {
+      difference /= range;
+    }
+
+    result += difference * difference;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Returns whether some individual below a node dominates a point or
+ * is equal to it.
+ *
+ * @param node The node.
+ * @param point The point.
+ * @return true if the point is covered; false otherwise.
+ */
+bool ND_Tree::is_covered(unsigned node, const Point& point) const {
+  constexpr double epsilon = std::numeric_limits<double>::epsilon();
+  const Node& box = this->nodes[node];
+  bool nadir_at_least_as_good = true, nadir_better = false;
+
+  for (unsigned i = 0; i < num_objectives; i++) {
+    // No individual of the box is within the tolerance of the point.
+    if (box.ideal[i] > point[i] + epsilon) {
+      return false;
+    }
+
+    if (box.nadir[i] > point[i]) {
+      nadir_at_least_as_good = false;
+    } else if (box.nadir[i] < point[i] - epsilon) {
+      nadir_better = true;
+    }
+  }
+
+  // Every individual of the box dominates the point.
+  if (nadir_at_least_as_good && nadir_better) {
+    return true;
+  }
+
+  if (!box.is_leaf) {
+    for (unsigned child : box.children) {
+      if (this->is_covered(child, point)) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  for (unsigned index : box.members) {
+    if (mopop::covers(this->points[index], point, epsilon)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Appends the individuals below a node dominated by a point to the
+ * dominated individuals.
+ *
+ * @param node The node.
+ * @param point The point.
+ */
+void ND_Tree::collect_dominated(unsigned node, const Point& point) {
+  constexpr double epsilon = std::numeric_limits<double>::epsilon();
+  const Node& box = this->nodes[node];
+  bool ideal_at_least_as_good = true, ideal_better = false;
+
+  for (unsigned i = 0; i < num_objectives; i++) {
+    // The point is worse than every individual of the box in this objective.
+    if (point[i] > box.nadir[i] + epsilon) {
+      return;
+    }
+
+    if (point[i] > box.ideal[i] + epsilon) {
+      ideal_at_least_as_good = false;
+    } else if (point[i] < box.ideal[i] - epsilon) {
+      ideal_better = true;
+    }
+  }
+
+  // The point dominates every individual of the box.
+  if (ideal_at_least_as_good && ideal_better) {
+    this->collect_all(node);
+    return;
+  }
+
+  if (!box.is_leaf) {
+    for (unsigned child : box.children) {
+      this->collect_dominated(child, point);
+    }
+
+    return;
+  }
+
+  for (unsigned index : box.members) {
+    if (mopop::dominates(point, this->points[index], epsilon)) {
+      this->dominated.push_back(index);
+    }
+  }
+}
+
+/**
+ * @brief Appends all the individuals below a node to the dominated
+ * individuals.
+ *
+ * @param node The node.
+ */
+void ND_Tree::collect_all(unsigned node) {
+  const Node& box = this->nodes[node];
+
+  if (box.is_leaf) {
+    this->dominated.insert(this->dominated.end(), box.members.begin(),
+                           box.members.end());
+  } else {
+    for (unsigned child : box.children) {
+      this->collect_all(child);
+    }
+  }
+}
+
+/**
+ * @brief Places an individual in the leaf whose box is the closest to it.
+ *
+ * @param index The individual.
+ */
+void ND_Tree::insert(unsigned index) {
+  const Point point = this->points[index];
+  unsigned node = this->root;
+
+  while (!this->nodes[node].is_leaf) {
+    Node& box = this->nodes[node];
+
+    for (unsigned i = 0; i < num_objectives; i++) {
+      box.ideal[i] = std::min(box.ideal[i], point[i]);
+      box.nadir[i] = std::max(box.nadir[i], point[i]);
+    }
+
+    unsigned closest = box.children.front();
+    double closest_distance = std::numeric_limits<double>::max();
+
+    for (unsigned child : box.children) {
+      double child_distance = this->distance(child, point);
+
+      if (child_distance < closest_distance) {
+        closest = child;
+        closest_distance = child_distance;
+      }
+    }
+
+    node = closest;
+  }
+
+  this->add_member(node, index);
+
+  if (this->nodes[node].members.size() > max_leaf_size) {
+    this->split(node);
+  }
+}
+
+/**
+ * @brief Adds an individual to a leaf, extending the box of the leaf.
+ *
+ * @param leaf The leaf.
+ * @param index The individual.
+ */
+void ND_Tree::add_member(unsigned leaf, unsigned index) {
+  Node& box = this->nodes[leaf];
+  const Point& point = this->points[index];
+
+  for (unsigned i = 0; i < num_objectives; i++) {
+    box.ideal[i] = std::min(box.ideal[i], point[i]);
+    box.nadir[i] = std::max(box.nadir[i], point[i]);
+  }
+
+  this->locations[index] = std::make_pair(leaf, box.members.size());
+  box.members.push_back(index);
+}
+
+/**
+ * @brief Splits a leaf into num_children leaves.
+ *
+ * The first child starts with the individual farthest on average from the
+ * others, and each next one with the individual farthest on average from the
+ * children started so far. The other individuals go to the closest child.
+ *
+ * @param leaf The leaf.
+ */
+void ND_Tree::split(unsigned leaf) {
+  std::vector<unsigned> members;
+  members.swap(this->nodes[leaf].members);
+  this->nodes[leaf].is_leaf = false;
+
+  const Node& bounds = this->nodes[this->root];
+  Point scale;
+
+  for (unsigned i = 0; i < num_objectives; i++) {
+    double range = bounds.nadir[i] - bounds.ideal[i];
+    scale[i] = range > 0.0 ? 1.0 / range : 1.0;
+  }
+
+  auto scaled_distance = [&](unsigned a, unsigned b) {
+    double result = 0.0;
+
+    for (unsigned i = 0; i < num_objectives; i++) {
+      double difference =
+          (this->points[a][i] - this->points[b][i]) * scale[i];
+      result += difference * difference;
+    }
+
+    return result;
+  };
+
+  std::vector<double> total_distances(members.size(), 0.0);
+  std::vector<bool> is_seed(members.size(), false);
+
+  for (std::size_t i = 0; i < members.size(); i++) {
+    for (std::size_t j = i + 1; j < members.size(); j++) {
+      double pair_distance = scaled_distance(members[i], members[j]);
+      total_distances[i] += pair_distance;
+      total_distances[j] += pair_distance;
+    }
+  }
+
+  for (unsigned k = 0; k < num_children; k++) {
+    std::size_t seed = members.size();
+
+    for (std::size_t i = 0; i < members.size(); i++) {
+      if (!is_seed[i] && (seed == members.size() ||
+                          total_distances[i] > total_distances[seed])) {
+        seed = i;
+      }
+    }
+
+    if (k == 0) {
+      std::fill(total_distances.begin(), total_distances.end(), 0.0);
+    }
+
+    is_seed[seed] = true;
+
+    unsigned child = this->new_node(leaf, true);
+    this->nodes[leaf].children.push_back(child);
+    this->add_member(child, members[seed]);
+
+    for (std::size_t i = 0; i < members.size(); i++) {
+      if (!is_seed[i]) {
+        total_distances[i] += scaled_distance(members[i], members[seed]);
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < members.size(); i++) {
+    if (is_seed[i]) {
+      continue;
+    }
+
+    const std::vector<unsigned>& children = this->nodes[leaf].children;
+    unsigned closest = children.front();
+    double closest_distance = std::numeric_limits<double>::max();
+
+    for (unsigned child : children) {
+      double child_distance = this->distance(child, this->points[members[i]]);
+
+      if (child_distance < closest_distance) {
+        closest = child;
+        closest_distance = child_distance;
+      }
+    }
+
+    this->add_member(closest, members[i]);
+  }
+}
+
+/**
+ * @brief Removes an individual from the archive.
+ *
+ * @param index The individual.
+ */
+void ND_Tree::remove(unsigned index) {
+  if (this->is_bounded()) {
+    this->remove_from_orders(index);
+  }
+
+  const unsigned leaf = this->locations[index].first,
+                 slot = this->locations[index].second;
+  std::vector<unsigned>& members = this->nodes[leaf].members;
+
+  members[slot] = members.back();
+  this->locations[members[slot]].second = slot;
+  members.pop_back();
+
+  if (members.empty()) {
+    this->detach(leaf);
+  } else {
+    this->shrink(leaf);
+  }
+
+  const unsigned last = this->archive.size() - 1;
+
+  if (index != last) {
+    this->archive[index] = std::move(this->archive[last]);
+    this->points[index] = this->points[last];
+    this->locations[index] = this->locations[last];
+    this->nodes[this->locations[index].first]
+        .members[this->locations[index].second] = index;
+
+    if (this->is_bounded()) {
+      this->order_entries[index] = this->order_entries[last];
+      this->crowding_distances[index] = this->crowding_distances[last];
+
+      for (unsigned i = 0; i < num_objectives; i++) {
+        this->order_entries[index][i]->second = index;
+      }
+
+      if (!this->are_crowding_distances_stale) {
+        this->set_heap_position(this->heap_positions[last], index);
+      }
+    }
+  }
+
+  this->archive.pop_back();
+  this->points.pop_back();
+  this->locations.pop_back();
+
+  if (this->is_bounded()) {
+    this->order_entries.pop_back();
+    this->crowding_distances.pop_back();
+    this->heap_positions.pop_back();
+  }
+}
+
+/**
+ * @brief Removes an empty node from the tree. A parent left empty is removed
+ * as well, and a parent left with a single child is replaced by it.
+ *
+ * @param node The node.
+ */
+void ND_Tree::detach(unsigned node) {
+  if (node == this->root) {
+    this->free_nodes.push_back(node);
+    this->root = this->new_node(no_node, true);
+    return;
+  }
+
+  const unsigned parent = this->nodes[node].parent;
+  std::vector<unsigned>& siblings = this->nodes[parent].children;
+
+  siblings.erase(std::find(siblings.begin(), siblings.end(), node));
+  this->free_nodes.push_back(node);
+
+  if (siblings.empty()) {
+    this->detach(parent);
+  } else if (siblings.size() > 1) {
+    this->shrink(parent);
+  } else {
+    const unsigned child = siblings.front(),
+                   grandparent = this->nodes[parent].parent;
+
+    this->nodes[child].parent = grandparent;
+
+    if (grandparent == no_node) {
+      this->root = child;
+    } else {
+      std::vector<unsigned>& uncles = this->nodes[grandparent].children;
+      *std::find(uncles.begin(), uncles.end(), parent) = child;
+      this->shrink(grandparent);
+    }
+
+    this->free_nodes.push_back(parent);
+  }
+}
+
+/**
+ * @brief Recomputes the box of a node from its members or children, and then
+ * the boxes of its ancestors, as long as they change.
+ *
+ * @param node The node.
+ */
+void ND_Tree::shrink(unsigned node) {
+  while (node != no_node) {
+    Node& box = this->nodes[node];
+    Point ideal, nadir;
+
+    ideal.fill(std::numeric_limits<double>::infinity());
+    nadir.fill(-std::numeric_limits<double>::infinity());
+
+    if (box.is_leaf) {
+      for (unsigned index : box.members) {
+        for (unsigned i = 0; i < num_objectives; i++) {
+          ideal[i] = std::min(ideal[i], this->points[index][i]);
+          nadir[i] = std::max(nadir[i], this->points[index][i]);
+        }
+      }
+    } else {
+      for (unsigned child : box.children) {
+        for (unsigned i = 0; i < num_objectives; i++) {
+          ideal[i] = std::min(ideal[i], this->nodes[child].ideal[i]);
+          nadir[i] = std::max(nadir[i], this->nodes[child].nadir[i]);
+        }
+      }
+    }
+
+    if (ideal == box.ideal && nadir == box.nadir) {
+      return;
+    }
+
+    box.ideal = ideal;
+    box.nadir = nadir;
+    node = box.parent;
+  }
+}
+
+/**
+ * @brief Computes the crowding distance of an individual of a bounded archive
+ * from its neighbours in each objective.
+ *
+ * @param index The individual.
+ * @return The crowding distance.
+ */
+double ND_Tree::crowding_distance(unsigned index) const {
+  double result = 0.0;
+
+  for (unsigned i = 0; i < num_objectives; i++) {
+    const std::multimap<double, unsigned>& order = this->orders[i];
+    const auto entry = this->order_entries[index][i];
+
+    if (entry == order.begin() || std::next(entry) == order.end()) {
+      return std::numeric_limits<double>::infinity();
+    }
+
+    double range = order.rbegin()->first - order.begin()->first;
+
+    if (range > 0.0) {
+      result += (std::next(entry)->first - std::prev(entry)->first) / range;
+    }
+  }
+
+  return result;
+}
+
+/**
+ * @brief Recomputes the crowding distance of an individual of a bounded
+ * archive.
+ *
+ * @param index The individual.
+ */
+void ND_Tree::update_crowding_distance(unsigned index) {
+  double distance = this->crowding_distance(index);
+
+  if (distance < this->crowding_distances[index]) {
+    this->crowding_distances[index] = distance;
+    this->sift_up(index);
+  } else {
+    this->crowding_distances[index] = distance;
+    this->sift_down(index);
+  }
+}
+
+/**
+ * @brief Places an individual at a position of the heap.
+ *
+ * @param position The position.
+ * @param index The individual.
+ */
+void ND_Tree::set_heap_position(unsigned position, unsigned index) {
+  this->crowding_heap[position] = index;
+  this->heap_positions[index] = position;
+}
+
+/**
+ * @brief Moves an individual towards the top of the heap while it is more
+ * crowded than its parent.
+ *
+ * @param index The individual.
+ */
+void ND_Tree::sift_up(unsigned index) {
+  unsigned position = this->heap_positions[index];
+
+  while (position > 0) {
+    unsigned parent = (position - 1) / 2;
+
+    if (this->crowding_distances[this->crowding_heap[parent]] <=
+        this->crowding_distances[index]) {
+      break;
+    }
+
+    this->set_heap_position(position, this->crowding_heap[parent]);
+    position = parent;
+  }
+
+  this->set_heap_position(position, index);
+}
+
+/**
+ * @brief Moves an individual towards the bottom of the heap while it is less
+ * crowded than one of its children.
+ *
+ * @param index The individual.
+ */
+void ND_Tree::sift_down(unsigned index) {
+  const unsigned size = this->crowding_heap.size();
+  unsigned position = this->heap_positions[index];
+
+  for (unsigned child = 2 * position + 1; child < size;
+       child = 2 * position + 1) {
+    if (child + 1 < size &&
+        this->crowding_distances[this->crowding_heap[child + 1]] <
+            this->crowding_distances[this->crowding_heap[child]]) {
+      child++;
+    }
+
+    if (this->crowding_distances[index] <=
+        this->crowding_distances[this->crowding_heap[child]]) {
+      break;
+    }
+
+    this->set_heap_position(position, this->crowding_heap[child]);
+    position = child;
+  }
+
+  this->set_heap_position(position, index);
+}
+
+/**
+ * @brief Removes an individual from the heap.
+ *
+ * @param index The individual.
+ */
+void ND_Tree::remove_from_heap(unsigned index) {
+  const unsigned position = this->heap_positions[index],
+                 moved = this->crowding_heap.back();
+
+  this->crowding_heap.pop_back();
+
+  if (moved != index) {
+    this->set_heap_position(position, moved);
+
+    if (this->crowding_distances[moved] < this->crowding_distances[index]) {
+      this->sift_up(moved);
+    } else {
+      this->sift_down(moved);
+    }
+  }
+}
+
+/**
+ * @brief Recomputes the crowding distances of all the individuals of a bounded
+ * archive, with a single pass over each objective.
+ */
+void ND_Tree::compute_crowding_distances() {
+  const unsigned size = this->archive.size();
+
+  this->crowding_distances.assign(size, 0.0);
+
+  for (unsigned i = 0; i < num_objectives; i++) {
+    const std::multimap<double, unsigned>& order = this->orders[i];
+
+    if (order.empty()) {
+      continue;
+    }
+
+    double range = order.rbegin()->first - order.begin()->first;
+
+    this->crowding_distances[order.begin()->second] =
+        std::numeric_limits<double>::infinity();
+    this->crowding_distances[order.rbegin()->second] =
+        std::numeric_limits<double>::infinity();
+
+    if (order.size() < 3 || range <= 0.0) {
+      continue;
+    }
+
+    for (auto previous = order.begin(), it = std::next(previous),
+              next = std::next(it);
+         next != order.end(); previous++, it++, next++) {
+      this->crowding_distances[it->second] +=
+          (next->first - previous->first) / range;
+    }
+  }
+
+  this->crowding_heap.resize(size);
+  this->heap_positions.resize(size);
+
+  for (unsigned index = 0; index < size; index++) {
+    this->set_heap_position(index, index);
+  }
+
+  for (unsigned position = size / 2; position-- > 0;) {
+    this->sift_down(this->crowding_heap[position]);
+  }
+
+  this->are_crowding_distances_stale = false;
+}
+
+/**
+ * @brief Sorts the individuals of a bounded archive by each objective and
+ * computes their crowding distances.
+ */
+void ND_Tree::build_orders() {
+  for (std::multimap<double, unsigned>& order : this->orders) {
+    order.clear();
+  }
+
+  this->order_entries.clear();
+  this->crowding_distances.clear();
+  this->crowding_heap.clear();
+  this->heap_positions.clear();
+  this->are_crowding_distances_stale = false;
+
+  if (!this->is_bounded()) {
+    return;
+  }
+
+  this->order_entries.resize(this->archive.size());
+
+  for (unsigned index = 0; index < this->archive.size(); index++) {
+    for (unsigned i = 0; i < num_objectives; i++) {
+      this->order_entries[index][i] =
+          this->orders[i].emplace(this->points[index][i], index);
+    }
+  }
+
+  this->compute_crowding_distances();
+}
+
+/**
+ * @brief Adds an individual, already in the tree, to the orders of a bounded
+ * archive.
+ *
+ * Only the neighbours of the individual in each objective see their crowding
+ * distance change, unless the individual is an extreme one, which changes the
+ * range of the objective.
+ *
+ * @param index The individual.
+ */
+void ND_Tree::add_to_orders(unsigned index) {
+  std::array<unsigned, 2 * num_objectives> neighbours;
+  unsigned num_neighbours = 0;
+
+  this->order_entries.emplace_back();
+  this->crowding_distances.push_back(0.0);
+  this->heap_positions.push_back(0);
+
+  for (unsigned i = 0; i < num_objectives; i++) {
+    std::multimap<double, unsigned>& order = this->orders[i];
+    const auto entry = order.emplace(this->points[index][i], index);
+
+    this->order_entries[index][i] = entry;
+
+    if (entry == order.begin() || std::next(entry) == order.end()) {
+      this->are_crowding_distances_stale = true;
+    } else {
+      for (unsigned neighbour :
+           {std::prev(entry)->second, std::next(entry)->second}) {
+        if (std::find(neighbours.begin(), neighbours.begin() + num_neighbours,
+                      neighbour) == neighbours.begin() + num_neighbours) {
+          neighbours[num_neighbours++] = neighbour;
+        }
+      }
+    }
+  }
+
+  if (this->are_crowding_distances_stale) {
+    return;
+  }
+
+  this->crowding_distances[index] = this->crowding_distance(index);
+  this->crowding_heap.push_back(index);
+  this->heap_positions[index] = this->crowding_heap.size() - 1;
+  this->sift_up(index);
+
+  for (unsigned i = 0; i < num_neighbours; i++) {
+    this->update_crowding_distance(neighbours[i]);
+  }
+}
+
+/**
+ * @brief Removes an individual, still in the tree, from the orders of a
+ * bounded archive.
+ *
+ * @param index The individual.
+ */
+void ND_Tree::remove_from_orders(unsigned index) {
+  std::array<unsigned, 2 * num_objectives> neighbours;
+  unsigned num_neighbours = 0;
+
+  for (unsigned i = 0; i < num_objectives; i++) {
+    std::multimap<double, unsigned>& order = this->orders[i];
+    const auto entry = this->order_entries[index][i];
+
+    if (entry == order.begin() || std::next(entry) == order.end()) {
+      this->are_crowding_distances_stale = true;
+    } else {
+      for (unsigned neighbour :
+           {std::prev(entry)->second, std::next(entry)->second}) {
+        if (std::find(neighbours.begin(), neighbours.begin() + num_neighbours,
+                      neighbour) == neighbours.begin() + num_neighbours) {
+          neighbours[num_neighbours++] = neighbour;
+        }
+      }
+    }
+
+    order.erase(entry);
+  }
+
+  if (this->are_crowding_distances_stale) {
+    return;
+  }
+
+  this->remove_from_heap(index);
+
+  for (unsigned i = 0; i < num_neighbours; i++) {
+    this->update_crowding_distance(neighbours[i]);
+  }
+}
+
+/**
+ * @brief Evicts the most crowded individuals until the archive is within its
+ * bound.
+ *
+ * @param newest An individual to keep track of, or the number of individuals
+ * for none.
+ * @return Whether that individual was evicted.
+ */
+bool ND_Tree::truncate(unsigned newest) {
+  bool is_newest_evicted = false;
+
+  while (this->archive.size() > this->max_num_individuals) {
+    if (this->are_crowding_distances_stale) {
+      this->compute_crowding_distances();
+    }
+
+    const unsigned index = this->crowding_heap.front(),
+                   last = this->archive.size() - 1;
+
+    this->remove(index);
+
+    if (!is_newest_evicted) {
+      if (index == newest) {
+        is_newest_evicted = true;
+      } else if (newest == last) {
+        newest = index;
+      }
+    }
+  }
+
+  return is_newest_evicted;
+}
+
+/**
+ * @brief Constructs a new empty archive, which cannot be updated.
+ */
+ND_Tree::ND_Tree() { this->clear(); }
+
+/**
+ * @brief Constructs a new empty archive.
+ *
+ * @param senses The optimisation senses.
+ *
+ * @throws std::runtime_error If there are not num_objectives senses.
+ */
+ND_Tree::ND_Tree(const std::vector<NSBRKGA::Sense>& senses) : senses(senses) {
+  if (this->senses.size() != num_objectives) {
+    throw std::runtime_error("The ND-Tree needs " +
+                             std::to_string(num_objectives) + " objectives.");
+  }
+
+  this->clear();
+}
+
+/**
+ * @brief Adds an individual to the archive, unless some individual of the
+ * archive dominates it or is equal to it, and removes the individuals it
+ * dominates. A bounded archive then evicts its most crowded individuals.
+ *
+ * @param individual The individual.
+ * @return true if the archive is modified; false otherwise.
+ *
+ * @throws std::runtime_error If the individual does not have num_objectives
+ * objective values.
+ */
+bool ND_Tree::update(const Individual& individual) {
+  return this->update(
+      Span<const double>(individual.first.data(), individual.first.size()),
+      Span<const double>(individual.second.data(), individual.second.size()));
+}
+
+/**
+ * @brief Adds an individual to the archive as update does, reading it from
+ * views of its objective values and chromosome, which are only copied if it is
+ * admitted.
+ *
+ * @param value The objective values of the individual.
+ * @param chromosome The chromosome of the individual.
+ * @return true if the archive is modified; false otherwise.
+ *
+ * @throws std::runtime_error If the individual does not have num_objectives
+ * objective values.
+ */
+bool ND_Tree::update(Span<const double> value, Span<const double> chromosome) {
+  if (this->senses.size() != num_objectives || value.size() != num_objectives) {
+    throw std::runtime_error("The ND-Tree needs " +
+                             std::to_string(num_objectives) + " objectives.");
+  }
+
+  const Point point = to_objective_point(value.data(), this->senses);
+
+  if (this->is_covered(this->root, point)) {
+    return false;
+  }
+
+  this->dominated.clear();
+  this->collect_dominated(this->root, point);
+
+  // Removing from the back keeps the indices still to be removed valid.
+  std::sort(this->dominated.begin(), this->dominated.end(),
+            std::greater<unsigned>());
+
+  for (unsigned index : this->dominated) {
+    this->remove(index);
+  }
+
+  const unsigned index = this->archive.size();
+
+  this->archive.emplace_back(
+      std::vector<double>(value.begin(), value.end()),
+      std::vector<double>(chromosome.begin(), chromosome.end()));
+  this->points.push_back(point);
+  this->locations.emplace_back();
+  this->insert(index);
+
+  if (this->is_bounded()) {
+    this->add_to_orders(index);
+
+    if (this->truncate(index)) {
+      return !this->dominated.empty();
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Returns whether some individual of the archive dominates a value or is
+ * equal to it, which update would then reject.
+ *
+ * @param value The objective values.
+ * @return true if the value is covered; false otherwise.
+ *
+ * @throws std::runtime_error If the value does not have num_objectives
+ * objective values.
+ */
+bool ND_Tree::covers(const std::vector<double>& value) const {
+  if (this->senses.size() != num_objectives ||
+      value.size() != num_objectives) {
+    throw std::runtime_error("The ND-Tree needs " +
+                             std::to_string(num_objectives) + " objectives.");
+  }
+
+  return this->is_covered(this->root, to_objective_point(value, this->senses));
+}
+
+/**
+ * @brief Replaces the individuals of the archive, which are assumed to be
+ * mutually non-dominated. A bounded archive then evicts its most crowded
+ * individuals.
+ *
+ * @param individuals The individuals.
+ */
+void ND_Tree::assign(const std::vector<Individual>& individuals) {
+  this->clear();
+  this->archive = individuals;
+  this->points.reserve(individuals.size());
+  this->locations.resize(individuals.size());
+
+  for (unsigned i = 0; i < individuals.size(); i++) {
+    this->points.push_back(
+        to_objective_point(individuals[i].first, this->senses));
+    this->insert(i);
+  }
+
+  this->build_orders();
+  this->truncate(this->archive.size());
+}
+
+/**
+ * @brief Bounds the number of individuals, evicting the most crowded ones if
+ * there are too many. The crowding distance of an individual is the sum, over
+ * the objectives, of the gap between its two neighbours divided by the range of
+ * the objective, and it is infinite for the extreme individuals.
+ *
+ * @param max_size The maximum number of individuals, or the largest unsigned
+ * value for none.
+ */
+void ND_Tree::set_max_size(unsigned max_size) {
+  this->max_num_individuals = max_size;
+  this->build_orders();
+  this->truncate(this->archive.size());
+}
+
+/**
+ * @brief Removes all the individuals.
+ */
+void ND_Tree::clear() {
+  this->archive.clear();
+  this->points.clear();
+  this->locations.clear();
+  this->nodes.clear();
+  this->free_nodes.clear();
+  this->root = this->new_node(no_node, true);
+  this->build_orders();
+}
+
+}  // namespace mopop
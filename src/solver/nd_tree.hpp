@@ -0,0 +1,471 @@
+#pragma once
+
+#include <array>
+#include <limits>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "nsbrkga.hpp"
+#include "solution/objective_point.hpp"
+#include "utils/span.hpp"
+
+namespace mopop {
+/**
+ * @class ND_Tree
+ * @brief An archive of mutually non-dominated individuals, indexed by an
+ * ND-Tree over their four objective values.
+ *
+ * Every node of the tree bounds the values below it by an ideal and a nadir
+ * point, so a dominance query only descends into the nodes whose box may hold
+ * an individual that dominates, or is dominated by, the one being compared.
+ * The individuals themselves are kept in a flat vector in no particular order,
+ * and one is removed in constant time by moving the last one into its place.
+ *
+ * Two values are compared as in Solution::dominates, with a tolerance of
+ * machine epsilon, and a value equal to one of the archive within that
+ * tolerance is rejected.
+ *
+ * The archive may be bounded. It then keeps the individuals sorted by each
+ * objective, and in a heap by crowding distance, and evicts the most crowded
+ * individual whenever it grows past the bound. Adding or evicting an
+ * individual only updates the crowding distances of its neighbours, unless it
+ * changes the range of an objective, which rescales every distance.
+ */
+class ND_Tree {
+ public:
+  /**
+   * @brief An individual, made of its objective values and its chromosome.
+   */
+  typedef std::pair<std::vector<double>, std::vector<double>> Individual;
+
+  /**
+   * @brief The number of objectives the tree is specialised for.
+   */
+  static constexpr unsigned num_objectives = 4;
+
+  /**
+   * @brief The number of individuals above which a leaf is split.
+   */
+  static constexpr unsigned max_leaf_size = 20;
+
+  /**
+   * @brief The number of children of a split leaf.
+   */
+  static constexpr unsigned num_children = num_objectives + 1;
+
+ private:
+  /**
+   * @brief The objective values of an individual, all to be minimised.
+   */
+  typedef Objective_Point Point;
+
+  /**
+   * @brief A node of the tree, either a leaf holding individuals or an inner
+   * node holding other nodes.
+   */
+  struct Node {
+    /**
+     * @brief The componentwise minimum of the points below the node.
+     */
+    Point ideal;
+
+    /**
+     * @brief The componentwise maximum of the points below the node.
+     */
+    Point nadir;
+
+    /**
+     * @brief The parent node, or no_node at the root.
+     */
+    unsigned parent;
+
+    /**
+     * @brief Whether the node is a leaf.
+     */
+    bool is_leaf;
+
+    /**
+     * @brief The child nodes of an inner node.
+     */
+    std::vector<unsigned> children;
+
+    /**
+     * @brief The indices of the individuals of a leaf.
+     */
+    std::vector<unsigned> members;
+  };
+
+  /**
+   * @brief The index that stands for no node.
+   */
+  static constexpr unsigned no_node = ~0u;
+
+  /**
+   * @brief The optimisation senses.
+   */
+  std::vector<NSBRKGA::Sense> senses;
+
+  /**
+   * @brief The individuals of the archive.
+   */
+  std::vector<Individual> archive;
+
+  /**
+   * @brief The points of the individuals, in the same order.
+   */
+  std::vector<Point> points;
+
+  /**
+   * @brief The leaf of each individual and its position among the members of
+   * the leaf, in the same order.
+   */
+  std::vector<std::pair<unsigned, unsigned>> locations;
+
+  /**
+   * @brief The nodes of the tree, some of which may be unused.
+   */
+  std::vector<Node> nodes;
+
+  /**
+   * @brief The unused nodes.
+   */
+  std::vector<unsigned> free_nodes;
+
+  /**
+   * @brief The root node.
+   */
+  unsigned root = no_node;
+
+  /**
+   * @brief The individuals dominated by the one being added.
+   */
+  std::vector<unsigned> dominated;
+
+  /**
+   * @brief The maximum number of individuals.
+   */
+  unsigned max_num_individuals = std::numeric_limits<unsigned>::max();
+
+  /**
+   * @brief The individuals of a bounded archive sorted by each objective.
+   */
+  std::array<std::multimap<double, unsigned>, num_objectives> orders;
+
+  /**
+   * @brief The entries of each individual of a bounded archive in the orders.
+   */
+  std::vector<
+      std::array<std::multimap<double, unsigned>::iterator, num_objectives>>
+      order_entries;
+
+  /**
+   * @brief The crowding distances of the individuals of a bounded archive.
+   */
+  std::vector<double> crowding_distances;
+
+  /**
+   * @brief A binary min-heap of the individuals of a bounded archive by
+   * crowding distance.
+   */
+  std::vector<unsigned> crowding_heap;
+
+  /**
+   * @brief The position of each individual of a bounded archive in the heap.
+   */
+  std::vector<unsigned> heap_positions;
+
+  /**
+   * @brief Whether the range of some objective has changed since the crowding
+   * distances were computed, which leaves them all to be recomputed.
+   */
+  bool are_crowding_distances_stale = false;
+
+  /**
+   * @brief Creates an empty node.
+   *
+   * @param parent The parent of the node.
+   * @param is_leaf Whether the node is a leaf.
+   * @return The node.
+   */
+  unsigned new_node(unsigned parent, bool is_leaf);
+
+  /**
+   * @brief Returns the squared distance between a point and the centre of the
+   * box of a node, with every objective scaled by the range of the archive.
+   *
+   * @param node The node.
+   * @param point The point.
+   * @return The distance.
+   */
+  double distance(unsigned node, const Point& point) const;
+
+  /**
+   * @brief Returns whether some individual below a node dominates a point or
+   * is equal to it.
+   *
+   * @param node The node.
+   * @param point The point.
+   * @return true if the point is covered; false otherwise.
+   */
+  bool is_covered(unsigned node, const Point& point) const;
+
+  /**
+   * @brief Appends the individuals below a node dominated by a point to the
+   * dominated individuals.
+   *
+   * @param node The node.
+   * @param point The point.
+   */
+  void collect_dominated(unsigned node, const Point& point);
+
+  /**
+   * @brief Appends all the individuals below a node to the dominated
+   * individuals.
+   *
+   * @param node The node.
+   */
+  void collect_all(unsigned node);
+
+  /**
+   * @brief Places an individual in the leaf whose box is the closest to it.
+   *
+   * @param index The individual.
+   */
+  void insert(unsigned index);
+
+  /**
+   * @brief Adds an individual to a leaf, extending the box of the leaf.
+   *
+   * @param leaf The leaf.
+   * @param index The individual.
+   */
+  void add_member(unsigned leaf, unsigned index);
+
+  /**
+   * @brief Splits a leaf into num_children leaves.
+   *
+   * @param leaf The leaf.
+   */
+  void split(unsigned leaf);
+
+  /**
+   * @brief Removes an individual from the archive.
+   *
+   * @param index The individual.
+   */
+  void remove(unsigned index);
+
+  /**
+   * @brief Removes an empty node from the tree.
+   *
+   * @param node The node.
+   */
+  void detach(unsigned node);
+
+  /**
+   * @brief Recomputes the box of a node from its members or children, and then
+   * the boxes of its ancestors, as long as they change.
+   *
+   * @param node The node.
+   */
+  void shrink(unsigned node);
+
+  /**
+   * @brief Returns whether the archive is bounded.
+   */
+  bool is_bounded() const {
+    return this->max_num_individuals != std::numeric_limits<unsigned>::max();
+  }
+
+  /**
+   * @brief Computes the crowding distance of an individual of a bounded
+   * archive from its neighbours in each objective.
+   *
+   * @param index The individual.
+   * @return The crowding distance.
+   */
+  double crowding_distance(unsigned index) const;
+
+  /**
+   * @brief Recomputes the crowding distance of an individual of a bounded
+   * archive.
+   *
+   * @param index The individual.
+   */
+  void update_crowding_distance(unsigned index);
+
+  /**
+   * @brief Places an individual at a position of the heap.
+   *
+   * @param position The position.
+   * @param index The individual.
+   */
+  void set_heap_position(unsigned position, unsigned index);
+
+  /**
+   * @brief Moves an individual towards the top of the heap while it is more
+   * crowded than its parent.
+   *
+   * @param index The individual.
+   */
+  void sift_up(unsigned index);
+
+  /**
+   * @brief Moves an individual towards the bottom of the heap while it is less
+   * crowded than one of its children.
+   *
+   * @param index The individual.
+   */
+  void sift_down(unsigned index);
+
+  /**
+   * @brief Removes an individual from the heap.
+   *
+   * @param index The individual.
+   */
+  void remove_from_heap(unsigned index);
+
+  /**
+   * @brief Recomputes the crowding distances of all the individuals of a
+   * bounded archive.
+   */
+  void compute_crowding_distances();
+
+  /**
+   * @brief Sorts the individuals of a bounded archive by each objective and
+   * computes their crowding distances.
+   */
+  void build_orders();
+
+  /**
+   * @brief Adds an individual, already in the tree, to the orders of a bounded
+   * archive.
+   *
+   * @param index The individual.
+   */
+  void add_to_orders(unsigned index);
+
+  /**
+   * @brief Removes an individual, still in the tree, from the orders of a
+   * bounded archive.
+   *
+   * @param index The individual.
+   */
+  void remove_from_orders(unsigned index);
+
+  /**
+   * @brief Evicts the most crowded individuals until the archive is within its
+   * bound.
+   *
+   * @param newest An individual to keep track of, or the number of individuals
+   * for none.
+   * @return Whether that individual was evicted.
+   */
+  bool truncate(unsigned newest);
+
+ public:
+  /**
+   * @brief Constructs a new empty archive, which cannot be updated.
+   */
+  ND_Tree();
+
+  /**
+   * @brief Constructs a new empty archive.
+   *
+   * @param senses The optimisation senses.
+   *
+   * @throws std::runtime_error If there are not num_objectives senses.
+   */
+  explicit ND_Tree(const std::vector<NSBRKGA::Sense>& senses);
+
+  /**
+   * @brief Adds an individual to the archive, unless some individual of the
+   * archive dominates it or is equal to it, and removes the individuals it
+   * dominates. A bounded archive then evicts its most crowded individuals.
+   *
+   * @param individual The individual.
+   * @return true if the archive is modified; false otherwise.
+   *
+   * @throws std::runtime_error If the individual does not have num_objectives
+   * objective values.
+   */
+  bool update(const Individual& individual);
+
+  /**
+   * @brief Adds an individual to the archive as update does, reading it from
+   * views of its objective values and chromosome, which are only copied if it
+   * is admitted.
+   *
+   * @param value The objective values of the individual.
+   * @param chromosome The chromosome of the individual.
+   * @return true if the archive is modified; false otherwise.
+   *
+   * @throws std::runtime_error If the individual does not have num_objectives
+   * objective values.
+   */
+  bool update(Span<const double> value, Span<const double> chromosome);
+
+  /**
+   * @brief Returns whether some individual of the archive dominates a value or
+   * is equal to it, which update would then reject.
+   *
+   * @param value The objective values.
+   * @return true if the value is covered; false otherwise.
+   *
+   * @throws std::runtime_error If the value does not have num_objectives
+   * objective values.
+   */
+  bool covers(const std::vector<double>& value) const;
+
+  /**
+   * @brief Replaces the individuals of the archive, which are assumed to be
+   * mutually non-dominated. A bounded archive then evicts its most crowded
+   * individuals.
+   *
+   * @param individuals The individuals.
+   */
+  void assign(const std::vector<Individual>& individuals);
+
+  /**
+   * @brief Returns the maximum number of individuals.
+   */
+  unsigned max_size() const { return this->max_num_individuals; }
+
+  /**
+   * @brief Bounds the number of individuals, evicting the most crowded ones
+   * if there are too many. The crowding distance of an individual is the sum,
+   * over the objectives, of the gap between its two neighbours divided by the
+   * range of the objective, and it is infinite for the extreme individuals.
+   *
+   * @param max_size The maximum number of individuals, or the largest unsigned
+   * value for none.
+   */
+  void set_max_size(unsigned max_size);
+
+  /**
+   * @brief Removes all the individuals.
+   */
+  void clear();
+
+  /**
+   * @brief Returns the individuals, in no particular order.
+   */
+  const std::vector<Individual>& individuals() const { return this->archive; }
+
+  std::size_t size() const { return this->archive.size(); }
+
+  bool empty() const { return this->archive.empty(); }
+
+  const Individual& operator[](std::size_t i) const { return this->archive[i]; }
+
+  std::vector<Individual>::const_iterator begin() const {
+    return this->archive.begin();
+  }
+
+  std::vector<Individual>::const_iterator end() const {
+    return this->archive.end();
+  }
+};
+
+}  // namespace mopop
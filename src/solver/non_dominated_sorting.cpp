@@ -0,0 +1,132 @@
+#include "solver/non_dominated_sorting.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace mopop {
+/**
+ * @brief Returns whether some point of a front dominates a point.
+ *
+ * Only a point before the point in lexicographic order can dominate it, and
+ * every point of the front is. The points added last are the closest to the
+ * point, so they are compared first.
+ *
+ * @param front The front.
+ * @param point The point.
+ * @return true if the point is dominated; false otherwise.
+ */
+bool Non_Dominated_Sorting::is_dominated(unsigned front,
+                                         const Point& point) const {
+  const std::vector<unsigned>& front_members = this->members[front];
+
+  for (auto it = front_members.rbegin(); it != front_members.rend(); it++) {
+    if (dominates(this->points[*it], point, 0.0)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @brief Constructs a new sorting, which cannot sort any point.
+ */
+Non_Dominated_Sorting::Non_Dominated_Sorting() : front_offsets(1, 0) {}
+
+/**
+ * @brief Constructs a new sorting.
+ *
+ * @param senses The optimisation senses.
+ *
+ * @throws std::runtime_error If there are not num_objectives senses.
+ */
+Non_Dominated_Sorting::Non_Dominated_Sorting(
+    const std::vector<NSBRKGA::Sense>& senses)
+    : senses(senses), front_offsets(1, 0) {
+  if (senses.size() != num_objectives) {
+    throw std::runtime_error("The non-dominated sorting needs " +
+                             std::to_string(num_objectives) + " objectives.");
+  }
+}
+
+/**
+ * @brief Sorts points into non-dominated fronts, replacing the fronts of the
+ * points sorted before.
+ *
+ * @param values The objective values of the points.
+ *
+ * @throws std::runtime_error If a point does not have num_objectives objective
+ * values.
+ */
+void Non_Dominated_Sorting::sort(
+    const std::vector<std::vector<double>>& values) {
+  if (this->senses.size() != num_objectives) {
+    throw std::runtime_error("The non-dominated sorting needs " +
+                             std::to_string(num_objectives) + " objectives.");
+  }
+
+  this->points.resize(values.size());
+
+  for (unsigned j = 0; j < values.size(); j++) {
+    if (values[j].size() != num_objectives) {
+      throw std::runtime_error("The non-dominated sorting needs " +
+                               std::to_string(num_objectives) +
+                               " objectives.");
+    }
+
+    this->points[j] = to_objective_point(values[j], this->senses);
+  }
+
+  this->lexicographic_order.resize(values.size());
+
+  for (unsigned j = 0; j < values.size(); j++) {
+    this->lexicographic_order[j] = j;
+  }
+
+  std::sort(this->lexicographic_order.begin(), this->lexicographic_order.end(),
+            [this](unsigned a, unsigned b) {
+              return this->points[a] < this->points[b];
+            });
+
+  // The members of the fronts keep their capacity from one sort to the next.
+  unsigned num_fronts = 0;
+
+  for (unsigned index : this->lexicographic_order) {
+    const Point& point = this->points[index];
+
+    // Whenever a front dominates the point, so does every front before it.
+    unsigned low = 0, high = num_fronts;
+
+    while (low < high) {
+      const unsigned middle = low + (high - low) / 2;
+
+      if (this->is_dominated(middle, point)) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+
+    if (low == num_fronts) {
+      if (this->members.size() == num_fronts) {
+        this->members.emplace_back();
+      }
+
+      this->members[num_fronts++].clear();
+    }
+
+    this->members[low].push_back(index);
+  }
+
+  this->order.clear();
+  this->front_offsets.assign(1, 0);
+
+  for (unsigned k = 0; k < num_fronts; k++) {
+    this->order.insert(this->order.end(), this->members[k].begin(),
+                       this->members[k].end());
+    this->front_offsets.push_back(this->order.size());
+  }
+}
+
+}  // namespace mopop
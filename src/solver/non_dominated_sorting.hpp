@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "nsbrkga.hpp"
+#include "solution/objective_point.hpp"
+#include "utils/span.hpp"
+
+namespace mopop {
+/**
+ * @class Non_Dominated_Sorting
+ * @brief Sorts points of four objectives into non-dominated fronts, with the
+ * efficient non-dominated sort with binary search (ENS-BS).
+ *
+ * The senses are normalised once, every objective being taken as minimised, so
+ * the dominance test neither branches on them nor on the outcome of each
+ * comparison. The points are sorted lexicographically, so that a point can only
+ * be dominated by points before it, and each point then joins the first front
+ * none of whose points dominates it, found by binary search over the fronts.
+ *
+ * A point dominates another if it is no worse on every objective and better on
+ * at least one, with no tolerance, as NSBRKGA::Population::nonDominatedSort
+ * compares them. The fronts are kept as consecutive spans of one array of
+ * indices of the points, so sorting copies no point.
+ */
+class Non_Dominated_Sorting {
+ public:
+  /**
+   * @brief The number of objectives the sorting is specialised for.
+   */
+  static constexpr unsigned num_objectives = 4;
+
+ private:
+  /**
+   * @brief The objective values of a point, all to be minimised.
+   */
+  typedef Objective_Point Point;
+
+  /**
+   * @brief The optimisation senses.
+   */
+  std::vector<NSBRKGA::Sense> senses;
+
+  /**
+   * @brief The points being sorted.
+   */
+  std::vector<Point> points;
+
+  /**
+   * @brief The indices of the points in lexicographic order.
+   */
+  std::vector<unsigned> lexicographic_order;
+
+  /**
+   * @brief The points of each front, while they are being sorted.
+   */
+  std::vector<std::vector<unsigned>> members;
+
+  /**
+   * @brief The indices of the points, front after front, each front in
+   * lexicographic order.
+   */
+  std::vector<unsigned> order;
+
+  /**
+   * @brief The position in the order where each front starts, followed by the
+   * number of points.
+   */
+  std::vector<unsigned> front_offsets;
+
+  /**
+   * @brief Returns whether some point of a front dominates a point.
+   *
+   * @param front The front.
+   * @param point The point.
+   * @return true if the point is dominated; false otherwise.
+   */
+  bool is_dominated(unsigned front, const Point& point) const;
+
+ public:
+  /**
+   * @brief Constructs a new sorting, which cannot sort any point.
+   */
+  Non_Dominated_Sorting();
+
+  /**
+   * @brief Constructs a new sorting.
+   *
+   * @param senses The optimisation senses.
+   *
+   * @throws std::runtime_error If there are not num_objectives senses.
+   */
+  explicit Non_Dominated_Sorting(const std::vector<NSBRKGA::Sense>& senses);
+
+  /**
+   * @brief Sorts points into non-dominated fronts, replacing the fronts of the
+   * points sorted before.
+   *
+   * @param values The objective values of the points.
+   *
+   * @throws std::runtime_error If a point does not have num_objectives
+   * objective values.
+   */
+  void sort(const std::vector<std::vector<double>>& values);
+
+  /**
+   * @brief Returns the number of fronts.
+   */
+  unsigned num_fronts() const { return this->front_offsets.size() - 1; }
+
+  /**
+   * @brief Returns the indices of the points of a front, in lexicographic
+   * order of their normalised objective values. The first front holds the
+   * non-dominated points, and each later front the points that only points of
+   * the fronts before it dominate.
+   *
+   * @param i The front.
+   * @return The indices.
+   */
+  Span<const unsigned> front(unsigned i) const {
+    return Span<const unsigned>(
+        this->order.data() + this->front_offsets[i],
+        this->front_offsets[i + 1] - this->front_offsets[i]);
+  }
+};
+
+}  // namespace mopop
@@ -2,68 +2,38 @@
 
 #include <algorithm>
 
+#include "evaluator/incremental_evaluator.hpp"
+
 namespace mopop {
 
-Decoder::Decoder(const Instance& instance, unsigned num_threads)
-    : instance(instance),
-      weights(num_threads, std::vector<double>(instance.num_assets, 0.0)),
-      total_weights(num_threads, 0.0),
-      values(num_threads, std::vector<double>(4, 0.0)) {}
+Decoder::Decoder(const Instance& instance) : instance(instance) {}
 
 std::vector<double> Decoder::decode(NSBRKGA::Chromosome& chromosome,
                                     bool rewrite) {
-#ifdef _OPENMP
-  std::vector<double>& weight = this->weights[omp_get_thread_num()];
-  double& total_weight = this->total_weights[omp_get_thread_num()];
-  std::vector<double>& value = this->values[omp_get_thread_num()];
-#else
-  std::vector<double>& weight = this->weights.front();
-  double& total_weight = this->total_weights.front();
-  std::vector<double>& value = this->values.front();
-#endif
-  total_weight = 0.0;
-
-  for (unsigned i = 0; i < this->instance.num_assets; i++) {
-    weight[i] = chromosome[i];
-    total_weight += weight[i];
-  }
-
-  if (total_weight > 0.0) {
-    for (unsigned i = 0; i < this->instance.num_assets; i++) {
-      weight[i] /= total_weight;
-    }
-  } else {
-    // A degenerate all-zero chromosome carries no information; decode it as the
-    // uniform portfolio so that every solution is a valid portfolio whose
-    // weights sum to 1. Keep in sync with Solution's constructor.
-    for (unsigned i = 0; i < this->instance.num_assets; i++) {
-      weight[i] = 1.0 / ((double)this->instance.num_assets);
-    }
+  Incremental_Evaluator* evaluator;
+  std::vector<double> value(4, 0.0);
+
+  // Mutation, shaking and path relinking change a few genes of a chromosome
+  // and decode it again, which the evaluator of that chromosome updates in
+  // O(n k), while a new chromosome in its place is decoded from scratch. Its
+  // values only depend on what was decoded in its place before, never on which
+  // thread decodes what. A degenerate all-zero chromosome is decoded as the
+  // uniform portfolio, the same way Solution's constructor does.
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    evaluator = &this->evaluators.try_emplace(&chromosome, this->instance)
+                     .first->second;
   }
 
-  value[0] = 0.0;
-  value[1] = 0.0;
-  value[3] = 0.0;
-
-  for (unsigned i = 0; i < this->instance.num_assets; i++) {
-    value[0] += weight[i] * this->instance.expected_returns[i];
-
-    for (unsigned j = 0; j < this->instance.num_assets; j++) {
-      value[1] += weight[i] * weight[j] * instance.covariance_matrix[i][j];
-    }
+  evaluator->evaluate(chromosome.data(), value.data());
 
-    if (weight[i] > 0.0) {
-      value[3] -= weight[i] * std::log2(weight[i]);
-    }
-  }
+  return value;
+}
 
-  if (value[1] > 0.0) {
-    value[2] = value[0] / std::sqrt(value[1]);
-  } else {
-    value[2] = 0.0;
+void Decoder::trim(std::size_t max_num_chromosomes) {
+  if (this->evaluators.size() > max_num_chromosomes) {
+    this->evaluators.clear();
   }
-
-  return value;
 }
 
 }  // namespace mopop
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <mutex>
+#include <unordered_map>
+
 #include "chromosome.hpp"
+#include "evaluator/incremental_evaluator.hpp"
 #include "solution/solution.hpp"
 
 namespace mopop {
@@ -9,15 +13,16 @@ class Decoder {
  public:
   const Instance& instance;
 
-  std::vector<std::vector<double>> weights;
-
-  std::vector<double> total_weights;
+  std::unordered_map<const NSBRKGA::Chromosome*, Incremental_Evaluator>
+      evaluators;
 
-  std::vector<std::vector<double>> values;
+  std::mutex mutex;
 
-  Decoder(const Instance& instance, unsigned num_threads);
+  Decoder(const Instance& instance);
 
   std::vector<double> decode(NSBRKGA::Chromosome& chromosome, bool rewrite);
+
+  void trim(std::size_t max_num_chromosomes);
 };
 
 }  // namespace mopop
@@ -16,22 +16,14 @@ NSBRKGA_Solver::NSBRKGA_Solver(const Instance &instance)
 NSBRKGA_Solver::NSBRKGA_Solver() = default;
 
 /**
- * @brief Captures a snapshot of the current population.
+ * @brief Captures a snapshot of the current population, at the last reading of
+ * the clock, either into a slab of the snapshot writer or into memory.
  *
  * @param algorithm The current state of the algorithm.
  */
 void NSBRKGA_Solver::capture_snapshot(
     const NSBRKGA::NSBRKGA<Decoder> &algorithm) {
-  double time_snapshot = this->elapsed_time();
-
-  this->best_solutions_snapshots.emplace_back(std::make_tuple(
-      this->num_iterations, time_snapshot,
-      std::vector<std::vector<double>>(this->best_individuals.size())));
-
-  for (std::size_t i = 0; i < this->best_individuals.size(); i++) {
-    std::get<2>(this->best_solutions_snapshots.back())[i] =
-        this->best_individuals[i].first;
-  }
+  const double time_snapshot = this->current_time;
 
   this->num_non_dominated.resize(this->num_populations);
   this->num_fronts.resize(this->num_populations);
@@ -44,6 +36,41 @@ void NSBRKGA_Solver::capture_snapshot(
     this->num_elites[i] = algorithm.getCurrentPopulation(i).num_elites;
   }
 
+  if (this->snapshot_writer) {
+    Snapshot &snapshot = this->stream_snapshot(time_snapshot);
+
+    snapshot.num_non_dominated = this->num_non_dominated;
+    snapshot.num_fronts = this->num_fronts;
+    snapshot.num_elites = this->num_elites;
+    snapshot.populations.resize(this->num_populations);
+
+    for (unsigned i = 0; i < this->num_populations; i++) {
+      snapshot.populations[i].resize(this->population_size);
+
+      for (unsigned j = 0; j < this->population_size; j++) {
+        const auto &fitness = algorithm.getCurrentPopulation(i).getFitness(j);
+
+        snapshot.populations[i][j].assign(fitness.begin(), fitness.end());
+      }
+    }
+
+    this->snapshot_writer->publish();
+    this->snapshot_scheduler.record(this->num_iterations, time_snapshot);
+
+    return;
+  }
+
+  this->best_solutions_snapshots.emplace_back(std::make_tuple(
+      this->num_iterations, time_snapshot,
+      std::vector<std::vector<double>>(this->best_individuals.size())));
+
+  for (std::size_t i = 0; i < this->best_individuals.size(); i++) {
+    std::get<2>(this->best_solutions_snapshots.back())[i] =
+        this->best_individuals[i].first;
+  }
+
+  this->capture_hypervolume_snapshot(time_snapshot);
+
   this->num_non_dominated_snapshots.push_back(std::make_tuple(
       this->num_iterations, time_snapshot, this->num_non_dominated));
 
@@ -67,18 +94,16 @@ void NSBRKGA_Solver::capture_snapshot(
   this->num_elites_snapshots.push_back(
       std::make_tuple(this->num_iterations, time_snapshot, this->num_elites));
 
-  this->time_last_snapshot = time_snapshot;
-  this->iteration_last_snapshot = this->num_iterations;
-  this->num_snapshots++;
+  this->snapshot_scheduler.record(this->num_iterations, time_snapshot);
 }
 
 /**
  * @brief Solves the instance.
  */
 void NSBRKGA_Solver::solve() {
-  this->start_time = std::chrono::steady_clock::now();
+  this->start_solving();
 
-  Decoder decoder(this->instance, this->num_threads);
+  Decoder decoder(this->instance);
 
   NSBRKGA::NsbrkgaParams params;
   params.num_incumbent_solutions = this->max_num_solutions;
@@ -107,44 +132,22 @@ void NSBRKGA_Solver::solve() {
   algorithm.initialize();
 
   this->update_best_individuals(algorithm.getIncumbentSolutions());
+  this->read_clock();
 
-  if (this->max_num_snapshots > this->num_snapshots + 1) {
+  if (this->snapshot_scheduler.is_due(this->num_iterations,
+                                      this->current_time)) {
     this->capture_snapshot(algorithm);
-
-    if (this->time_limit < std::numeric_limits<double>::max()) {
-      this->time_snapshot_factor =
-          std::pow(this->time_limit / this->time_last_snapshot,
-                   1.0 / (this->max_num_snapshots - this->num_snapshots));
-      this->time_next_snapshot =
-          this->time_last_snapshot * this->time_snapshot_factor;
-    } else {
-      this->time_next_snapshot = std::numeric_limits<double>::max();
-      this->time_snapshot_factor = 1.0;
-    }
-
-    if (this->iterations_limit < std::numeric_limits<unsigned>::max()) {
-      this->iteration_snapshot_factor = std::pow(
-          this->iterations_limit / (this->iteration_last_snapshot + 1.0),
-          1.0 / (this->max_num_snapshots - this->num_snapshots));
-      this->iteration_next_snapshot =
-          unsigned(std::round(double(this->iteration_last_snapshot) *
-                              this->iteration_snapshot_factor));
-    } else {
-      this->iteration_next_snapshot = std::numeric_limits<unsigned>::max();
-      this->iteration_snapshot_factor = 1.0;
-    }
-  } else {
-    this->time_next_snapshot = 0.0;
-    this->iteration_next_snapshot = 0;
-    this->time_snapshot_factor = 1.0;
-    this->iteration_snapshot_factor = 1.0;
   }
 
   while (!this->are_termination_criteria_met()) {
     this->num_iterations++;
 
-    if (algorithm.evolve()) {
-      this->last_update_time = this->elapsed_time();
+    const bool is_improved = algorithm.evolve();
+
+    this->read_clock();
+
+    if (is_improved) {
+      this->last_update_time = this->current_time;
 
       auto update_offset = this->num_iterations - this->last_update_generation;
       this->last_update_generation = this->num_iterations;
@@ -156,46 +159,9 @@ void NSBRKGA_Solver::solve() {
       this->update_best_individuals(algorithm.getIncumbentSolutions());
     }
 
-    if (this->max_num_snapshots > this->num_snapshots + 1) {
-      if (this->num_iterations >= this->iteration_next_snapshot) {
-        this->capture_snapshot(algorithm);
-
-        if (this->time_limit < std::numeric_limits<double>::max()) {
-          this->time_next_snapshot =
-              this->time_last_snapshot * this->time_snapshot_factor;
-          this->time_snapshot_factor =
-              std::pow(this->time_limit / this->time_last_snapshot,
-                       1.0 / (this->max_num_snapshots - this->num_snapshots));
-        }
-
-        if (this->iterations_limit < std::numeric_limits<unsigned>::max()) {
-          this->iteration_next_snapshot =
-              unsigned(std::round(double(this->iteration_last_snapshot) *
-                                  this->iteration_snapshot_factor));
-          this->iteration_snapshot_factor =
-              std::pow(this->iterations_limit / this->iteration_last_snapshot,
-                       1.0 / (this->max_num_snapshots - this->num_snapshots));
-        }
-      } else if (this->elapsed_time() >= this->time_next_snapshot) {
-        this->capture_snapshot(algorithm);
-
-        if (this->time_limit < std::numeric_limits<double>::max()) {
-          this->time_next_snapshot =
-              this->time_last_snapshot * this->time_snapshot_factor;
-          this->time_snapshot_factor =
-              std::pow(this->time_limit / this->time_last_snapshot,
-                       1.0 / (this->max_num_snapshots - this->num_snapshots));
-        }
-
-        if (this->iterations_limit < std::numeric_limits<unsigned>::max()) {
-          this->iteration_next_snapshot =
-              unsigned(std::round(double(this->iteration_last_snapshot) *
-                                  this->iteration_snapshot_factor));
-          this->iteration_snapshot_factor =
-              std::pow(this->iterations_limit / this->iteration_last_snapshot,
-                       1.0 / (this->max_num_snapshots - this->num_snapshots));
-        }
-      }
+    if (this->snapshot_scheduler.is_due(this->num_iterations,
+                                        this->current_time)) {
+      this->capture_snapshot(algorithm);
     }
 
     unsigned generations_without_improvement =
@@ -227,6 +193,10 @@ void NSBRKGA_Solver::solve() {
       const auto pr_time = Solver::elapsed_time(pr_start_time);
       this->path_relink_time += pr_time;
 
+      // The relink may take much longer than a generation, so the termination
+      // criteria must not go by the reading before it.
+      this->read_clock();
+
       switch (result) {
         case NSBRKGA::PathRelinking::PathRelinkingResult::ELITE_IMPROVEMENT: {
           this->num_elite_improvments++;
@@ -235,7 +205,7 @@ void NSBRKGA_Solver::solve() {
 
         case NSBRKGA::PathRelinking::PathRelinkingResult::BEST_IMPROVEMENT: {
           this->num_best_improvements++;
-          this->last_update_time = this->elapsed_time();
+          this->last_update_time = this->current_time;
 
           auto update_offset =
               this->num_iterations - this->last_update_generation;
@@ -266,6 +236,11 @@ void NSBRKGA_Solver::solve() {
       this->num_resets++;
       algorithm.reset(this->reset_intensity);
     }
+
+    // Path relinking decodes chromosomes outside the populations, whose
+    // evaluators are dropped here, between two steps, where it does not depend
+    // on the threads.
+    decoder.trim(4 * this->num_populations * this->population_size);
   }
 
   if (this->max_num_snapshots > 0) {
@@ -280,6 +255,7 @@ void NSBRKGA_Solver::solve() {
   }
 
   this->solving_time = this->elapsed_time();
+  this->update_hypervolume();
 }
 
 std::ostream &operator<<(std::ostream &os, const NSBRKGA_Solver &solver) {
@@ -327,8 +303,6 @@ std::ostream &operator<<(std::ostream &os, const NSBRKGA_Solver &solver) {
      << "Interval at which the populations are reset: " << solver.reset_interval
      << std::endl
      << "The intensity of the reset: " << solver.reset_intensity << std::endl
-     << "Number of threads to be used during parallel decoding: "
-     << solver.num_threads << std::endl
      << "Last update generation: " << solver.last_update_generation << std::endl
      << "Last update time: " << solver.last_update_time << std::endl
      << "Largest number of generations between improvements: "
@@ -124,11 +124,6 @@ class NSBRKGA_Solver : public Solver {
    */
   double reset_intensity = 0.20;
 
-  /**
-   * @brief The number of threads to be used during parallel decoding.
-   */
-  unsigned num_threads = 1;
-
   /**
    * @brief The maximum number of local search iterations allowed.
    */
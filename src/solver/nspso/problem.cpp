@@ -1,18 +1,39 @@
 #include "solver/nspso/problem.hpp"
 
+#include "evaluator/evaluator.hpp"
 #include "solution/solution.hpp"
 
 namespace mopop {
 
-Problem::Problem(const Instance& instance) : instance(instance) {}
+Problem::Problem(const Instance& instance, Archive_Feed* archive_feed)
+    : instance(instance), archive_feed(archive_feed) {}
 
 Problem::Problem() {}
 
 pagmo::vector_double Problem::fitness(const pagmo::vector_double& dv) const {
   Solution solution(this->instance, dv);
+
+  if (this->archive_feed != nullptr) {
+    this->archive_feed->add(solution.value, dv);
+  }
+
   return solution.value;
 }
 
+pagmo::vector_double Problem::batch_fitness(
+    const pagmo::vector_double& dvs) const {
+  const std::size_t num_dvs = dvs.size() / this->instance.num_assets;
+  pagmo::vector_double weights(dvs.size()), fitnesses(num_dvs * 4);
+  evaluate_batch(this->instance, dvs.data(), num_dvs, weights.data(),
+                 fitnesses.data());
+
+  if (this->archive_feed != nullptr) {
+    this->archive_feed->add_batch(fitnesses, dvs);
+  }
+
+  return fitnesses;
+}
+
 std::pair<pagmo::vector_double, pagmo::vector_double> Problem::get_bounds()
     const {
   return std::make_pair(pagmo::vector_double(this->instance.num_assets, 0.0),
@@ -21,4 +42,8 @@ std::pair<pagmo::vector_double, pagmo::vector_double> Problem::get_bounds()
 
 pagmo::vector_double::size_type Problem::get_nobj() const { return 4; }
 
+pagmo::thread_safety Problem::get_thread_safety() const {
+  return pagmo::thread_safety::constant;
+}
+
 }  // namespace mopop
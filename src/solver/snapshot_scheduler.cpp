@@ -0,0 +1,117 @@
+#include "solver/snapshot_scheduler.hpp"
+
+#include <cmath>
+
+namespace mopop {
+/**
+ * @brief Starts a new schedule, with no snapshot taken.
+ *
+ * @param time_limit The time limit in seconds.
+ * @param iterations_limit The iterations limit.
+ * @param max_num_snapshots The maximum number of snapshots, including the last
+ * one.
+ */
+void Snapshot_Scheduler::start(double time_limit, unsigned iterations_limit,
+                               unsigned max_num_snapshots) {
+  this->time_limit = time_limit;
+  this->iterations_limit = iterations_limit;
+  this->max_num_snapshots = max_num_snapshots;
+  this->num_snapshots = 0;
+  this->time_snapshot_factor = 1.0;
+  this->iteration_snapshot_factor = 1.0;
+  this->time_next_snapshot = 0.0;
+  this->time_last_snapshot = 0.0;
+  this->iteration_next_snapshot = 0;
+  this->iteration_last_snapshot = 0;
+}
+
+/**
+ * @brief Verifies whether snapshots other than the last one remain to be
+ * taken.
+ *
+ * @return true if snapshots remain; false otherwise.
+ */
+bool Snapshot_Scheduler::is_active() const {
+  return this->max_num_snapshots > this->num_snapshots + 1;
+}
+
+/**
+ * @brief Verifies whether a snapshot is due, which the first one is before the
+ * first iteration.
+ *
+ * @param iteration The current iteration.
+ * @param time The current time in seconds.
+ * @return true if a snapshot is due; false otherwise.
+ */
+bool Snapshot_Scheduler::is_due(unsigned iteration, double time) const {
+  return this->is_active() && (iteration >= this->iteration_next_snapshot ||
+                               time >= this->time_next_snapshot);
+}
+
+/**
+ * @brief Records a snapshot and, if it was taken while snapshots remained,
+ * schedules the next.
+ *
+ * After the first snapshot the factors are chosen so that the remaining ones
+ * reach the limits. After each of the others the next snapshot is scheduled
+ * with the factor in effect, which is then recomputed from the snapshot.
+ *
+ * @param iteration The iteration of the snapshot.
+ * @param time The time of the snapshot in seconds.
+ */
+void Snapshot_Scheduler::record(unsigned iteration, double time) {
+  const bool was_active = this->is_active();
+
+  this->time_last_snapshot = time;
+  this->iteration_last_snapshot = iteration;
+  this->num_snapshots++;
+
+  if (!was_active) {
+    return;
+  }
+
+  const double exponent = 1.0 / (this->max_num_snapshots - this->num_snapshots);
+
+  if (this->num_snapshots == 1) {
+    if (this->time_limit < std::numeric_limits<double>::max()) {
+      this->time_snapshot_factor =
+          std::pow(this->time_limit / this->time_last_snapshot, exponent);
+      this->time_next_snapshot =
+          this->time_last_snapshot * this->time_snapshot_factor;
+    } else {
+      this->time_next_snapshot = std::numeric_limits<double>::max();
+      this->time_snapshot_factor = 1.0;
+    }
+
+    if (this->iterations_limit < std::numeric_limits<unsigned>::max()) {
+      this->iteration_snapshot_factor = std::pow(
+          this->iterations_limit / (this->iteration_last_snapshot + 1.0),
+          exponent);
+      this->iteration_next_snapshot =
+          unsigned(std::round(double(this->iteration_last_snapshot) *
+                              this->iteration_snapshot_factor));
+    } else {
+      this->iteration_next_snapshot = std::numeric_limits<unsigned>::max();
+      this->iteration_snapshot_factor = 1.0;
+    }
+
+    return;
+  }
+
+  if (this->time_limit < std::numeric_limits<double>::max()) {
+    this->time_next_snapshot =
+        this->time_last_snapshot * this->time_snapshot_factor;
+    this->time_snapshot_factor =
+        std::pow(this->time_limit / this->time_last_snapshot, exponent);
+  }
+
+  if (this->iterations_limit < std::numeric_limits<unsigned>::max()) {
+    this->iteration_next_snapshot =
+        unsigned(std::round(double(this->iteration_last_snapshot) *
+                            this->iteration_snapshot_factor));
+    this->iteration_snapshot_factor = std::pow(
+        this->iterations_limit / this->iteration_last_snapshot, exponent);
+  }
+}
+
+}  // namespace mopop
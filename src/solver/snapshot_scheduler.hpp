@@ -0,0 +1,108 @@
+#pragma once
+
+#include <limits>
+
+namespace mopop {
+/**
+ * @class Snapshot_Scheduler
+ * @brief Schedules the snapshots taken during optimization, at iterations and
+ * times growing geometrically towards the iterations limit and the time limit.
+ *
+ * The first snapshot is taken before the first iteration and the last one
+ * when the optimization stops, outside the schedule. Each of the others is
+ * taken as soon as either its iteration or its time is reached. The scheduler
+ * never reads the clock itself, so that a solver may read it once per
+ * generation and compare every deadline with that reading.
+ */
+class Snapshot_Scheduler {
+ public:
+  /**
+   * @brief The time limit in seconds.
+   */
+  double time_limit = std::numeric_limits<double>::max();
+
+  /**
+   * @brief The iterations limit.
+   */
+  unsigned iterations_limit = std::numeric_limits<unsigned>::max();
+
+  /**
+   * @brief The maximum number of snapshots, including the last one.
+   */
+  unsigned max_num_snapshots = 0;
+
+  /**
+   * @brief The number of snapshots taken.
+   */
+  unsigned num_snapshots = 0;
+
+  /**
+   * @brief The factor at which the time snapshots are increased.
+   */
+  double time_snapshot_factor = 1.0;
+
+  /**
+   * @brief The factor at which the iterations snapshots are increased.
+   */
+  double iteration_snapshot_factor = 1.0;
+
+  /**
+   * @brief The time when the next snapshot will be taken.
+   */
+  double time_next_snapshot = 0.0;
+
+  /**
+   * @brief The time when the last snapshot was taken.
+   */
+  double time_last_snapshot = 0.0;
+
+  /**
+   * @brief The iteration when the next snapshot will be taken.
+   */
+  unsigned iteration_next_snapshot = 0;
+
+  /**
+   * @brief The iteration when the last snapshot was taken.
+   */
+  unsigned iteration_last_snapshot = 0;
+
+  /**
+   * @brief Starts a new schedule, with no snapshot taken.
+   *
+   * @param time_limit The time limit in seconds.
+   * @param iterations_limit The iterations limit.
+   * @param max_num_snapshots The maximum number of snapshots, including the
+   * last one.
+   */
+  void start(double time_limit, unsigned iterations_limit,
+             unsigned max_num_snapshots);
+
+  /**
+   * @brief Verifies whether snapshots other than the last one remain to be
+   * taken.
+   *
+   * @return true if snapshots remain; false otherwise.
+   */
+  bool is_active() const;
+
+  /**
+   * @brief Verifies whether a snapshot is due, which the first one is before
+   * the first iteration.
+   *
+   * @param iteration The current iteration.
+   * @param time The current time in seconds.
+   * @return true if a snapshot is due; false otherwise.
+   */
+  bool is_due(unsigned iteration, double time) const;
+
+  /**
+   * @brief Records a snapshot and, if it was taken while snapshots remained,
+   * schedules the next.
+   *
+   * @param iteration The iteration of the snapshot.
+   * @param time The time of the snapshot in seconds.
+   */
+  void record(unsigned iteration, double time);
+};
+
+}  // namespace mopop
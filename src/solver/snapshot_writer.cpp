@@ -0,0 +1,316 @@
+#include "solver/snapshot_writer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace mopop {
+/**
+ * @brief Writes a line of numbers, separated by spaces.
+ *
+ * @param os The output stream.
+ * @param numbers The numbers.
+ */
+template <class T>
+static void write_line(std::ostream& os, const std::vector<T>& numbers) {
+  for (std::size_t i = 0; i < numbers.size(); i++) {
+    os << numbers[i] << (i + 1 < numbers.size() ? " " : "");
+  }
+
+  os << '\n';
+}
+
+/**
+ * @brief Opens a file for writing, if its name is set.
+ *
+ * @param ofs The file.
+ * @param filename The name of the file, or empty.
+ *
+ * @throws std::runtime_error If the file cannot be created.
+ */
+static void open(std::ofstream& ofs, const std::string& filename) {
+  if (filename.empty()) {
+    return;
+  }
+
+  ofs.open(filename);
+
+  if (!ofs.is_open()) {
+    throw std::runtime_error("File " + filename + " not created.");
+  }
+}
+
+/**
+ * @brief Verifies that the writes to a file succeeded.
+ *
+ * @param ofs The file.
+ * @param filename The name of the file.
+ *
+ * @throws std::runtime_error If a write failed.
+ */
+static void check(const std::ofstream& ofs, const std::string& filename) {
+  if (ofs.eof() || ofs.fail() || ofs.bad()) {
+    throw std::runtime_error("Error writing file " + filename + ".");
+  }
+}
+
+/**
+ * @brief Flushes a file, if it is open, so that what was written survives a
+ * crash of the solver, and verifies that the writes to it succeeded.
+ *
+ * @param ofs The file.
+ * @param filename The name of the file.
+ *
+ * @throws std::runtime_error If a write failed.
+ */
+static void flush(std::ofstream& ofs, const std::string& filename) {
+  if (ofs.is_open()) {
+    ofs.flush();
+    check(ofs, filename);
+  }
+}
+
+/**
+ * @brief Constructs a new writer.
+ *
+ * @param senses The optimization senses, to sort the populations.
+ * @param max_num_snapshots The maximum number of snapshots.
+ */
+Snapshot_Writer::Snapshot_Writer(const std::vector<NSBRKGA::Sense>& senses,
+                                 unsigned max_num_snapshots)
+    : num_objectives(senses.size()),
+      non_dominated_sorting(senses),
+      filled_slabs(std::max(max_num_snapshots, 2u)),
+      free_slabs(std::max(max_num_snapshots, 2u)),
+      is_closing(false) {
+  for (unsigned i = 0; i < 2; i++) {
+    this->slabs.push_back(std::make_unique<Snapshot>());
+    this->free_slabs.push(this->slabs.back().get());
+  }
+}
+
+/**
+ * @brief Stops the writer thread, if it is running, and drops its error.
+ */
+Snapshot_Writer::~Snapshot_Writer() {
+  if (this->thread.joinable()) {
+    this->is_closing = true;
+    this->condition.notify_one();
+    this->thread.join();
+  }
+}
+
+/**
+ * @brief Creates the files written once and starts the writer thread.
+ *
+ * The binary snapshot files are created here too, since they are appended to
+ * rather than written per snapshot.
+ *
+ * @throws std::runtime_error If a file cannot be created.
+ */
+void Snapshot_Writer::start() {
+  if (this->is_binary && !this->best_solutions_snapshots_filename.empty()) {
+    this->best_solutions_file.open(this->best_solutions_snapshots_filename,
+                                   this->num_objectives);
+  }
+
+  if (this->is_binary && !this->populations_snapshots_filename.empty()) {
+    this->populations_file.open(this->populations_snapshots_filename,
+                                this->num_objectives);
+  }
+
+  open(this->hypervolume_ofs, this->hypervolume_snapshots_filename);
+  open(this->num_non_dominated_ofs, this->num_non_dominated_snapshots_filename);
+  open(this->num_fronts_ofs, this->num_fronts_snapshots_filename);
+  open(this->num_elites_ofs, this->num_elites_snapshots_filename);
+  this->thread = std::thread(&Snapshot_Writer::run, this);
+}
+
+/**
+ * @brief Returns a slab to be filled with the next snapshot, from the solver
+ * thread.
+ *
+ * A slab is allocated if none is free, so the solver never waits for the disk
+ * unless it takes more snapshots than the maximum.
+ *
+ * @return The slab.
+ */
+Snapshot& Snapshot_Writer::acquire() {
+  while (!this->free_slabs.pop(this->slab)) {
+    if (this->slabs.size() < this->free_slabs.capacity()) {
+      this->slabs.push_back(std::make_unique<Snapshot>());
+      this->slab = this->slabs.back().get();
+      break;
+    }
+
+    std::this_thread::yield();
+  }
+
+  return *this->slab;
+}
+
+/**
+ * @brief Hands the slab filled over to the writer thread.
+ */
+void Snapshot_Writer::publish() {
+  this->filled_slabs.push(this->slab);
+  this->slab = nullptr;
+  this->condition.notify_one();
+}
+
+/**
+ * @brief Waits for the snapshots handed over to be written, and stops the
+ * writer thread.
+ *
+ * The binary snapshot files are then ended with their index, unless a write
+ * failed.
+ *
+ * @throws std::runtime_error If a file could not be created or written.
+ */
+void Snapshot_Writer::close() {
+  if (this->thread.joinable()) {
+    this->is_closing = true;
+    this->condition.notify_one();
+    this->thread.join();
+  }
+
+  if (this->exception) {
+    std::rethrow_exception(this->exception);
+  }
+
+  this->best_solutions_file.close();
+  this->populations_file.close();
+}
+
+/**
+ * @brief Writes the slabs as they are filled, until the writer is closed.
+ *
+ * The solver thread does not take the lock to wake this thread up, so that it
+ * never waits for it, and a wake-up may be missed. This thread therefore also
+ * wakes up by itself, at intervals far shorter than those between snapshots.
+ *
+ * After an error the slabs are still handed back, but no longer written.
+ */
+void Snapshot_Writer::run() {
+  Snapshot* slab;
+
+  while (true) {
+    const bool was_closing = this->is_closing;
+
+    if (this->filled_slabs.pop(slab)) {
+      if (!this->exception) {
+        try {
+          this->write(*slab);
+        } catch (...) {
+          this->exception = std::current_exception();
+        }
+      }
+
+      this->free_slabs.push(slab);
+      continue;
+    }
+
+    if (was_closing) {
+      break;
+    }
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->condition.wait_for(lock, std::chrono::milliseconds(10));
+  }
+}
+
+/**
+ * @brief Writes a snapshot.
+ *
+ * @param snapshot The snapshot.
+ *
+ * @throws std::runtime_error If a file cannot be created or written.
+ */
+void Snapshot_Writer::write(const Snapshot& snapshot) {
+  const std::string index = std::to_string(this->num_snapshots++);
+
+  if (this->best_solutions_file.is_open()) {
+    this->best_solutions_file.append(snapshot.iteration, snapshot.time,
+                                     snapshot.best_solutions);
+  } else if (!this->best_solutions_snapshots_filename.empty()) {
+    const std::string filename =
+        this->best_solutions_snapshots_filename + index + ".txt";
+    std::ofstream ofs;
+
+    open(ofs, filename);
+    ofs << snapshot.iteration << " " << snapshot.time << '\n';
+
+    for (const std::vector<double>& value : snapshot.best_solutions) {
+      write_line(ofs, value);
+    }
+
+    ofs.close();
+    check(ofs, filename);
+  }
+
+  if (this->hypervolume_ofs.is_open() && snapshot.has_hypervolume) {
+    this->hypervolume_ofs << snapshot.iteration << "," << snapshot.time << ","
+                          << snapshot.hypervolume << '\n';
+  }
+
+  std::vector<unsigned> num_non_dominated = snapshot.num_non_dominated,
+                        num_fronts = snapshot.num_fronts;
+
+  if ((this->num_non_dominated_ofs.is_open() ||
+       this->num_fronts_ofs.is_open()) &&
+      num_fronts.empty()) {
+    for (const std::vector<std::vector<double>>& population :
+         snapshot.populations) {
+      this->non_dominated_sorting.sort(population);
+      num_non_dominated.push_back(this->non_dominated_sorting.front(0).size());
+      num_fronts.push_back(this->non_dominated_sorting.num_fronts());
+    }
+  }
+
+  if (this->num_non_dominated_ofs.is_open()) {
+    this->num_non_dominated_ofs << snapshot.iteration << " " << snapshot.time
+                                << " ";
+    write_line(this->num_non_dominated_ofs, num_non_dominated);
+  }
+
+  if (this->num_fronts_ofs.is_open()) {
+    this->num_fronts_ofs << snapshot.iteration << " " << snapshot.time << " ";
+    write_line(this->num_fronts_ofs, num_fronts);
+  }
+
+  if (this->populations_file.is_open()) {
+    this->populations_file.append(snapshot.iteration, snapshot.time,
+                                  snapshot.populations);
+  } else if (!this->populations_snapshots_filename.empty()) {
+    const std::string filename =
+        this->populations_snapshots_filename + index + ".txt";
+    std::ofstream ofs;
+
+    open(ofs, filename);
+    ofs << snapshot.iteration << " " << snapshot.time << '\n';
+
+    for (const std::vector<std::vector<double>>& population :
+         snapshot.populations) {
+      for (const std::vector<double>& value : population) {
+        write_line(ofs, value);
+      }
+    }
+
+    ofs.close();
+    check(ofs, filename);
+  }
+
+  if (this->num_elites_ofs.is_open()) {
+    this->num_elites_ofs << snapshot.iteration << " " << snapshot.time << " ";
+    write_line(this->num_elites_ofs, snapshot.num_elites);
+  }
+
+  // The files of every snapshot are flushed once, after all of its lines.
+  flush(this->hypervolume_ofs, this->hypervolume_snapshots_filename);
+  flush(this->num_non_dominated_ofs,
+        this->num_non_dominated_snapshots_filename);
+  flush(this->num_fronts_ofs, this->num_fronts_snapshots_filename);
+  flush(this->num_elites_ofs, this->num_elites_snapshots_filename);
+}
+
+}  // namespace mopop
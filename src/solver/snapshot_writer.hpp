@@ -0,0 +1,290 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "solver/non_dominated_sorting.hpp"
+#include "utils/snapshot_file.hpp"
+#include "utils/spsc_queue.hpp"
+
+namespace mopop {
+/**
+ * @class Snapshot
+ * @brief A snapshot taken during optimization, on its way to disk.
+ */
+class Snapshot {
+ public:
+  /**
+   * @brief The iteration of the snapshot.
+   */
+  unsigned iteration = 0;
+
+  /**
+   * @brief The time of the snapshot in seconds.
+   */
+  double time = 0.0;
+
+  /**
+   * @brief The objective values of the best solutions.
+   */
+  std::vector<std::vector<double>> best_solutions;
+
+  /**
+   * @brief Whether the hypervolume of the best solutions is tracked.
+   */
+  bool has_hypervolume = false;
+
+  /**
+   * @brief The hypervolume of the best solutions, if it is tracked.
+   */
+  double hypervolume = 0.0;
+
+  /**
+   * @brief The objective values of the individuals of each population.
+   */
+  std::vector<std::vector<std::vector<double>>> populations;
+
+  /**
+   * @brief The number of non-dominated individuals in each population, or
+   * empty for the writer to count them.
+   */
+  std::vector<unsigned> num_non_dominated;
+
+  /**
+   * @brief The number of non-dominated fronts in each population, or empty for
+   * the writer to count them.
+   */
+  std::vector<unsigned> num_fronts;
+
+  /**
+   * @brief The number of elite individuals in each population, if the solver
+   * has elites.
+   */
+  std::vector<unsigned> num_elites;
+};
+
+/**
+ * @class Snapshot_Writer
+ * @brief Writes the snapshots of a solver to disk on a thread of its own, as
+ * soon as they are taken, so that the solver neither keeps them in memory nor
+ * waits for the disk.
+ *
+ * The solver fills a slab and hands it to the writer through a lock-free
+ * queue, and the writer hands it back through another once it is written.
+ * Two slabs are allocated up front, so that the solver fills one while the
+ * writer writes the other, and their vectors keep their capacity from one
+ * snapshot to the next. Another slab is only allocated when the disk falls
+ * behind, up to one per snapshot.
+ *
+ * The files are those written by the solver execs: one file per snapshot for
+ * the best solutions and the populations, with the index of the snapshot and
+ * the extension .txt appended to the name, and one line per snapshot for the
+ * others. A file is only written if its name is set.
+ *
+ * With is_binary set, the best solutions and the populations of every
+ * snapshot go instead to a single binary snapshot file each, named by the
+ * prefix alone (see Snapshot_File_Writer).
+ */
+class Snapshot_Writer {
+ public:
+  /**
+   * @brief The prefix of the names of the files of the best solutions, or the
+   * name of their binary snapshot file.
+   */
+  std::string best_solutions_snapshots_filename;
+
+  /**
+   * @brief The name of the file of the hypervolumes.
+   */
+  std::string hypervolume_snapshots_filename;
+
+  /**
+   * @brief The name of the file of the numbers of non-dominated individuals.
+   */
+  std::string num_non_dominated_snapshots_filename;
+
+  /**
+   * @brief The name of the file of the numbers of non-dominated fronts.
+   */
+  std::string num_fronts_snapshots_filename;
+
+  /**
+   * @brief The prefix of the names of the files of the populations, or the
+   * name of their binary snapshot file.
+   */
+  std::string populations_snapshots_filename;
+
+  /**
+   * @brief The name of the file of the numbers of elite individuals.
+   */
+  std::string num_elites_snapshots_filename;
+
+  /**
+   * @brief Whether the best solutions and the populations are written to a
+   * binary snapshot file each, rather than to a text file per snapshot.
+   */
+  bool is_binary = false;
+
+ private:
+  /**
+   * @brief The number of objectives.
+   */
+  unsigned num_objectives;
+
+  /**
+   * @brief The non-dominated sorting of the populations, used by the writer
+   * thread alone.
+   */
+  Non_Dominated_Sorting non_dominated_sorting;
+
+  /**
+   * @brief The slabs, owned by the solver thread.
+   */
+  std::vector<std::unique_ptr<Snapshot>> slabs;
+
+  /**
+   * @brief The slab being filled by the solver thread, if any.
+   */
+  Snapshot* slab = nullptr;
+
+  /**
+   * @brief The slabs filled and yet to be written.
+   */
+  SPSC_Queue<Snapshot*> filled_slabs;
+
+  /**
+   * @brief The slabs written and ready to be filled again.
+   */
+  SPSC_Queue<Snapshot*> free_slabs;
+
+  /**
+   * @brief The writer thread.
+   */
+  std::thread thread;
+
+  /**
+   * @brief Whether the solver is done with the writer.
+   */
+  std::atomic<bool> is_closing;
+
+  /**
+   * @brief The lock the writer thread sleeps on while there is nothing to
+   * write.
+   */
+  std::mutex mutex;
+
+  /**
+   * @brief Wakes the writer thread up when a slab is filled.
+   */
+  std::condition_variable condition;
+
+  /**
+   * @brief The first error of the writer thread.
+   */
+  std::exception_ptr exception;
+
+  /**
+   * @brief The number of snapshots written.
+   */
+  unsigned num_snapshots = 0;
+
+  /**
+   * @brief The file of the hypervolumes.
+   */
+  std::ofstream hypervolume_ofs;
+
+  /**
+   * @brief The file of the numbers of non-dominated individuals.
+   */
+  std::ofstream num_non_dominated_ofs;
+
+  /**
+   * @brief The file of the numbers of non-dominated fronts.
+   */
+  std::ofstream num_fronts_ofs;
+
+  /**
+   * @brief The file of the numbers of elite individuals.
+   */
+  std::ofstream num_elites_ofs;
+
+  /**
+   * @brief The binary snapshot file of the best solutions.
+   */
+  Snapshot_File_Writer best_solutions_file;
+
+  /**
+   * @brief The binary snapshot file of the populations.
+   */
+  Snapshot_File_Writer populations_file;
+
+  /**
+   * @brief Writes the slabs as they are filled, until the writer is closed.
+   */
+  void run();
+
+  /**
+   * @brief Writes a snapshot.
+   *
+   * @param snapshot The snapshot.
+   *
+   * @throws std::runtime_error If a file cannot be created or written.
+   */
+  void write(const Snapshot& snapshot);
+
+ public:
+  /**
+   * @brief Constructs a new writer.
+   *
+   * @param senses The optimization senses, to sort the populations.
+   * @param max_num_snapshots The maximum number of snapshots.
+   */
+  Snapshot_Writer(const std::vector<NSBRKGA::Sense>& senses,
+                  unsigned max_num_snapshots);
+
+  Snapshot_Writer(const Snapshot_Writer&) = delete;
+
+  Snapshot_Writer& operator=(const Snapshot_Writer&) = delete;
+
+  /**
+   * @brief Stops the writer thread, if it is running, and drops its error.
+   */
+  ~Snapshot_Writer();
+
+  /**
+   * @brief Creates the files written once and starts the writer thread.
+   *
+   * @throws std::runtime_error If a file cannot be created.
+   */
+  void start();
+
+  /**
+   * @brief Returns a slab to be filled with the next snapshot, from the solver
+   * thread.
+   *
+   * @return The slab.
+   */
+  Snapshot& acquire();
+
+  /**
+   * @brief Hands the slab filled over to the writer thread.
+   */
+  void publish();
+
+  /**
+   * @brief Waits for the snapshots handed over to be written, and stops the
+   * writer thread.
+   *
+   * @throws std::runtime_error If a file could not be created or written.
+   */
+  void close();
+};
+
+}  // namespace mopop
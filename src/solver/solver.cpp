@@ -2,13 +2,18 @@
 
 #include <algorithm>
 
+#include <pagmo/batch_evaluators/member_bfe.hpp>
+
 namespace mopop {
 /**
  * @brief Constructs a new solver.
  *
  * @param instance The instance to be solved.
  */
-Solver::Solver(const Instance& instance) : instance(instance) {
+Solver::Solver(const Instance& instance)
+    : instance(instance),
+      best_individuals(instance.senses),
+      non_dominated_sorting(instance.senses) {
   this->set_seed(this->seed);
 }
 
@@ -76,13 +81,114 @@ double Solver::remaining_time() const {
 }
 
 /**
- * @brief Verifies whether the termination criteria have been met.
+ * @brief Starts the clock and the schedule of the snapshots.
+ */
+void Solver::start_solving() {
+  this->start_time = std::chrono::steady_clock::now();
+  this->current_time = 0.0;
+  this->snapshot_scheduler.start(this->time_limit, this->iterations_limit,
+                                 this->max_num_snapshots);
+}
+
+/**
+ * @brief Reads the clock.
+ *
+ * The solvers read it once per generation, and the termination criteria, the
+ * number of generations per evolve and the snapshots all go by that reading.
+ *
+ * @return The elapsed time in seconds.
+ */
+double Solver::read_clock() {
+  this->current_time = this->elapsed_time();
+
+  return this->current_time;
+}
+
+/**
+ * @brief Tracks the hypervolume of the best individuals with respect to a
+ * reference point, from now on.
+ *
+ * @param reference_point The reference point.
+ *
+ * @throws std::runtime_error If the reference point does not have a value for
+ * each objective.
+ */
+void Solver::set_reference_point(const std::vector<double>& reference_point) {
+  this->hypervolume_tracker.emplace(this->instance.senses, reference_point);
+  this->is_hypervolume_stale = true;
+  this->hypervolume = 0.0;
+  this->best_hypervolume = 0.0;
+  this->iteration_last_hypervolume_improvement = this->num_iterations;
+}
+
+/**
+ * @brief Tracks the hypervolume of the best individuals with respect to a
+ * reference point read from a file, as written by
+ * reference_pareto_front_and_point_calculator_exec.
+ *
+ * @param filename The name of the file.
+ *
+ * @throws std::runtime_error If the file cannot be read.
+ */
+void Solver::load_reference_point(const std::string& filename) {
+  Text_Reader reader;
+  std::vector<double> reference_point(this->instance.senses.size(), 0.0);
+
+  if (reader.open(filename)) {
+    while (reader.next_line()) {
+      for (double& value : reference_point) {
+        reader.next_number(value);
+      }
+    }
+
+    reader.close();
+  } else {
+    throw std::runtime_error("File " + filename + " not found.");
+  }
+
+  this->set_reference_point(reference_point);
+}
+
+/**
+ * @brief Computes the hypervolume of the best individuals if they have changed
+ * since it was last computed, and records whether it improved.
+ */
+void Solver::update_hypervolume() {
+  if (!this->hypervolume_tracker || !this->is_hypervolume_stale) {
+    return;
+  }
+
+  std::vector<std::vector<double>> front;
+
+  front.reserve(this->best_individuals.size());
+
+  for (const auto& best_individual : this->best_individuals) {
+    front.push_back(best_individual.first);
+  }
+
+  this->hypervolume = this->hypervolume_tracker->update(front);
+  this->is_hypervolume_stale = false;
+
+  if (this->hypervolume >
+      this->best_hypervolume * (1.0 + this->hypervolume_tolerance)) {
+    this->best_hypervolume = this->hypervolume;
+    this->iteration_last_hypervolume_improvement = this->num_iterations;
+  }
+}
+
+/**
+ * @brief Verifies whether the termination criteria have been met, as of the
+ * last reading of the clock.
  *
  * @return true if the termination criteria have been met; false otherwise.
  */
 bool Solver::are_termination_criteria_met() const {
-  return (this->elapsed_time() >= this->time_limit ||
-          this->num_iterations >= this->iterations_limit);
+  return (this->current_time >= this->time_limit ||
+          this->num_iterations >= this->iterations_limit ||
+          (this->hypervolume_tracker &&
+           this->num_iterations -
+                   this->iteration_last_hypervolume_improvement >=
+               this->hypervolume_stagnation_limit));
 }
 
 /**
@@ -90,53 +196,16 @@ bool Solver::are_termination_criteria_met() const {
  *
  * @param best_individuals The best individuals found so far.
  * @param new_individuals The new individuals found.
- * @param senses The optimisation senses.
  * @return true if the best individual are modified; false otherwise.
  */
 bool Solver::update_best_individuals(
-    std::vector<std::pair<std::vector<double>, std::vector<double>>>&
-        best_individuals,
+    ND_Tree& best_individuals,
     const std::vector<std::pair<std::vector<double>, std::vector<double>>>&
-        new_individuals,
-    const std::vector<NSBRKGA::Sense>& senses) {
+        new_individuals) {
   bool result = false;
 
-  if (new_individuals.empty()) {
-    return result;
-  }
-
-  auto non_dominated_new_individuals =
-      NSBRKGA::Population::nonDominatedSort<std::vector<double>>(
-          new_individuals, senses)
-          .front();
-
-  for (const auto& new_individual : non_dominated_new_individuals) {
-    bool is_dominated_or_equal = false;
-
-    for (auto it = best_individuals.begin(); it != best_individuals.end();) {
-      auto individual = *it;
-
-      if (Solution::dominates(new_individual.first, individual.first, senses)) {
-        it = best_individuals.erase(it);
-      } else {
-        if (Solution::dominates(individual.first, new_individual.first,
-                                senses) ||
-            std::equal(individual.first.begin(), individual.first.end(),
-                       new_individual.first.begin(),
-                       [](const double& a, const double& b) {
-                         return fabs(a - b) <
-                                std::numeric_limits<double>::epsilon();
-                       })) {
-          is_dominated_or_equal = true;
-          break;
-        }
-
-        it++;
-      }
-    }
-
-    if (!is_dominated_or_equal) {
-      best_individuals.push_back(new_individual);
+  for (const auto& new_individual : new_individuals) {
+    if (best_individuals.update(new_individual)) {
       result = true;
     }
   }
@@ -149,22 +218,22 @@ bool Solver::update_best_individuals(
  *
  * @param best_individuals The best individuals found so far.
  * @param new_individuals The new individuals found.
- * @param senses The optimisation senses.
  * @param max_num_solutions The maximum number of solutions.
  * @return true if the best individual are modified; false otherwise.
  */
 bool Solver::update_best_individuals(
-    std::vector<std::pair<std::vector<double>, std::vector<double>>>&
-        best_individuals,
+    ND_Tree& best_individuals,
     const std::vector<std::pair<std::vector<double>, std::vector<double>>>&
         new_individuals,
-    const std::vector<NSBRKGA::Sense>& senses, unsigned max_num_solutions) {
-  bool result = Solver::update_best_individuals(best_individuals,
-                                                new_individuals, senses);
+    unsigned max_num_solutions) {
+  bool result = false;
+
+  if (best_individuals.max_size() != max_num_solutions) {
+    result = best_individuals.size() > max_num_solutions;
+    best_individuals.set_max_size(max_num_solutions);
+  }
 
-  if (best_individuals.size() > max_num_solutions) {
-    NSBRKGA::Population::crowdingSort<std::vector<double>>(best_individuals);
-    best_individuals.resize(max_num_solutions);
+  if (Solver::update_best_individuals(best_individuals, new_individuals)) {
     result = true;
   }
 
@@ -181,73 +250,244 @@ bool Solver::update_best_individuals(
     const std::vector<std::pair<std::vector<double>, std::vector<double>>>&
         new_individuals) {
   bool result = Solver::update_best_individuals(
-      this->best_individuals, new_individuals, this->instance.senses);
+      this->best_individuals, new_individuals, this->max_num_solutions);
 
-  if (this->best_individuals.size() > this->max_num_solutions) {
-    NSBRKGA::Population::crowdingSort<std::vector<double>>(
-        this->best_individuals);
-    this->best_individuals.resize(this->max_num_solutions);
-    result = true;
+  if (result) {
+    this->invalidate_hypervolume();
   }
 
   return result;
 }
 
 /**
- * @brief Updates the best individuals found so far.
+ * @brief Updates the best individuals found so far with the individuals fed to
+ * them since the last update.
+ *
+ * The feed offers the individuals to the best individuals as they are
+ * evaluated, so only whether they have changed is left to be read here.
  *
- * @param pop The new solutions.
+ * @param feed The feed of the best individuals.
  * @return true if the best individuals are modified; false otherwise.
  */
-bool Solver::update_best_individuals(const pagmo::population& pop) {
-  std::vector<std::pair<std::vector<double>, std::vector<double>>>
-      new_individuals(pop.size());
+bool Solver::update_best_individuals(Archive_Feed& feed) {
+  bool result = feed.take_modified();
 
-  for (std::size_t i = 0; i < pop.size(); i++) {
-    new_individuals[i] = std::make_pair(pop.get_f()[i], pop.get_x()[i]);
+  if (result) {
+    this->invalidate_hypervolume();
   }
 
-  return this->update_best_individuals(new_individuals);
+  return result;
+}
+
+/**
+ * @brief Records that the best individuals have changed.
+ */
+void Solver::invalidate_hypervolume() {
+  this->is_hypervolume_stale = true;
+
+  // Early stopping needs the hypervolume after every change. Otherwise it is
+  // only computed when it is reported.
+  if (this->hypervolume_stagnation_limit <
+      std::numeric_limits<unsigned>::max()) {
+    this->update_hypervolume();
+  }
+}
+
+/**
+ * @brief Returns the number of generations the next call to evolve should
+ * advance.
+ *
+ * Every call advances max_num_generations_per_evolve generations, so that the
+ * algorithm is only built once, until that many could pass the iterations limit
+ * or, at the time per generation of the last call, the time limit. From then
+ * on every call advances one generation, so the run ends where it would end one
+ * generation at a time. The first call has no time per generation yet, and
+ * takes the time the initial population took instead. Snapshots and the
+ * hypervolume stagnation limit are checked between calls.
+ *
+ * @return The number of generations.
+ */
+unsigned Solver::num_generations_per_evolve() const {
+  const unsigned num_generations =
+      std::max(this->max_num_generations_per_evolve, 1u);
+  const double time_per_generation = this->time_per_generation > 0.0
+                                         ? this->time_per_generation
+                                         : this->current_time;
+
+  if (num_generations == 1 || this->algorithm_num_generations == 1) {
+    return 1;
+  }
+
+  if (this->num_iterations < this->iterations_limit &&
+      this->iterations_limit - this->num_iterations < num_generations) {
+    return 1;
+  }
+
+  if (this->time_limit < std::numeric_limits<double>::max() &&
+      this->current_time + num_generations * time_per_generation >
+          this->time_limit) {
+    return 1;
+  }
+
+  return num_generations;
+}
+
+/**
+ * @brief Advances a population by a batch of generations of a pagmo algorithm,
+ * and updates the best individuals with the individuals evaluated meanwhile.
+ *
+ * The algorithm is built from the seed of the solver on the first call, and
+ * only rebuilt once more, from its generator, for the last generations of the
+ * run, which it advances one at a time. That rebuild resets the state NSPSO
+ * and MHACO keep between calls with memory, which never happens with one
+ * generation per call, so that advancing one generation per call evolves the
+ * population as it always has. The problem of the population feeds the
+ * individuals it evaluates to the best individuals, so the population is not
+ * copied to update them. The clock is read once, after the generations.
+ *
+ * @param pop The population, whose problem feeds the best individuals.
+ * @param feed The feed of the best individuals.
+ * @param build_algorithm Builds the algorithm advancing a number of generations
+ * per call to evolve, from a seed.
+ */
+void Solver::evolve(pagmo::population& pop, Archive_Feed& feed,
+                    const std::function<pagmo::algorithm(unsigned, unsigned)>&
+                        build_algorithm) {
+  const unsigned num_generations = this->num_generations_per_evolve();
+
+  if (num_generations != this->algorithm_num_generations) {
+    this->algorithm = build_algorithm(
+        num_generations,
+        this->algorithm_num_generations == 0 ? this->seed : this->rng());
+    this->algorithm_num_generations = num_generations;
+  }
+
+  const double time_start = this->current_time;
+
+  pop = this->algorithm.evolve(pop);
+  this->num_iterations += num_generations;
+  this->time_per_generation =
+      (this->read_clock() - time_start) / num_generations;
+  this->update_best_individuals(feed);
+}
+
+/**
+ * @brief Captures a snapshot of the hypervolume of the best individuals, if it
+ * is tracked.
+ *
+ * @param time_snapshot The time of the snapshot.
+ */
+void Solver::capture_hypervolume_snapshot(double time_snapshot) {
+  if (!this->hypervolume_tracker) {
+    return;
+  }
+
+  this->update_hypervolume();
+  this->hypervolume_snapshots.push_back(
+      std::make_tuple(this->num_iterations, time_snapshot, this->hypervolume));
+}
+
+/**
+ * @brief Acquires a slab of the snapshot writer and fills it with the
+ * iteration, the time, the best individuals and their hypervolume, if it is
+ * tracked.
+ *
+ * @param time_snapshot The time of the snapshot.
+ * @return The slab, to be filled with the populations and published.
+ */
+Snapshot& Solver::stream_snapshot(double time_snapshot) {
+  Snapshot& snapshot = this->snapshot_writer->acquire();
+
+  snapshot.iteration = this->num_iterations;
+  snapshot.time = time_snapshot;
+  snapshot.best_solutions.resize(this->best_individuals.size());
+
+  for (std::size_t i = 0; i < this->best_individuals.size(); i++) {
+    snapshot.best_solutions[i].assign(this->best_individuals[i].first.begin(),
+                                      this->best_individuals[i].first.end());
+  }
+
+  snapshot.has_hypervolume = this->hypervolume_tracker.has_value();
+
+  if (snapshot.has_hypervolume) {
+    this->update_hypervolume();
+    snapshot.hypervolume = this->hypervolume;
+  }
+
+  snapshot.num_non_dominated.clear();
+  snapshot.num_fronts.clear();
+  snapshot.num_elites.clear();
+
+  return snapshot;
 }
 
 /**
  * @brief Captures a snapshot of the current population.
  *
+ * The snapshot is taken at the last reading of the clock. Only the objective
+ * values are copied, either into a slab of the snapshot writer, which sorts the
+ * population on its own thread, or into memory, where the population is sorted
+ * after the optimization, by complete_snapshots.
+ *
  * @param pop The current population.
  */
 void Solver::capture_snapshot(const pagmo::population& pop) {
-  double time_snapshot = this->elapsed_time();
+  const double time_snapshot = this->current_time;
+  const std::vector<pagmo::vector_double>& f = pop.get_f();
 
-  this->best_solutions_snapshots.emplace_back(std::make_tuple(
-      this->num_iterations, time_snapshot,
-      std::vector<std::vector<double>>(this->best_individuals.size())));
+  if (this->snapshot_writer) {
+    Snapshot& snapshot = this->stream_snapshot(time_snapshot);
 
-  for (std::size_t i = 0; i < this->best_individuals.size(); i++) {
-    std::get<2>(this->best_solutions_snapshots.back())[i] =
-        this->best_individuals[i].first;
-  }
+    snapshot.populations.resize(1);
+    snapshot.populations[0].resize(f.size());
+
+    for (std::size_t i = 0; i < f.size(); i++) {
+      snapshot.populations[0][i].assign(f[i].begin(), f[i].end());
+    }
+
+    this->snapshot_writer->publish();
+  } else {
+    this->best_solutions_snapshots.emplace_back(std::make_tuple(
+        this->num_iterations, time_snapshot,
+        std::vector<std::vector<double>>(this->best_individuals.size())));
 
-  f = pop.get_f();
-  this->current_individuals.resize(pop.size());
+    for (std::size_t i = 0; i < this->best_individuals.size(); i++) {
+      std::get<2>(this->best_solutions_snapshots.back())[i] =
+          this->best_individuals[i].first;
+    }
 
-  for (std::size_t i = 0; i < pop.size(); i++) {
-    this->current_individuals[i] = std::make_pair(f[i], pop.get_x()[i]);
+    this->capture_hypervolume_snapshot(time_snapshot);
+    this->populations_snapshots.push_back(std::make_tuple(
+        this->num_iterations, time_snapshot,
+        std::vector<std::vector<std::vector<double>>>(1, f)));
   }
 
-  this->fronts = NSBRKGA::Population::nonDominatedSort<std::vector<double>>(
-      current_individuals, this->instance.senses);
-  this->num_non_dominated_snapshots.push_back(
-      std::make_tuple(this->num_iterations, time_snapshot,
-                      std::vector<unsigned>(1, fronts.front().size())));
-  this->num_fronts_snapshots.push_back(
-      std::make_tuple(this->num_iterations, time_snapshot,
-                      std::vector<unsigned>(1, fronts.size())));
-  this->populations_snapshots.push_back(
-      std::make_tuple(this->num_iterations, time_snapshot,
-                      std::vector<std::vector<std::vector<double>>>(1, f)));
-  this->time_last_snapshot = time_snapshot;
-  this->iteration_last_snapshot = this->num_iterations;
-  this->num_snapshots++;
+  this->snapshot_scheduler.record(this->num_iterations, time_snapshot);
+}
+
+/**
+ * @brief Counts the non-dominated individuals and the fronts of the population
+ * snapshots captured without them.
+ */
+void Solver::complete_snapshots() {
+  for (std::size_t i = this->num_fronts_snapshots.size();
+       i < this->populations_snapshots.size(); i++) {
+    const unsigned iteration = std::get<0>(this->populations_snapshots[i]);
+    const double time = std::get<1>(this->populations_snapshots[i]);
+    std::vector<unsigned> num_non_dominated, num_fronts;
+
+    for (const std::vector<std::vector<double>>& population :
+         std::get<2>(this->populations_snapshots[i])) {
+      this->non_dominated_sorting.sort(population);
+      num_non_dominated.push_back(this->non_dominated_sorting.front(0).size());
+      num_fronts.push_back(this->non_dominated_sorting.num_fronts());
+    }
+
+    this->num_non_dominated_snapshots.push_back(
+        std::make_tuple(iteration, time, num_non_dominated));
+    this->num_fronts_snapshots.push_back(
+        std::make_tuple(iteration, time, num_fronts));
+  }
 }
 
 /**
@@ -338,6 +578,27 @@ std::vector<std::vector<double>> Solver::build_initial_chromosomes(
   return chromosomes;
 }
 
+/**
+ * @brief Builds the batch fitness evaluator of the pagmo-based solvers.
+ *
+ * With a single thread every batch goes to the problem's own batch_fitness,
+ * which reads each covariance entry once for several solutions. With more
+ * threads an Archive_Feed_Bfe spreads the batch over the TBB workers, whose
+ * number the solver caps at num_threads while it runs, and feeds the batch in
+ * order once it is evaluated, so the best individuals do not depend on which
+ * worker evaluates what.
+ *
+ * @param feed The feed of the best individuals.
+ * @return The batch fitness evaluator.
+ */
+pagmo::bfe Solver::build_bfe(Archive_Feed& feed) const {
+  if (this->num_threads > 1) {
+    return pagmo::bfe{Archive_Feed_Bfe(this->instance, feed)};
+  }
+
+  return pagmo::bfe{pagmo::member_bfe{}};
+}
+
 /**
  * @brief Standard stream operator.
  *
@@ -352,21 +613,33 @@ std::ostream& operator<<(std::ostream& os, const Solver& solver) {
      << "Iterations limit: " << solver.iterations_limit << std::endl
      << "Maximum number of solutions: " << solver.max_num_solutions << std::endl
      << "Maximum number of snapshots: " << solver.max_num_snapshots << std::endl
+     << "Number of threads: " << solver.num_threads << std::endl
+     << "Maximum number of generations per evolve: "
+     << solver.max_num_generations_per_evolve << std::endl
      << "Factor at which the time between snapshots are increased: "
-     << solver.time_snapshot_factor << std::endl
+     << solver.snapshot_scheduler.time_snapshot_factor << std::endl
      << "Factor at which the iterations between snapshots are increased: "
-     << solver.iteration_snapshot_factor << std::endl
+     << solver.snapshot_scheduler.iteration_snapshot_factor << std::endl
      << "Number of iterations: " << solver.num_iterations << std::endl
      << "Solutions obtained: " << solver.best_solutions.size() << std::endl
      << "Solving time: " << solver.solving_time << std::endl
-     << "Number of snapshots: " << solver.num_snapshots << std::endl
-     << "Time next snapshot: " << solver.time_next_snapshot << std::endl
-     << "Time when the last snapshot was taken: " << solver.time_last_snapshot
+     << "Number of snapshots: " << solver.snapshot_scheduler.num_snapshots
      << std::endl
+     << "Time next snapshot: " << solver.snapshot_scheduler.time_next_snapshot
+     << std::endl
+     << "Time when the last snapshot was taken: "
+     << solver.snapshot_scheduler.time_last_snapshot << std::endl
      << "Number of iteration of the next snapshot: "
-     << solver.iteration_next_snapshot << std::endl
+     << solver.snapshot_scheduler.iteration_next_snapshot << std::endl
      << "Iteration when the last snapshot was taken: "
-     << solver.iteration_last_snapshot << std::endl;
+     << solver.snapshot_scheduler.iteration_last_snapshot << std::endl;
+
+  if (solver.hypervolume_tracker) {
+    os << "Hypervolume: " << solver.hypervolume << std::endl
+       << "Iteration when the hypervolume last improved: "
+       << solver.iteration_last_hypervolume_improvement << std::endl;
+  }
+
   return os;
 }
 
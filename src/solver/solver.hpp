@@ -1,8 +1,18 @@
 #pragma once
 
+#include <functional>
+#include <optional>
+#include <pagmo/algorithm.hpp>
+#include <pagmo/bfe.hpp>
 #include <pagmo/population.hpp>
 
+#include "metrics/incremental_hypervolume.hpp"
 #include "solution/solution.hpp"
+#include "solver/archive_feed.hpp"
+#include "solver/nd_tree.hpp"
+#include "solver/non_dominated_sorting.hpp"
+#include "solver/snapshot_scheduler.hpp"
+#include "solver/snapshot_writer.hpp"
 
 namespace mopop {
 class Solver {
@@ -43,60 +53,43 @@ class Solver {
   unsigned max_num_snapshots = 0;
 
   /**
-   * @brief The number of iterations executed.
-   */
-  unsigned num_iterations = 0;
-
-  /**
-   * @brief The best individuals found.
-   */
-  std::vector<std::pair<std::vector<double>, std::vector<double>>>
-      best_individuals = {};
-
-  /**
-   * @brief The solutions found.
+   * @brief The number of threads to be used during the evaluation of the
+   * solutions.
    */
-  std::vector<Solution> best_solutions = {};
+  unsigned num_threads = 1;
 
   /**
-   * @brief The solving time in seconds.
+   * @brief The number of generations the pagmo algorithms advance per call to
+   * evolve, except for the last generations of the run, which they advance one
+   * at a time. The switch rebuilds the algorithm, which resets the state NSPSO
+   * and MHACO keep with memory.
    */
-  double solving_time = 0.0;
+  unsigned max_num_generations_per_evolve = 1;
 
   /**
-   * @brief The number of snapshots taken during optimization.
-   */
-  unsigned num_snapshots = 0;
-
-  /**
-   * @brief The factor at which the time snapshots are increased.
-   */
-  double time_snapshot_factor = 1.0;
-
-  /**
-   * @brief The factor at which the iterations snapshots are increased.
+   * @brief The number of iterations executed.
    */
-  double iteration_snapshot_factor = 1.0;
+  unsigned num_iterations = 0;
 
   /**
-   * @brief The time when the next snapshot will be taken.
+   * @brief The best individuals found, in no particular order.
    */
-  double time_next_snapshot = 0.0;
+  ND_Tree best_individuals;
 
   /**
-   * @brief The time when the last snapshot was taken.
+   * @brief The solutions found.
    */
-  double time_last_snapshot = 0.0;
+  std::vector<Solution> best_solutions = {};
 
   /**
-   * @brief The iteration when the next snapshot will be taken.
+   * @brief The solving time in seconds.
    */
-  unsigned iteration_next_snapshot = 0;
+  double solving_time = 0.0;
 
   /**
-   * @brief The iteration when the last snapshot was taken.
+   * @brief The schedule of the snapshots taken during optimization.
    */
-  unsigned iteration_last_snapshot = 0;
+  Snapshot_Scheduler snapshot_scheduler;
 
   /**
    * @brief The snapshots of the best solutions, containing the iteration, time
@@ -129,27 +122,87 @@ class Solver {
                          std::vector<std::vector<std::vector<double>>>>>
       populations_snapshots = {};
 
+  /**
+   * @brief The snapshots of the hypervolume of the best individuals, containing
+   * the iteration, time and hypervolume. Only taken when the hypervolume is
+   * tracked.
+   */
+  std::vector<std::tuple<unsigned, double, double>> hypervolume_snapshots = {};
+
+  /**
+   * @brief The writer the snapshots are streamed to as they are taken, or null
+   * to keep them in memory.
+   */
+  Snapshot_Writer* snapshot_writer = nullptr;
+
+  /**
+   * @brief The tracker of the hypervolume of the best individuals, present
+   * once a reference point is set.
+   */
+  std::optional<Incremental_Hypervolume> hypervolume_tracker;
+
+  /**
+   * @brief Whether the best individuals have changed since their hypervolume
+   * was last computed.
+   */
+  bool is_hypervolume_stale = false;
+
+  /**
+   * @brief The hypervolume of the best individuals when it was last computed.
+   */
+  double hypervolume = 0.0;
+
+  /**
+   * @brief The largest hypervolume counted as an improvement so far.
+   */
+  double best_hypervolume = 0.0;
+
+  /**
+   * @brief The iteration when the hypervolume last improved.
+   */
+  unsigned iteration_last_hypervolume_improvement = 0;
+
+  /**
+   * @brief The number of iterations without a hypervolume improvement after
+   * which the optimization stops.
+   */
+  unsigned hypervolume_stagnation_limit = std::numeric_limits<unsigned>::max();
+
+  /**
+   * @brief The relative increase of the hypervolume counted as an improvement.
+   */
+  double hypervolume_tolerance = 1e-6;
+
   /**
    * @brief The start time.
    */
   std::chrono::steady_clock::time_point start_time;
 
   /**
-   * @brief The current individuals.
+   * @brief The elapsed time in seconds when the clock was last read.
+   */
+  double current_time = 0.0;
+
+  /**
+   * @brief The time per generation of the last call to evolve, in seconds.
    */
-  std::vector<std::pair<std::vector<double>, std::vector<double>>>
-      current_individuals;
+  double time_per_generation = 0.0;
 
   /**
-   * @brief The current fronts.
+   * @brief The pagmo algorithm of the last call to evolve.
    */
-  std::vector<std::vector<std::pair<std::vector<double>, std::vector<double>>>>
-      fronts;
+  pagmo::algorithm algorithm;
 
   /**
-   * @brief The fitnesses of the current individuals.
+   * @brief The number of generations the pagmo algorithm advances per call to
+   * evolve, or zero if it has not been built yet.
    */
-  std::vector<std::vector<double>> f;
+  unsigned algorithm_num_generations = 0;
+
+  /**
+   * @brief The non-dominated sorting of the populations of the snapshots.
+   */
+  Non_Dominated_Sorting non_dominated_sorting;
 
   /**
    * @brief Constructs a new solver.
@@ -205,7 +258,48 @@ class Solver {
   double remaining_time() const;
 
   /**
-   * @brief Verifies whether the termination criteria have been met.
+   * @brief Starts the clock and the schedule of the snapshots.
+   */
+  void start_solving();
+
+  /**
+   * @brief Reads the clock.
+   *
+   * @return The elapsed time in seconds.
+   */
+  double read_clock();
+
+  /**
+   * @brief Tracks the hypervolume of the best individuals with respect to a
+   * reference point, from now on.
+   *
+   * @param reference_point The reference point.
+   *
+   * @throws std::runtime_error If the reference point does not have a value
+   * for each objective.
+   */
+  void set_reference_point(const std::vector<double>& reference_point);
+
+  /**
+   * @brief Tracks the hypervolume of the best individuals with respect to a
+   * reference point read from a file, as written by
+   * reference_pareto_front_and_point_calculator_exec.
+   *
+   * @param filename The name of the file.
+   *
+   * @throws std::runtime_error If the file cannot be read.
+   */
+  void load_reference_point(const std::string& filename);
+
+  /**
+   * @brief Computes the hypervolume of the best individuals if they have
+   * changed since it was last computed, and records whether it improved.
+   */
+  void update_hypervolume();
+
+  /**
+   * @brief Verifies whether the termination criteria have been met, as of the
+   * last reading of the clock.
    *
    * @return true if the termination criteria have been met; false otherwise.
    */
@@ -216,31 +310,26 @@ class Solver {
    *
    * @param best_individuals The best individuals found so far.
    * @param new_individuals The new individuals found.
-   * @param senses The optimisation senses.
    * @return true if the best individual are modified; false otherwise.
    */
   static bool update_best_individuals(
-      std::vector<std::pair<std::vector<double>, std::vector<double>>>&
-          best_individuals,
+      ND_Tree& best_individuals,
       const std::vector<std::pair<std::vector<double>, std::vector<double>>>&
-          new_individuals,
-      const std::vector<NSBRKGA::Sense>& senses);
+          new_individuals);
 
   /**
    * @brief Updates the best individuals found so far.
    *
    * @param best_individuals The best individuals found so far.
    * @param new_individuals The new individuals found.
-   * @param senses The optimisation senses.
    * @param max_num_solutions The maximum number of solutions.
    * @return true if the best individual are modified; false otherwise.
    */
   static bool update_best_individuals(
-      std::vector<std::pair<std::vector<double>, std::vector<double>>>&
-          best_individuals,
+      ND_Tree& best_individuals,
       const std::vector<std::pair<std::vector<double>, std::vector<double>>>&
           new_individuals,
-      const std::vector<NSBRKGA::Sense>& senses, unsigned max_num_solutions);
+      unsigned max_num_solutions);
 
   /**
    * @brief Updates the best individuals found so far.
@@ -253,12 +342,59 @@ class Solver {
           new_individuals);
 
   /**
-   * @brief Updates the best individuals found so far.
+   * @brief Updates the best individuals found so far with the individuals fed
+   * to them since the last update.
    *
-   * @param pop The new solutions.
+   * @param feed The feed of the best individuals.
    * @return true if the best individuals are modified; false otherwise.
    */
-  bool update_best_individuals(const pagmo::population& pop);
+  bool update_best_individuals(Archive_Feed& feed);
+
+  /**
+   * @brief Records that the best individuals have changed.
+   */
+  void invalidate_hypervolume();
+
+  /**
+   * @brief Returns the number of generations the next call to evolve should
+   * advance.
+   *
+   * @return The number of generations.
+   */
+  unsigned num_generations_per_evolve() const;
+
+  /**
+   * @brief Advances a population by a batch of generations of a pagmo
+   * algorithm, and updates the best individuals with the individuals
+   * evaluated meanwhile. The algorithm is built on the first call and rebuilt
+   * at most once, for the last generations of the run.
+   *
+   * @param pop The population, whose problem feeds the best individuals.
+   * @param feed The feed of the best individuals.
+   * @param build_algorithm Builds the algorithm advancing a number of
+   * generations per call to evolve, from a seed.
+   */
+  void evolve(pagmo::population& pop, Archive_Feed& feed,
+              const std::function<pagmo::algorithm(unsigned, unsigned)>&
+                  build_algorithm);
+
+  /**
+   * @brief Captures a snapshot of the hypervolume of the best individuals, if
+   * it is tracked.
+   *
+   * @param time_snapshot The time of the snapshot.
+   */
+  void capture_hypervolume_snapshot(double time_snapshot);
+
+  /**
+   * @brief Acquires a slab of the snapshot writer and fills it with the
+   * iteration, the time, the best individuals and their hypervolume, if it is
+   * tracked.
+   *
+   * @param time_snapshot The time of the snapshot.
+   * @return The slab, to be filled with the populations and published.
+   */
+  Snapshot& stream_snapshot(double time_snapshot);
 
   /**
    * @brief Captures a snapshot of the current population.
@@ -267,6 +403,12 @@ class Solver {
    */
   void capture_snapshot(const pagmo::population& pop);
 
+  /**
+   * @brief Counts the non-dominated individuals and the fronts of the
+   * population snapshots captured without them.
+   */
+  void complete_snapshots();
+
   /**
    * @brief Builds the deterministic seed chromosomes for the initial
    * population.
@@ -296,6 +438,14 @@ class Solver {
    * @return The stream object.
    */
   friend std::ostream& operator<<(std::ostream& os, const Solver& solver);
+
+  /**
+   * @brief Builds the batch fitness evaluator of the pagmo-based solvers.
+   *
+   * @param feed The feed of the best individuals.
+   * @return The batch fitness evaluator.
+   */
+  pagmo::bfe build_bfe(Archive_Feed& feed) const;
 };
 
 }  // namespace mopop
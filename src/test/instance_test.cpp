@@ -1,8 +1,12 @@
 #include "instance/instance.hpp"
 
 #include <cassert>
+#include <cstdint>
+#include <cstdio>
 #include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include <utility>
 
 int main() {
   mopop::Instance instance;
@@ -23,15 +27,241 @@ int main() {
          std::numeric_limits<double>::epsilon());
   assert(fabs(instance.expected_returns.back() - 0.005107159883158241) <
          std::numeric_limits<double>::epsilon());
-  assert(instance.covariance_matrix.size() == 7);
-  assert(instance.covariance_matrix.front().size() == 7);
-  assert(fabs(instance.covariance_matrix.front().front() -
-              0.00018574179740743447) < std::numeric_limits<double>::epsilon());
-  assert(instance.covariance_matrix.back().size() == 7);
-  assert(fabs(instance.covariance_matrix.back().front() -
-              0.00020082888001011015) < std::numeric_limits<double>::epsilon());
-  assert(fabs(instance.covariance_matrix.back().back() - 0.001061156598370683) <
+  assert(instance.covariance_stride == 8);
+  assert(instance.covariance_data.size() == 7 * 8);
+  assert(reinterpret_cast<std::uintptr_t>(instance.covariance_data.data()) %
+             mopop::Instance::covariance_alignment ==
+         0);
+  assert(instance.covariance_row(0).size() == 7);
+  assert(fabs(instance.covariance_row(0)[0] - 0.00018574179740743447) <
          std::numeric_limits<double>::epsilon());
+  assert(instance.covariance_row(6).size() == 7);
+  assert(fabs(instance.covariance(6, 0) - 0.00020082888001011015) <
+         std::numeric_limits<double>::epsilon());
+  assert(fabs(instance.covariance(6, 6) - 0.001061156598370683) <
+         std::numeric_limits<double>::epsilon());
+
+  for (unsigned i = 0; i < instance.num_assets; i++) {
+    assert(reinterpret_cast<std::uintptr_t>(instance.covariance_row(i).data()) %
+               mopop::Instance::covariance_alignment ==
+           0);
+    assert(fabs(instance.covariance_data[i * instance.covariance_stride + 7]) <
+           std::numeric_limits<double>::epsilon());
+  }
+
+  std::vector<std::vector<double>> covariance_matrix =
+      instance.covariance_matrix();
+
+  assert(covariance_matrix.size() == 7);
+  assert(covariance_matrix.front().size() == 7);
+  assert(fabs(covariance_matrix.front().front() - 0.00018574179740743447) <
+         std::numeric_limits<double>::epsilon());
+  assert(covariance_matrix.back().size() == 7);
+  assert(fabs(covariance_matrix.back().front() - 0.00020082888001011015) <
+         std::numeric_limits<double>::epsilon());
+  assert(fabs(covariance_matrix.back().back() - 0.001061156598370683) <
+         std::numeric_limits<double>::epsilon());
+
+  mopop::Instance copy(instance.tickers, instance.expected_returns,
+                       covariance_matrix);
+
+  assert(copy.is_valid());
+  assert(copy.covariance_stride == instance.covariance_stride);
+  assert(copy.covariance_data == instance.covariance_data);
+
+  mopop::Instance packed(instance);
+  packed.set_covariance_storage(mopop::Covariance_Storage::PACKED);
+
+  assert(packed.is_valid());
+  assert(packed.covariance_storage == mopop::Covariance_Storage::PACKED);
+  assert(packed.covariance_data.size() == 7 * 8 / 2);
+  assert(packed.packed_covariance_row(0).size() == 7);
+  assert(packed.packed_covariance_row(6).size() == 1);
+
+  // A view of another layout than the stored one is refused.
+  {
+    bool is_thrown = false;
+
+    try {
+      packed.covariance_row(0);
+    } catch (const std::runtime_error&) {
+      is_thrown = true;
+    }
+
+    assert(is_thrown);
+  }
+
+  for (unsigned i = 0; i < instance.num_assets; i++) {
+    for (unsigned j = 0; j < instance.num_assets; j++) {
+      assert(packed.covariance(i, j) == instance.covariance(i, j));
+    }
+  }
+
+  packed.set_covariance_storage(mopop::Covariance_Storage::DENSE);
+
+  assert(packed.is_valid());
+  assert(packed.covariance_data == instance.covariance_data);
+
+  mopop::Instance factor(expected_returns_filename,
+                         "input/factor_model_test.csv");
+
+  assert(factor.is_valid());
+  assert(factor.covariance_storage == mopop::Covariance_Storage::FACTOR);
+  assert(factor.num_factors == 2);
+  assert(factor.tickers == instance.tickers);
+  assert(factor.covariance_stride == 8);
+  assert(factor.covariance_data.size() == 3 * 8);
+  assert(fabs(factor.covariance(6, 0) -
+              (0.001718889357546043 * 0.20995151241291113 *
+                   0.6768987241951148 -
+               0.0005318774777437884 * 0.07675488603578413 *
+                   0.7057799297679281)) <
+         std::numeric_limits<double>::epsilon());
+
+  // The factor model of the test file is a principal component fit, which
+  // keeps the variances.
+  for (unsigned i = 0; i < instance.num_assets; i++) {
+    assert(fabs(factor.covariance(i, i) - instance.covariance(i, i)) <
+           std::numeric_limits<double>::epsilon());
+
+    for (unsigned j = 0; j < instance.num_assets; j++) {
+      assert(factor.covariance(i, j) == factor.covariance(j, i));
+    }
+  }
+
+  mopop::Instance expanded(factor);
+  expanded.set_covariance_storage(mopop::Covariance_Storage::PACKED);
+
+  assert(expanded.is_valid());
+  assert(expanded.num_factors == 0);
+
+  for (unsigned i = 0; i < instance.num_assets; i++) {
+    for (unsigned j = 0; j < instance.num_assets; j++) {
+      assert(expanded.covariance(i, j) == factor.covariance(i, j));
+    }
+  }
+
+  bool thrown = false;
+
+  try {
+    expanded.set_covariance_storage(mopop::Covariance_Storage::FACTOR);
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+
+  assert(thrown);
+
+  const std::string binary_filename = "instance_test.bin";
+
+  for (const mopop::Instance* written : {&instance, &expanded, &factor}) {
+    written->write_binary_file(binary_filename);
+
+    const mopop::Instance mapped(binary_filename);
+
+    assert(mapped.is_valid());
+    assert(mapped.covariance_data.is_view());
+    assert(reinterpret_cast<std::uintptr_t>(mapped.covariance_data.data()) %
+               mopop::Instance::covariance_alignment ==
+           0);
+    assert(mapped.num_assets == written->num_assets);
+    assert(mapped.tickers == written->tickers);
+    assert(mapped.expected_returns == written->expected_returns);
+    assert(mapped.covariance_storage == written->covariance_storage);
+    assert(mapped.covariance_stride == written->covariance_stride);
+    assert(mapped.num_factors == written->num_factors);
+    assert(mapped.covariance_data == written->covariance_data);
+
+    // A copy shares the mapped block, and converting it leaves the block as is.
+    mopop::Instance converted(mapped);
+
+    assert(converted.covariance_data.is_view());
+
+    // Reading a mutable instance keeps the view; only mutable_data copies.
+    assert(converted.covariance_data[0] == mapped.covariance_data[0]);
+    assert(converted.covariance(0, 0) == mapped.covariance(0, 0));
+    assert(converted.covariance_data.is_view());
+
+    converted.set_covariance_storage(mopop::Covariance_Storage::PACKED);
+
+    assert(converted.is_valid());
+    assert(mapped.covariance_data == written->covariance_data);
+  }
+
+  {
+    std::fstream file(binary_filename,
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-1, std::ios::end);
+    file.put('\x7f');
+  }
+
+  thrown = false;
+
+  try {
+    mopop::Instance corrupted(binary_filename);
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+
+  assert(thrown);
+
+  std::remove(binary_filename.c_str());
+
+  // The same files with Windows line ends, and a copy of the covariance file
+  // with a malformed entry.
+  const std::string crlf_expected_returns_filename =
+                        "instance_test_returns.csv",
+                    crlf_covariance_filename = "instance_test_covariance.csv",
+                    malformed_covariance_filename = "instance_test_bad.csv";
+
+  for (const std::pair<std::string, std::string>& copy :
+       {std::make_pair(expected_returns_filename,
+                       crlf_expected_returns_filename),
+        std::make_pair(covariance_filename, crlf_covariance_filename)}) {
+    std::ifstream input(copy.first);
+    std::ofstream output(copy.second, std::ios::binary);
+
+    for (std::string line; std::getline(input, line);) {
+      output << line << "\r\n";
+    }
+  }
+
+  {
+    std::ifstream input(covariance_filename);
+    std::ofstream output(malformed_covariance_filename);
+    std::string line;
+
+    std::getline(input, line);
+    output << line << "\n";
+    std::getline(input, line);
+    output << line.replace(line.rfind(','), 1, ";") << "\n";
+
+    while (std::getline(input, line)) {
+      output << line << "\n";
+    }
+  }
+
+  mopop::Instance crlf(crlf_expected_returns_filename,
+                       crlf_covariance_filename);
+
+  assert(crlf.tickers == instance.tickers);
+  assert(crlf.tickers.back() == "NVDC34.SA");
+  assert(crlf.expected_returns == instance.expected_returns);
+  assert(crlf.covariance_data == instance.covariance_data);
+
+  thrown = false;
+
+  try {
+    mopop::Instance malformed(expected_returns_filename,
+                              malformed_covariance_filename);
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+
+  assert(thrown);
+
+  std::remove(crlf_expected_returns_filename.c_str());
+  std::remove(crlf_covariance_filename.c_str());
+  std::remove(malformed_covariance_filename.c_str());
 
   std::cout << instance << std::endl;
 
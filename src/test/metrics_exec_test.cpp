@@ -0,0 +1,170 @@
+#include <cassert>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Returns the contents of a file.
+ */
+static std::string read(const std::filesystem::path& path) {
+  std::ifstream ifs(path);
+  std::stringstream ss;
+
+  assert(ifs.is_open());
+  ss << ifs.rdbuf();
+
+  return ss.str();
+}
+
+/**
+ * @brief Writes random points to a file, one point per line, as the solver
+ * execs write them.
+ */
+static void write_points(std::ofstream& ofs, std::mt19937& rng,
+                         unsigned num_points) {
+  std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+  for (unsigned i = 0; i < num_points; i++) {
+    for (unsigned k = 0; k < 4; k++) {
+      ofs << distribution(rng) << (k < 3 ? " " : "");
+    }
+
+    ofs << std::endl;
+  }
+}
+
+/**
+ * @brief Runs a command, which must succeed.
+ */
+static void run(const std::string& command) {
+  const int status = std::system(command.c_str());
+
+  assert(status == 0);
+}
+
+int main(int argc, char* argv[]) {
+  assert(argc > 1);
+
+  const std::filesystem::path exec_directory = argv[1];
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "mopop_metrics_exec_test";
+  const std::string instance_options =
+      " --expected-returns-filename input/expected_returns_test.csv"
+      " --covariance-filename input/covariance_matrix_test.csv";
+  const unsigned num_runs = 5, num_snapshots = 4;
+  const std::vector<std::string> metrics = {"hypervolume", "hvr", "nigd-plus"};
+  std::mt19937 rng(42);
+  std::string run_options;
+
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  // Runs whose final fronts and snapshots overlap, with more points between
+  // them than the reference front keeps.
+  for (unsigned i = 0; i < num_runs; i++) {
+    const std::string run_filename = directory / ("run_" + std::to_string(i));
+    std::ofstream pareto(run_filename + "_pareto.txt");
+
+    write_points(pareto, rng, 8 + i);
+
+    for (unsigned j = 0; j < num_snapshots; j++) {
+      std::ofstream snapshot(run_filename + "_snapshot_" + std::to_string(j) +
+                             ".txt");
+
+      snapshot << 10 * j << " " << 0.5 * j << std::endl;
+      write_points(snapshot, rng, 2 + 3 * j);
+    }
+
+    run_options += " --pareto-" + std::to_string(i) + " " + run_filename +
+                   "_pareto.txt --best-solutions-snapshots-" +
+                   std::to_string(i) + " " + run_filename + "_snapshot_";
+  }
+
+  // The reference front and point and every metric, from the separate
+  // calculators, one after the other, each reading what the previous wrote.
+  {
+    const std::filesystem::path output = directory / "separate";
+    const std::string reference_options =
+        " --reference-pareto " + (output / "reference_pareto.txt").string() +
+        " --reference-point " + (output / "reference_point.txt").string();
+    const std::vector<std::string> execs = {
+        "hypervolume_calculator_exec", "hypervolume_ratio_calculator_exec",
+        "normalized_modified_generational_distance_calculator_exec"};
+
+    std::filesystem::create_directories(output);
+    run((exec_directory / "reference_pareto_front_and_point_calculator_exec")
+            .string() +
+        instance_options + " --max-num-solutions 20" + run_options +
+        reference_options);
+
+    for (unsigned k = 0; k < metrics.size(); k++) {
+      std::string options;
+
+      for (unsigned i = 0; i < num_runs; i++) {
+        const std::string suffix = std::to_string(i);
+
+        options += " --" + metrics[k] + "-" + suffix + " " +
+                   (output / (metrics[k] + "_" + suffix + ".txt")).string() +
+                   " --" + metrics[k] + "-snapshots-" + suffix + " " +
+                   (output / (metrics[k] + "_snapshots_" + suffix + ".txt"))
+                       .string();
+      }
+
+      run((exec_directory / execs[k]).string() + instance_options +
+          run_options + reference_options + options);
+    }
+
+    assert(!read(output / "reference_pareto.txt").empty());
+  }
+
+  // The same files from metrics_exec, in one pass, with one and with several
+  // threads.
+  for (const unsigned num_threads : {1, 3}) {
+    const std::filesystem::path output =
+        directory / ("single_" + std::to_string(num_threads));
+    std::string options =
+        " --reference-pareto " + (output / "reference_pareto.txt").string() +
+        " --reference-point " + (output / "reference_point.txt").string();
+
+    for (unsigned k = 0; k < metrics.size(); k++) {
+      for (unsigned i = 0; i < num_runs; i++) {
+        const std::string suffix = std::to_string(i);
+
+        options += " --" + metrics[k] + "-" + suffix + " " +
+                   (output / (metrics[k] + "_" + suffix + ".txt")).string() +
+                   " --" + metrics[k] + "-snapshots-" + suffix + " " +
+                   (output / (metrics[k] + "_snapshots_" + suffix + ".txt"))
+                       .string();
+      }
+    }
+
+    std::filesystem::create_directories(output);
+    run((exec_directory / "metrics_exec").string() + instance_options +
+        " --max-num-solutions 20 --num-threads " + std::to_string(num_threads) +
+        run_options + options);
+
+    unsigned num_files = 0;
+
+    for (const std::filesystem::directory_entry& entry :
+         std::filesystem::directory_iterator(directory / "separate")) {
+      const std::filesystem::path filename = entry.path().filename();
+
+      assert(std::filesystem::exists(output / filename));
+      assert(read(output / filename) == read(entry.path()));
+      num_files++;
+    }
+
+    assert(num_files == 2 + 2 * metrics.size() * num_runs);
+  }
+
+  std::filesystem::remove_all(directory);
+
+  std::cout << std::endl << "Metrics Exec Test PASSED" << std::endl;
+
+  return 0;
+}
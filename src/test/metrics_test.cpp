@@ -1,121 +1,56 @@
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
 #include <limits>
 #include <pagmo/utils/hypervolume.hpp>
+#include <random>
+#include <utility>
 #include <vector>
 
+#include "evaluator/evaluator.hpp"
 #include "instance/instance.hpp"
+#include "metrics/hypervolume.hpp"
+#include "metrics/hypervolume_ratio.hpp"
+#include "metrics/igd_plus.hpp"
+#include "metrics/incremental_hypervolume.hpp"
+#include "metrics/normalized_igd_plus.hpp"
+#include "metrics/objective_bounds.hpp"
+#include "metrics/reference_front.hpp"
+#include "solver/nd_tree.hpp"
 
 /*
- * The quality indicator formulas live in the metric executables, inside their
- * main() translation units, so they cannot be linked against. This test mirrors
- * them over an analytic mixed-sense fixture: it is the formulas themselves that
- * are under test, since that is where the reference point construction, the
- * negation transform and the modified distance can go wrong silently.
- *
- * Keep these copies in sync with:
- *   src/exec/reference_pareto_front_and_point_calculator_exec.cpp
- *   src/exec/hypervolume_calculator_exec.cpp
- *   src/exec/hypervolume_ratio_calculator_exec.cpp
- *   src/exec/normalized_modified_generational_distance_calculator_exec.cpp
+ * The quality indicators come from the metrics library that the metric
+ * executables and the solvers link, so this test pins the real code to
+ * analytic values over a mixed-sense fixture: that is where the reference point
+ * construction, the negation transform and the modified distance can go wrong
+ * silently. The engines are also checked against pagmo and against brute-force
+ * oracles, which are kept naive on purpose.
  */
 
-/**
- * @brief Mirrors update_bounds from the reference point calculator.
- */
-static void update_bounds(const std::vector<NSBRKGA::Sense>& senses,
-                          const std::vector<double>& value,
-                          std::vector<double>& worst_values,
-                          std::vector<double>& best_values) {
-  for (unsigned i = 0; i < senses.size(); i++) {
-    if (senses[i] == NSBRKGA::Sense::MINIMIZE) {
-      if (worst_values[i] < value[i]) {
-        worst_values[i] = value[i];
-      }
-
-      if (best_values[i] > value[i]) {
-        best_values[i] = value[i];
-      }
-    } else {
-      if (worst_values[i] > value[i]) {
-        worst_values[i] = value[i];
-      }
-
-      if (best_values[i] < value[i]) {
-        best_values[i] = value[i];
-      }
-    }
-  }
-}
-
-/**
- * @brief Mirrors compute_reference_point from the reference point calculator.
- */
-static std::vector<double> compute_reference_point(
-    const std::vector<NSBRKGA::Sense>& senses,
-    const std::vector<double>& worst_values,
-    const std::vector<double>& best_values) {
-  std::vector<double> reference_point(senses.size(), 0.0);
-
-  for (unsigned i = 0; i < senses.size(); i++) {
-    double padding = 0.05 * std::fabs(best_values[i] - worst_values[i]);
-
-    if (padding < std::numeric_limits<double>::epsilon()) {
-      padding = 0.05 * std::fabs(worst_values[i]);
-    }
-
-    if (padding < std::numeric_limits<double>::epsilon()) {
-      padding = 0.05;
-    }
-
-    if (senses[i] == NSBRKGA::Sense::MINIMIZE) {
-      reference_point[i] = worst_values[i] + padding;
-    } else {
-      reference_point[i] = worst_values[i] - padding;
-    }
-  }
-
-  return reference_point;
-}
-
 /**
  * @brief Runs the whole reference point construction over a set of fronts.
  */
 static std::vector<double> reference_point_of(
     const std::vector<NSBRKGA::Sense>& senses,
     const std::vector<std::vector<double>>& points) {
-  std::vector<double> worst_values(senses.size(), 0.0);
-  std::vector<double> best_values(senses.size(), 0.0);
-
-  for (unsigned i = 0; i < senses.size(); i++) {
-    if (senses[i] == NSBRKGA::Sense::MINIMIZE) {
-      worst_values[i] = std::numeric_limits<double>::lowest();
-      best_values[i] = std::numeric_limits<double>::max();
-    } else {
-      worst_values[i] = std::numeric_limits<double>::max();
-      best_values[i] = std::numeric_limits<double>::lowest();
-    }
-  }
+  mopop::Objective_Bounds bounds(senses);
 
   for (const std::vector<double>& point : points) {
-    update_bounds(senses, point, worst_values, best_values);
+    bounds.update(point);
   }
 
-  return compute_reference_point(senses, worst_values, best_values);
+  return bounds.reference_point();
 }
 
 /**
- * @brief Mirrors compute_hypervolume from the hypervolume calculators.
+ * @brief Computes the hypervolume of a front with pagmo, as the hypervolume
+ * calculators did before they had an engine of their own.
  */
-static double compute_hypervolume(
+static double pagmo_hypervolume(
     const std::vector<NSBRKGA::Sense>& senses,
     const std::vector<double>& reference_point,
     const std::vector<std::vector<double>>& front) {
-  if (front.empty()) {
-    return 0.0;
-  }
-
   std::vector<double> reference_point_prime(reference_point.size());
   std::vector<std::vector<double>> front_prime(front.size());
 
@@ -143,7 +78,73 @@ static double compute_hypervolume(
 }
 
 /**
- * @brief Mirrors modified_distance from the NIGD+ calculator.
+ * @brief Computes the hypervolume of a front by brute force, over the grid
+ * spanned by the coordinates of its points and of the reference point. Every
+ * objective is minimised.
+ */
+static double grid_hypervolume(const std::vector<double>& reference_point,
+                               const std::vector<std::vector<double>>& front) {
+  std::vector<std::vector<double>> coordinates(reference_point.size());
+
+  for (unsigned i = 0; i < reference_point.size(); i++) {
+    for (const std::vector<double>& point : front) {
+      coordinates[i].push_back(std::min(point[i], reference_point[i]));
+    }
+
+    coordinates[i].push_back(reference_point[i]);
+    std::sort(coordinates[i].begin(), coordinates[i].end());
+    coordinates[i].erase(
+        std::unique(coordinates[i].begin(), coordinates[i].end()),
+        coordinates[i].end());
+  }
+
+  double hypervolume = 0.0;
+  std::vector<unsigned> cell(reference_point.size(), 0);
+
+  while (cell.back() + 1 < coordinates.back().size()) {
+    bool is_covered = false;
+
+    for (const std::vector<double>& point : front) {
+      bool covers = true;
+
+      for (unsigned i = 0; i < reference_point.size(); i++) {
+        if (point[i] > coordinates[i][cell[i]]) {
+          covers = false;
+        }
+      }
+
+      if (covers) {
+        is_covered = true;
+        break;
+      }
+    }
+
+    if (is_covered) {
+      double volume = 1.0;
+
+      for (unsigned i = 0; i < reference_point.size(); i++) {
+        volume *= coordinates[i][cell[i] + 1] - coordinates[i][cell[i]];
+      }
+
+      hypervolume += volume;
+    }
+
+    for (unsigned i = 0; i < reference_point.size(); i++) {
+      if (++cell[i] + 1 < coordinates[i].size() ||
+          i + 1 == reference_point.size()) {
+        break;
+      }
+
+      cell[i] = 0;
+    }
+  }
+
+  return hypervolume;
+}
+
+/**
+ * @brief Computes the modified distance from a reference point to a point by
+ * its definition.
  */
 static double modified_distance(const std::vector<NSBRKGA::Sense>& senses,
                                 const std::vector<double>& reference_point,
@@ -170,10 +171,10 @@ static double modified_distance(const std::vector<NSBRKGA::Sense>& senses,
 }
 
 /**
- * @brief Mirrors modified_inverted_generational_distance from the NIGD+
- * calculator.
+ * @brief Computes the modified inverted generational distance of a front by
+ * brute force, which the IGD+ engine must match bit for bit.
  */
-static double modified_inverted_generational_distance(
+static double brute_force_igd_plus(
     const std::vector<NSBRKGA::Sense>& senses,
     const std::vector<std::vector<double>>& reference_front,
     const std::vector<std::vector<double>>& front) {
@@ -200,6 +201,57 @@ static double modified_inverted_generational_distance(
   return igd_plus / reference_front.size();
 }
 
+/**
+ * @brief Finds the points a single pass of an archive over the points of some
+ * fronts, in order, keeps: those that no earlier point dominates or equals and
+ * that no later point dominates. The points are sorted.
+ */
+static std::vector<std::vector<double>> brute_force_non_dominated(
+    const std::vector<NSBRKGA::Sense>& senses,
+    const std::vector<std::vector<std::vector<double>>>& fronts) {
+  std::vector<std::vector<double>> points, result;
+
+  for (const std::vector<std::vector<double>>& front : fronts) {
+    points.insert(points.end(), front.begin(), front.end());
+  }
+
+  const auto covers = [&](const std::vector<double>& a,
+                          const std::vector<double>& b, bool strictly) {
+    bool is_better = false;
+
+    for (unsigned i = 0; i < senses.size(); i++) {
+      const double delta =
+          senses[i] == NSBRKGA::Sense::MINIMIZE ? b[i] - a[i] : a[i] - b[i];
+
+      if (delta < 0.0) {
+        return false;
+      }
+
+      is_better = is_better || delta > 0.0;
+    }
+
+    return is_better || !strictly;
+  };
+
+  for (unsigned j = 0; j < points.size(); j++) {
+    bool is_kept = true;
+
+    for (unsigned i = 0; i < points.size() && is_kept; i++) {
+      if (i != j && covers(points[i], points[j], i > j)) {
+        is_kept = false;
+      }
+    }
+
+    if (is_kept) {
+      result.push_back(points[j]);
+    }
+  }
+
+  std::sort(result.begin(), result.end());
+
+  return result;
+}
+
 /**
  * @brief Compares two doubles up to a tolerance.
  */
@@ -252,34 +304,129 @@ int main() {
 
   // Analytic hypervolume: the union of two boxes of volume 2.1 * 0.2 * 2.1 *
   // 0.2 = 0.1764 overlapping in a box of volume 0.1 * 0.2 * 0.1 * 0.2 = 0.0004.
-  double reference_hypervolume =
-      compute_hypervolume(senses, reference_point, reference_front);
+  const mopop::Hypervolume_Ratio hypervolume_ratio_engine(
+      senses, reference_point, reference_front);
+  double reference_hypervolume = hypervolume_ratio_engine.reference_hypervolume;
 
   assert(almost_equal(reference_hypervolume, 0.3524));
 
   // A front holding a single point covers just its own box.
-  double hypervolume_a = compute_hypervolume(senses, reference_point, {a});
+  double hypervolume_a = hypervolume_ratio_engine.engine.compute({a});
 
   assert(almost_equal(hypervolume_a, 0.1764));
 
   // A candidate front equal to the reference front scores exactly one. This is
   // the case the removed 5% front perturbation used to hide.
-  double hypervolume_ratio =
-      compute_hypervolume(senses, reference_point, reference_front) /
-      reference_hypervolume;
+  double hypervolume_ratio = hypervolume_ratio_engine.compute(reference_front);
 
   assert(almost_equal(hypervolume_ratio, 1.0, 1e-12));
   assert(hypervolume_ratio <= 1.0 + 1e-9);
 
   // A strictly smaller candidate front scores strictly between zero and one.
-  double partial_ratio = hypervolume_a / reference_hypervolume;
+  double partial_ratio = hypervolume_ratio_engine.compute({a});
 
   assert(partial_ratio > 0.0);
   assert(partial_ratio < 1.0);
   assert(almost_equal(partial_ratio, 0.1764 / 0.3524));
 
-  // An empty front scores zero instead of reaching pagmo.
-  assert(almost_equal(compute_hypervolume(senses, reference_point, {}), 0.0));
+  // An empty front scores zero.
+  assert(almost_equal(hypervolume_ratio_engine.compute({}), 0.0));
+
+  // The engine agrees with pagmo on the fixtures.
+  assert(almost_equal(
+      reference_hypervolume,
+      pagmo_hypervolume(senses, reference_point, reference_front), 1e-12));
+  assert(almost_equal(hypervolume_a,
+                      pagmo_hypervolume(senses, reference_point, {a}), 1e-12));
+
+  // On random fronts with ties, dominated points and points beyond the
+  // reference point, the engine agrees with a brute force over the grid of the
+  // coordinates and, up to rounding, with pagmo on the points that pagmo
+  // accepts.
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  const std::vector<NSBRKGA::Sense> minimize(4, NSBRKGA::Sense::MINIMIZE);
+
+  for (unsigned k = 0; k < 200; k++) {
+    std::vector<std::vector<double>> front(1 + rng() % 20,
+                                           std::vector<double>(4));
+    std::vector<std::vector<double>> inside;
+    std::vector<double> point_reference(4, k % 5 == 0 ? 0.8 : 1.2);
+
+    for (std::vector<double>& point : front) {
+      double sum = 0.0;
+
+      for (double& value : point) {
+        value = k % 3 == 0 ? std::floor(4.0 * uniform(rng)) / 4.0
+                           : -std::log(uniform(rng) + 1e-12);
+        sum += value;
+      }
+
+      for (double& value : point) {
+        value /= k % 2 == 0 && sum > 0.0 ? sum : 1.0;
+      }
+
+      bool is_inside = true;
+
+      for (unsigned i = 0; i < 4; i++) {
+        is_inside = is_inside && point[i] < point_reference[i];
+      }
+
+      if (is_inside) {
+        inside.push_back(point);
+      }
+    }
+
+    double hypervolume =
+        mopop::Hypervolume(minimize, point_reference).compute(front);
+    double expected = grid_hypervolume(point_reference, front);
+
+    assert(almost_equal(hypervolume, expected, 1e-12 * (1.0 + expected)));
+
+    if (!inside.empty()) {
+      assert(almost_equal(hypervolume,
+                          pagmo_hypervolume(minimize, point_reference, inside),
+                          1e-12 * (1.0 + expected)));
+    }
+  }
+
+  // Tracking a sequence of fronts that each add and remove a few points, some
+  // of them dominated, duplicated or beyond the reference point, gives the
+  // hypervolume of every front, whether it is updated incrementally or
+  // computed from scratch.
+  const mopop::Hypervolume engine(senses, reference_point);
+  mopop::Incremental_Hypervolume tracker(senses, reference_point);
+  std::vector<std::vector<double>> front;
+
+  assert(almost_equal(tracker.update(front), 0.0));
+
+  for (unsigned k = 0; k < 300; k++) {
+    for (unsigned l = rng() % 4; l > 0 && !front.empty(); l--) {
+      front.erase(front.begin() + rng() % front.size());
+    }
+
+    for (unsigned l = k == 0 ? 100 : rng() % 4; l > 0; l--) {
+      if (!front.empty() && rng() % 10 == 0) {
+        front.push_back(front[rng() % front.size()]);
+      } else {
+        std::vector<double> point(4);
+
+        for (unsigned i = 0; i < 4; i++) {
+          point[i] = 0.7 + 2.5 * uniform(rng);
+        }
+
+        front.push_back(point);
+      }
+    }
+
+    double expected = engine.compute(front);
+
+    assert(
+        almost_equal(tracker.update(front), expected, 1e-9 * (1.0 + expected)));
+  }
+
+  assert(tracker.num_incremental_updates > 0);
+  assert(tracker.num_full_updates > 0);
 
   // The modified distance only charges the objectives on which the point is
   // worse than the reference point, whatever the sense of each objective.
@@ -287,14 +434,16 @@ int main() {
   std::vector<double> worse_everywhere = {1.0, 3.0, 1.0, 3.0};
   std::vector<double> better_everywhere = {3.0, 1.0, 3.0, 1.0};
 
-  assert(almost_equal(modified_distance(senses, centre, worse_everywhere), 2.0));
-  assert(
-      almost_equal(modified_distance(senses, centre, better_everywhere), 0.0));
+  assert(almost_equal(
+      mopop::IGD_Plus(senses, {centre}).compute({worse_everywhere}), 2.0));
+  assert(almost_equal(
+      mopop::IGD_Plus(senses, {centre}).compute({better_everywhere}), 0.0));
 
   // The normalizer is the distance from the reference front to the reference
   // point, which is the largest value any front can reach.
-  double reference_igd_plus = modified_inverted_generational_distance(
-      senses, reference_front, {reference_point});
+  const mopop::Normalized_IGD_Plus normalized_igd_plus_engine(
+      senses, reference_front, reference_point);
+  double reference_igd_plus = normalized_igd_plus_engine.reference_igd_plus;
 
   assert(reference_igd_plus > 0.0);
   assert(almost_equal(reference_igd_plus,
@@ -302,22 +451,86 @@ int main() {
 
   // A candidate front equal to the reference front scores exactly zero.
   double normalized_igd_plus =
-      modified_inverted_generational_distance(senses, reference_front,
-                                              reference_front) /
-      reference_igd_plus;
+      normalized_igd_plus_engine.compute(reference_front);
 
   assert(almost_equal(normalized_igd_plus, 0.0));
 
   // A strictly smaller candidate front scores strictly between zero and one.
-  double partial_igd_plus =
-      modified_inverted_generational_distance(senses, reference_front, {a}) /
-      reference_igd_plus;
+  double partial_igd_plus = normalized_igd_plus_engine.compute({a});
 
   assert(partial_igd_plus > 0.0);
   assert(partial_igd_plus < 1.0);
   assert(almost_equal(partial_igd_plus,
                       (std::sqrt(32.0) / 2.0) / reference_igd_plus));
 
+  // An empty front scores one.
+  assert(normalized_igd_plus_engine.compute({}) == 1.0);
+
+  // The IGD+ engine prunes the front and scans it in vectors, but it takes the
+  // same minimum of the same sums, so it matches the brute force bit for bit.
+  const mopop::IGD_Plus& igd_plus = normalized_igd_plus_engine.engine;
+
+  assert(igd_plus.compute({reference_point}) ==
+         brute_force_igd_plus(senses, reference_front, {reference_point}));
+  assert(igd_plus.compute(reference_front) ==
+         brute_force_igd_plus(senses, reference_front, reference_front));
+  assert(igd_plus.compute({a}) ==
+         brute_force_igd_plus(senses, reference_front, {a}));
+  assert(std::isinf(igd_plus.compute({})));
+
+  // Random fronts large enough to build a tree, with mixed senses, repeated
+  // points and objective values tied on a coarse grid, under every instruction
+  // set the CPU supports.
+  const mopop::Instruction_Set supported = mopop::supported_instruction_set();
+
+  for (int instruction_set = 0; instruction_set <= int(supported);
+       instruction_set++) {
+    mopop::set_instruction_set(mopop::Instruction_Set(instruction_set));
+
+    for (unsigned k = 0; k < 40; k++) {
+      const auto random_points = [&](unsigned num_points) {
+        std::vector<std::vector<double>> points;
+
+        while (points.size() < num_points) {
+          if (!points.empty() && rng() % 10 == 0) {
+            points.push_back(points[rng() % points.size()]);
+            continue;
+          }
+
+          std::vector<double> point(4);
+
+          for (double& value : point) {
+            value = k % 2 == 0 ? std::floor(8.0 * uniform(rng)) / 8.0
+                               : 4.0 * uniform(rng) - 2.0;
+          }
+
+          points.push_back(point);
+        }
+
+        return points;
+      };
+      std::vector<NSBRKGA::Sense> random_senses(4);
+
+      for (NSBRKGA::Sense& sense : random_senses) {
+        sense = rng() % 2 == 0 ? NSBRKGA::Sense::MINIMIZE
+                               : NSBRKGA::Sense::MAXIMIZE;
+      }
+
+      const std::vector<std::vector<double>> random_reference_front =
+          random_points(1 + rng() % 200);
+      const std::vector<std::vector<double>> random_front =
+          random_points(1 + rng() % 400);
+      const mopop::IGD_Plus random_igd_plus(random_senses,
+                                            random_reference_front);
+
+      assert(random_igd_plus.compute(random_front) ==
+             brute_force_igd_plus(random_senses, random_reference_front,
+                                  random_front));
+    }
+  }
+
+  mopop::set_instruction_set(supported);
+
   // Objectives 0 and 2 take negative values on daily returns. The padding is
   // additive on the attained range, so it still moves the reference point away
   // from the front, which a multiplicative perturbation would not.
@@ -342,10 +555,10 @@ int main() {
     }
   }
 
-  // pagmo accepts the negated front against the negated reference point, which
-  // is what breaks when the untransformed reference point is passed through.
-  assert(compute_hypervolume(senses, negative_reference_point, negative_front) >
-         0.0);
+  // The engine negates the front and the reference point alike, which is what
+  // breaks when the untransformed reference point is passed through.
+  assert(mopop::Hypervolume(senses, negative_reference_point)
+             .compute(negative_front) > 0.0);
 
   // An objective that took a single value across every front still gets a
   // padding, and so does one that took the single value zero.
@@ -358,6 +571,59 @@ int main() {
   assert(almost_equal(constant_reference_point[2], -0.05));
   assert(almost_equal(constant_reference_point[3], 5.25));
 
+  // The reference front keeps the points a single pass of a bounded archive
+  // over all of them in order keeps, in the order of that archive, and without
+  // a bound the points no earlier point covers and no later point dominates.
+  // The values lie on a coarse grid, so that there are ties and repeated
+  // points.
+  for (unsigned k = 0; k < 20; k++) {
+    std::vector<std::vector<std::vector<double>>> fronts(rng() % 40);
+
+    for (std::vector<std::vector<double>>& front : fronts) {
+      front.resize(rng() % 60);
+
+      for (std::vector<double>& point : front) {
+        point.resize(4);
+
+        for (double& value : point) {
+          value = std::floor(16.0 * uniform(rng)) / 16.0;
+        }
+      }
+    }
+
+    // The final fronts are the leading fronts, and the snapshots the others.
+    const unsigned num_paretos = rng() % (fronts.size() + 1);
+    const std::vector<std::vector<std::vector<double>>> paretos(
+        fronts.begin(), fronts.begin() + num_paretos);
+    const std::vector<std::vector<std::vector<double>>> snapshots(
+        fronts.begin() + num_paretos, fronts.end());
+    const unsigned max_num_solutions = 1 + rng() % 40;
+    mopop::ND_Tree archive(senses);
+    std::vector<std::vector<double>> expected;
+
+    archive.set_max_size(max_num_solutions);
+
+    for (const std::vector<std::vector<double>>& front : fronts) {
+      for (const std::vector<double>& value : front) {
+        archive.update(std::make_pair(value, std::vector<double>()));
+      }
+    }
+
+    for (const mopop::ND_Tree::Individual& individual : archive) {
+      expected.push_back(individual.first);
+    }
+
+    std::vector<std::vector<double>> non_dominated =
+        mopop::Reference_Front(senses).compute(paretos, snapshots);
+
+    std::sort(non_dominated.begin(), non_dominated.end());
+
+    assert(non_dominated == brute_force_non_dominated(senses, fronts));
+    assert(mopop::Reference_Front(senses, max_num_solutions)
+               .compute(paretos, snapshots) == expected);
+    assert(expected.size() <= max_num_solutions);
+  }
+
   std::cout << "Metrics test passed." << std::endl;
 
   return 0;
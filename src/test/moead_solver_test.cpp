@@ -28,6 +28,7 @@ int main() {
   assert(solver.max_num_solutions == 128);
   assert(solver.population_size == 32);
   assert(solver.max_num_snapshots == 16);
+  assert(solver.num_threads == 1);
   assert(solver.weight_generation == "random");
   assert(solver.decomposition == "tchebycheff");
   assert(solver.neighbours == 20);
@@ -50,12 +51,16 @@ int main() {
   assert(solver.best_solutions.size() > 0);
   assert(solver.best_solutions.size() <= solver.max_num_solutions);
 
-  assert(solver.num_snapshots == solver.max_num_snapshots);
+  assert(solver.snapshot_scheduler.num_snapshots == solver.max_num_snapshots);
 
-  assert(solver.best_solutions_snapshots.size() == solver.num_snapshots);
-  assert(solver.num_non_dominated_snapshots.size() == solver.num_snapshots);
-  assert(solver.num_fronts_snapshots.size() == solver.num_snapshots);
-  assert(solver.populations_snapshots.size() == solver.num_snapshots);
+  assert(solver.best_solutions_snapshots.size() ==
+         solver.snapshot_scheduler.num_snapshots);
+  assert(solver.num_non_dominated_snapshots.size() ==
+         solver.snapshot_scheduler.num_snapshots);
+  assert(solver.num_fronts_snapshots.size() ==
+         solver.snapshot_scheduler.num_snapshots);
+  assert(solver.populations_snapshots.size() ==
+         solver.snapshot_scheduler.num_snapshots);
 
   for (const auto& s1 : solver.best_solutions) {
     assert(s1.is_feasible());
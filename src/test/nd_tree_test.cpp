@@ -0,0 +1,272 @@
+#include "solver/nd_tree.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+typedef mopop::ND_Tree::Individual Individual;
+
+/**
+ * @brief Returns whether a value dominates another, as Solution::dominates.
+ */
+static bool dominates(const std::vector<double>& a,
+                      const std::vector<double>& b,
+                      const std::vector<NSBRKGA::Sense>& senses) {
+  const double epsilon = std::numeric_limits<double>::epsilon();
+  bool at_least_as_good = true, better = false;
+
+  for (unsigned i = 0; i < senses.size(); i++) {
+    double x = senses[i] == NSBRKGA::Sense::MINIMIZE ? a[i] : -a[i];
+    double y = senses[i] == NSBRKGA::Sense::MINIMIZE ? b[i] : -b[i];
+
+    if (x > y + epsilon) {
+      at_least_as_good = false;
+    } else if (x < y - epsilon) {
+      better = true;
+    }
+  }
+
+  return at_least_as_good && better;
+}
+
+/**
+ * @brief Updates a plain archive the way the tree is expected to.
+ */
+static bool update(std::vector<Individual>& archive,
+                   const Individual& individual,
+                   const std::vector<NSBRKGA::Sense>& senses) {
+  const double epsilon = std::numeric_limits<double>::epsilon();
+
+  for (const Individual& other : archive) {
+    if (dominates(other.first, individual.first, senses) ||
+        std::equal(other.first.begin(), other.first.end(),
+                   individual.first.begin(),
+                   [&](double a, double b) { return fabs(a - b) < epsilon; })) {
+      return false;
+    }
+  }
+
+  archive.erase(std::remove_if(archive.begin(), archive.end(),
+                               [&](const Individual& other) {
+                                 return dominates(individual.first,
+                                                  other.first, senses);
+                               }),
+                archive.end());
+  archive.push_back(individual);
+
+  return true;
+}
+
+/**
+ * @brief Evicts the most crowded individuals of a plain archive until it has
+ * at most max_size of them.
+ */
+static void truncate(std::vector<Individual>& archive, unsigned max_size,
+                     const std::vector<NSBRKGA::Sense>& senses) {
+  while (archive.size() > max_size) {
+    std::vector<double> distances(archive.size(), 0.0);
+
+    for (unsigned i = 0; i < senses.size(); i++) {
+      std::vector<std::pair<double, unsigned>> order;
+
+      for (unsigned j = 0; j < archive.size(); j++) {
+        order.emplace_back(senses[i] == NSBRKGA::Sense::MINIMIZE
+                               ? archive[j].first[i]
+                               : -archive[j].first[i],
+                           j);
+      }
+
+      std::sort(order.begin(), order.end());
+
+      double range = order.back().first - order.front().first;
+
+      distances[order.front().second] = std::numeric_limits<double>::infinity();
+      distances[order.back().second] = std::numeric_limits<double>::infinity();
+
+      for (unsigned j = 1; j + 1 < order.size() && range > 0.0; j++) {
+        distances[order[j].second] +=
+            (order[j + 1].first - order[j - 1].first) / range;
+      }
+    }
+
+    archive.erase(archive.begin() +
+                  (std::min_element(distances.begin(), distances.end()) -
+                   distances.begin()));
+  }
+}
+
+/**
+ * @brief Returns the sorted objective values of some individuals.
+ */
+template <class Individuals>
+static std::vector<std::vector<double>> values(const Individuals& individuals) {
+  std::vector<std::vector<double>> result;
+
+  for (const Individual& individual : individuals) {
+    result.push_back(individual.first);
+  }
+
+  std::sort(result.begin(), result.end());
+
+  return result;
+}
+
+int main() {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+  for (const std::vector<NSBRKGA::Sense>& senses :
+       {std::vector<NSBRKGA::Sense>(4, NSBRKGA::Sense::MINIMIZE),
+        std::vector<NSBRKGA::Sense>{
+            NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE,
+            NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MAXIMIZE}}) {
+    mopop::ND_Tree tree(senses);
+    std::vector<Individual> archive;
+
+    assert(tree.empty());
+
+    // Points around a shrinking simplex, so that many of them are
+    // non-dominated and the tree grows several levels deep, while the later
+    // ones keep removing earlier ones. A few points are repeated.
+    for (unsigned k = 0; k < 5000; k++) {
+      Individual individual;
+
+      if (k % 50 == 49 && !archive.empty()) {
+        individual = archive[rng() % archive.size()];
+      } else {
+        std::vector<double> value(4, 0.0);
+        double sum = 0.0;
+
+        for (double& v : value) {
+          v = -std::log(uniform(rng) + 1e-12);
+          sum += v;
+        }
+
+        double scale = 1.0 + 0.1 * uniform(rng) - 0.5 * k / 5000.0;
+
+        for (unsigned i = 0; i < 4; i++) {
+          value[i] *= scale / sum;
+
+          if (senses[i] == NSBRKGA::Sense::MAXIMIZE) {
+            value[i] = -value[i];
+          }
+        }
+
+        individual = std::make_pair(value, std::vector<double>(1, k));
+      }
+
+      // The tree rejects exactly the points it covers, and it covers every
+      // point it has seen. Every other individual is read through views of
+      // its vectors.
+      const bool is_covered = tree.covers(individual.first);
+      const bool is_updated =
+          k % 2 == 0
+              ? tree.update(individual)
+              : tree.update(mopop::Span<const double>(individual.first.data(),
+                                                      individual.first.size()),
+                            mopop::Span<const double>(
+                                individual.second.data(),
+                                individual.second.size()));
+
+      assert(is_updated == update(archive, individual, senses));
+      assert(is_updated == !is_covered);
+      assert(tree.covers(individual.first));
+      assert(tree.size() == archive.size());
+    }
+
+    assert(archive.size() > 500);
+    assert(values(tree) == values(archive));
+
+    // The chromosomes travel with their objective values.
+    for (const Individual& individual : tree) {
+      assert(std::find(archive.begin(), archive.end(), individual) !=
+             archive.end());
+    }
+
+    mopop::ND_Tree copy(senses);
+    copy.assign(std::vector<Individual>(tree.begin(), tree.end()));
+
+    assert(values(copy) == values(tree));
+
+    // Bounding the archive evicts the most crowded individuals one at a time,
+    // and so does every later update past the bound.
+    mopop::ND_Tree bounded(senses);
+    std::vector<Individual> bounded_archive;
+
+    bounded.assign(std::vector<Individual>(tree.begin(), tree.end()));
+    bounded.set_max_size(200);
+    bounded_archive = archive;
+    truncate(bounded_archive, 200, senses);
+
+    assert(bounded.max_size() == 200);
+    assert(values(bounded) == values(bounded_archive));
+
+    for (unsigned k = 0; k < 1000; k++) {
+      std::vector<double> value(4, 0.0);
+      double sum = 0.0;
+
+      for (double& v : value) {
+        v = -std::log(uniform(rng) + 1e-12);
+        sum += v;
+      }
+
+      double scale = 0.5 + 0.1 * uniform(rng) - 0.2 * k / 1000.0;
+
+      for (unsigned i = 0; i < 4; i++) {
+        value[i] *= scale / sum;
+
+        if (senses[i] == NSBRKGA::Sense::MAXIMIZE) {
+          value[i] = -value[i];
+        }
+      }
+
+      Individual individual = std::make_pair(value, std::vector<double>());
+
+      bounded.update(individual);
+      update(bounded_archive, individual, senses);
+      truncate(bounded_archive, 200, senses);
+
+      assert(bounded.size() == bounded_archive.size());
+      assert(values(bounded) == values(bounded_archive));
+    }
+
+    // A point that dominates the whole archive empties the tree.
+    std::vector<double> best(4, -10.0);
+
+    for (unsigned i = 0; i < 4; i++) {
+      if (senses[i] == NSBRKGA::Sense::MAXIMIZE) {
+        best[i] = -best[i];
+      }
+    }
+
+    assert(tree.update(std::make_pair(best, std::vector<double>())));
+    assert(tree.size() == 1);
+    assert(!tree.update(std::make_pair(best, std::vector<double>())));
+
+    tree.clear();
+
+    assert(tree.empty());
+    assert(copy.update(std::make_pair(best, std::vector<double>())));
+    assert(copy.size() == 1);
+  }
+
+  bool thrown = false;
+
+  try {
+    mopop::ND_Tree tree(
+        std::vector<NSBRKGA::Sense>(3, NSBRKGA::Sense::MINIMIZE));
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+
+  assert(thrown);
+
+  std::cout << std::endl << "ND-Tree Test PASSED" << std::endl;
+
+  return 0;
+}
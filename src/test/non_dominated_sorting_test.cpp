@@ -0,0 +1,152 @@
+#include "solver/non_dominated_sorting.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Returns whether a value dominates another, with no tolerance.
+ */
+static bool dominates(const std::vector<double>& a,
+                      const std::vector<double>& b,
+                      const std::vector<NSBRKGA::Sense>& senses) {
+  bool at_least_as_good = true, better = false;
+
+  for (unsigned i = 0; i < senses.size(); i++) {
+    double x = senses[i] == NSBRKGA::Sense::MINIMIZE ? a[i] : -a[i];
+    double y = senses[i] == NSBRKGA::Sense::MINIMIZE ? b[i] : -b[i];
+
+    if (x > y) {
+      at_least_as_good = false;
+    } else if (x < y) {
+      better = true;
+    }
+  }
+
+  return at_least_as_good && better;
+}
+
+/**
+ * @brief Sorts points into fronts by peeling off the non-dominated points of
+ * the remaining ones, one front at a time. Each front is sorted.
+ */
+static std::vector<std::vector<unsigned>> peel(
+    const std::vector<std::vector<double>>& values,
+    const std::vector<NSBRKGA::Sense>& senses) {
+  std::vector<std::vector<unsigned>> fronts;
+  std::vector<bool> is_sorted(values.size(), false);
+  unsigned num_sorted = 0;
+
+  while (num_sorted < values.size()) {
+    fronts.emplace_back();
+
+    for (unsigned j = 0; j < values.size(); j++) {
+      bool is_dominated = false;
+
+      for (unsigned k = 0; k < values.size() && !is_dominated; k++) {
+        is_dominated =
+            !is_sorted[k] && dominates(values[k], values[j], senses);
+      }
+
+      if (!is_sorted[j] && !is_dominated) {
+        fronts.back().push_back(j);
+      }
+    }
+
+    for (unsigned j : fronts.back()) {
+      is_sorted[j] = true;
+    }
+
+    num_sorted += fronts.back().size();
+  }
+
+  return fronts;
+}
+
+int main() {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+  for (const std::vector<NSBRKGA::Sense>& senses :
+       {std::vector<NSBRKGA::Sense>(4, NSBRKGA::Sense::MINIMIZE),
+        std::vector<NSBRKGA::Sense>{
+            NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE,
+            NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE}}) {
+    mopop::Non_Dominated_Sorting sorting(senses);
+
+    // An empty population has no front.
+    sorting.sort({});
+
+    assert(sorting.num_fronts() == 0);
+
+    // Populations of every size, on a coarse grid or not, so that there are
+    // ties on single objectives and repeated points. The same sorting is
+    // reused, and shrinks and grows from one population to the next.
+    for (unsigned k = 0; k < 200; k++) {
+      std::vector<std::vector<double>> values(rng() % 300);
+
+      for (std::vector<double>& value : values) {
+        if (&value != &values.front() && rng() % 10 == 0) {
+          value = values[rng() % (&value - &values.front())];
+          continue;
+        }
+
+        value.resize(4);
+
+        for (double& v : value) {
+          v = k % 2 == 0 ? std::floor(6.0 * uniform(rng)) : uniform(rng);
+        }
+      }
+
+      const std::vector<std::vector<unsigned>> expected = peel(values, senses);
+
+      sorting.sort(values);
+
+      assert(sorting.num_fronts() == expected.size());
+
+      for (unsigned i = 0; i < sorting.num_fronts(); i++) {
+        const mopop::Span<const unsigned> front = sorting.front(i);
+        std::vector<unsigned> indices(front.begin(), front.end());
+
+        // The points of a front are in lexicographic order of their
+        // normalised values.
+        for (unsigned j = 1; j < indices.size(); j++) {
+          std::vector<double> a = values[indices[j - 1]],
+                              b = values[indices[j]];
+
+          for (unsigned l = 0; l < senses.size(); l++) {
+            if (senses[l] == NSBRKGA::Sense::MAXIMIZE) {
+              a[l] = -a[l];
+              b[l] = -b[l];
+            }
+          }
+
+          assert(a <= b);
+        }
+
+        std::sort(indices.begin(), indices.end());
+
+        assert(indices == expected[i]);
+      }
+    }
+  }
+
+  bool thrown = false;
+
+  try {
+    mopop::Non_Dominated_Sorting sorting(
+        std::vector<NSBRKGA::Sense>(3, NSBRKGA::Sense::MINIMIZE));
+  } catch (const std::runtime_error&) {
+    thrown = true;
+  }
+
+  assert(thrown);
+
+  std::cout << std::endl << "Non-Dominated Sorting Test PASSED" << std::endl;
+
+  return 0;
+}
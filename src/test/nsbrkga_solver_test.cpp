@@ -74,13 +74,18 @@ int main() {
   assert(solver.best_solutions.size() > 0);
   assert(solver.best_solutions.size() <= solver.max_num_solutions);
 
-  assert(solver.num_snapshots == solver.max_num_snapshots);
-
-  assert(solver.best_solutions_snapshots.size() == solver.num_snapshots);
-  assert(solver.num_non_dominated_snapshots.size() == solver.num_snapshots);
-  assert(solver.num_fronts_snapshots.size() == solver.num_snapshots);
-  assert(solver.populations_snapshots.size() == solver.num_snapshots);
-  assert(solver.num_elites_snapshots.size() == solver.num_snapshots);
+  assert(solver.snapshot_scheduler.num_snapshots == solver.max_num_snapshots);
+
+  assert(solver.best_solutions_snapshots.size() ==
+         solver.snapshot_scheduler.num_snapshots);
+  assert(solver.num_non_dominated_snapshots.size() ==
+         solver.snapshot_scheduler.num_snapshots);
+  assert(solver.num_fronts_snapshots.size() ==
+         solver.snapshot_scheduler.num_snapshots);
+  assert(solver.populations_snapshots.size() ==
+         solver.snapshot_scheduler.num_snapshots);
+  assert(solver.num_elites_snapshots.size() ==
+         solver.snapshot_scheduler.num_snapshots);
 
   for (const auto& s1 : solver.best_solutions) {
     assert(s1.is_feasible());
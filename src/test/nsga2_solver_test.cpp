@@ -1,6 +1,7 @@
 #include "solver/nsga2/nsga2_solver.hpp"
 
 #include <cassert>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <random>
@@ -20,6 +21,8 @@ int main() {
   solver.max_num_solutions = 128;
   solver.population_size = 32;
   solver.max_num_snapshots = 16;
+  solver.num_threads = 2;
+  solver.set_reference_point({-1.0, 1.0, -100.0, 100.0});
 
   assert((solver.seed = 2351389233));
   assert(fabs(solver.time_limit - 5.0) <
@@ -28,6 +31,7 @@ int main() {
   assert(solver.max_num_solutions == 128);
   assert(solver.population_size == 32);
   assert(solver.max_num_snapshots == 16);
+  assert(solver.num_threads == 2);
   assert(fabs(solver.crossover_probability - 0.95) <
          std::numeric_limits<double>::epsilon());
   assert(fabs(solver.crossover_distribution - 10.00) <
@@ -49,12 +53,19 @@ int main() {
   assert(solver.best_solutions.size() > 0);
   assert(solver.best_solutions.size() <= solver.max_num_solutions);
 
-  assert(solver.num_snapshots == solver.max_num_snapshots);
+  assert(solver.snapshot_scheduler.num_snapshots == solver.max_num_snapshots);
+  assert(solver.hypervolume_snapshots.size() ==
+         solver.snapshot_scheduler.num_snapshots);
+  assert(solver.hypervolume > 0.0);
 
-  assert(solver.best_solutions_snapshots.size() == solver.num_snapshots);
-  assert(solver.num_non_dominated_snapshots.size() == solver.num_snapshots);
-  assert(solver.num_fronts_snapshots.size() == solver.num_snapshots);
-  assert(solver.populations_snapshots.size() == solver.num_snapshots);
+  assert(solver.best_solutions_snapshots.size() ==
+         solver.snapshot_scheduler.num_snapshots);
+  assert(solver.num_non_dominated_snapshots.size() ==
+         solver.snapshot_scheduler.num_snapshots);
+  assert(solver.num_fronts_snapshots.size() ==
+         solver.snapshot_scheduler.num_snapshots);
+  assert(solver.populations_snapshots.size() ==
+         solver.snapshot_scheduler.num_snapshots);
 
   for (const auto& s1 : solver.best_solutions) {
     assert(s1.is_feasible());
@@ -184,6 +195,114 @@ int main() {
     mopop::assert_solver_invariants(bug5_solver);
   }
 
+  // Several generations per call to evolve, from one algorithm, up to the last
+  // generations before the iterations limit, which are advanced one at a time,
+  // and snapshots taken between calls.
+  {
+    mopop::NSGA2_Solver batched_solver(instance);
+
+    batched_solver.set_seed(2351389233);
+    batched_solver.time_limit = 5.0;
+    batched_solver.iterations_limit = 100;
+    batched_solver.max_num_solutions = 128;
+    batched_solver.population_size = 32;
+    batched_solver.max_num_snapshots = 16;
+    batched_solver.max_num_generations_per_evolve = 16;
+    batched_solver.set_reference_point({-1.0, 1.0, -100.0, 100.0});
+
+    batched_solver.solve();
+
+    mopop::assert_solver_invariants(batched_solver);
+
+    assert(batched_solver.best_solutions.size() > 0);
+    assert(batched_solver.num_iterations == batched_solver.iterations_limit);
+    assert(batched_solver.snapshot_scheduler.num_snapshots > 2);
+    assert(std::get<0>(batched_solver.best_solutions_snapshots.back()) ==
+           batched_solver.iterations_limit);
+
+    for (const auto& snapshot : batched_solver.best_solutions_snapshots) {
+      assert(std::get<0>(snapshot) % 16 == 0 || std::get<0>(snapshot) > 96);
+    }
+  }
+
+  // An archive bound small enough to evict from every generation keeps the
+  // same individuals whatever the number of threads evaluating them.
+  {
+    std::vector<std::pair<std::vector<double>, std::vector<double>>>
+        best_individuals[2];
+
+    for (const unsigned num_threads : {1, 4}) {
+      mopop::NSGA2_Solver threaded_solver(instance);
+
+      threaded_solver.set_seed(2351389233);
+      threaded_solver.iterations_limit = 50;
+      threaded_solver.max_num_solutions = 8;
+      threaded_solver.population_size = 64;
+      threaded_solver.num_threads = num_threads;
+
+      threaded_solver.solve();
+
+      for (std::size_t i = 0; i < threaded_solver.best_individuals.size();
+           i++) {
+        best_individuals[num_threads > 1].push_back(
+            threaded_solver.best_individuals[i]);
+      }
+    }
+
+    assert(best_individuals[0].size() == 8);
+    assert(best_individuals[0] == best_individuals[1]);
+  }
+
+  // Snapshots streamed to disk as they are taken, and not kept in memory.
+  {
+    const std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / "mopop_nsga2_solver_test";
+    mopop::NSGA2_Solver streamed_solver(instance);
+    mopop::Snapshot_Writer snapshot_writer(instance.senses, 16);
+
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    streamed_solver.set_seed(2351389233);
+    streamed_solver.iterations_limit = 100;
+    streamed_solver.max_num_solutions = 128;
+    streamed_solver.population_size = 32;
+    streamed_solver.max_num_snapshots = 16;
+    streamed_solver.set_reference_point({-1.0, 1.0, -100.0, 100.0});
+
+    snapshot_writer.populations_snapshots_filename = directory / "population_";
+    snapshot_writer.hypervolume_snapshots_filename =
+        directory / "hypervolume.txt";
+    snapshot_writer.start();
+    streamed_solver.snapshot_writer = &snapshot_writer;
+    streamed_solver.solve();
+    snapshot_writer.close();
+
+    assert(streamed_solver.snapshot_scheduler.num_snapshots ==
+           streamed_solver.max_num_snapshots);
+    assert(streamed_solver.best_solutions_snapshots.empty());
+    assert(streamed_solver.hypervolume_snapshots.empty());
+    assert(streamed_solver.populations_snapshots.empty());
+    assert(streamed_solver.num_fronts_snapshots.empty());
+
+    std::ifstream ifs(directory / "hypervolume.txt");
+    std::string line;
+    unsigned num_lines = 0;
+
+    while (std::getline(ifs, line)) {
+      num_lines++;
+    }
+
+    assert(num_lines == streamed_solver.max_num_snapshots);
+
+    for (unsigned i = 0; i < streamed_solver.max_num_snapshots; i++) {
+      assert(std::filesystem::exists(
+          directory / ("population_" + std::to_string(i) + ".txt")));
+    }
+
+    std::filesystem::remove_all(directory);
+  }
+
   // The instance that originally exposed BUG 5, when it has been built. Its
   // seed chromosomes outnumber the population, which exercises the cap in
   // Solver::build_initial_chromosomes.
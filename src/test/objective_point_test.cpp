@@ -0,0 +1,100 @@
+#include "solution/objective_point.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Returns whether a value dominates another, comparing the objectives
+ * one at a time in their own senses.
+ */
+static bool dominates(const std::vector<double>& a,
+                      const std::vector<double>& b,
+                      const std::vector<NSBRKGA::Sense>& senses,
+                      double epsilon) {
+  bool at_least_as_good = true, better = false;
+
+  for (unsigned i = 0; i < senses.size(); i++) {
+    if (senses[i] == NSBRKGA::Sense::MINIMIZE) {
+      if (a[i] > b[i] + epsilon) {
+        at_least_as_good = false;
+      } else if (a[i] < b[i] - epsilon) {
+        better = true;
+      }
+    } else {
+      if (a[i] < b[i] - epsilon) {
+        at_least_as_good = false;
+      } else if (a[i] > b[i] + epsilon) {
+        better = true;
+      }
+    }
+  }
+
+  return at_least_as_good && better;
+}
+
+/**
+ * @brief Returns whether a value dominates another or is equal to it up to the
+ * tolerance on every objective.
+ */
+static bool covers(const std::vector<double>& a, const std::vector<double>& b,
+                   const std::vector<NSBRKGA::Sense>& senses, double epsilon) {
+  bool equal = true;
+
+  for (unsigned i = 0; i < senses.size(); i++) {
+    if (std::fabs(a[i] - b[i]) >= epsilon) {
+      equal = false;
+    }
+  }
+
+  return dominates(a, b, senses, epsilon) || equal;
+}
+
+int main() {
+  constexpr double epsilon = std::numeric_limits<double>::epsilon();
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+  for (const std::vector<NSBRKGA::Sense>& senses :
+       {std::vector<NSBRKGA::Sense>(4, NSBRKGA::Sense::MINIMIZE),
+        std::vector<NSBRKGA::Sense>{
+            NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE,
+            NSBRKGA::Sense::MAXIMIZE, NSBRKGA::Sense::MINIMIZE}}) {
+    const mopop::Objective_Point point =
+        mopop::to_objective_point({1.0, 2.0, 3.0, 4.0}, senses);
+
+    for (unsigned i = 0; i < 4; i++) {
+      assert(point[i] == (senses[i] == NSBRKGA::Sense::MINIMIZE ? 1.0 : -1.0) *
+                             (i + 1.0));
+    }
+
+    // Values on a coarse grid, some of them moved by about the tolerance, so
+    // that there are ties, near ties and repeated values.
+    for (unsigned k = 0; k < 100000; k++) {
+      std::vector<double> a(4), b(4);
+
+      for (unsigned i = 0; i < 4; i++) {
+        a[i] = std::floor(3.0 * uniform(rng));
+        b[i] = rng() % 2 == 0 ? a[i] : std::floor(3.0 * uniform(rng));
+
+        if (rng() % 4 == 0) {
+          b[i] = std::nextafter(b[i], rng() % 2 == 0 ? -1.0 : 4.0);
+        }
+      }
+
+      const mopop::Objective_Point x = mopop::to_objective_point(a, senses),
+                                   y = mopop::to_objective_point(b, senses);
+
+      assert(mopop::dominates(x, y) == dominates(a, b, senses, epsilon));
+      assert(mopop::dominates(x, y, 0.0) == dominates(a, b, senses, 0.0));
+      assert(mopop::covers(x, y) == covers(a, b, senses, epsilon));
+    }
+  }
+
+  std::cout << std::endl << "Objective Point Test PASSED" << std::endl;
+
+  return 0;
+}
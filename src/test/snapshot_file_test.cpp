@@ -0,0 +1,193 @@
+#include "utils/snapshot_file.hpp"
+
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+int main() {
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "mopop_snapshot_file_test";
+  const std::string filename = directory / "snapshots.bin";
+  const unsigned num_objectives = 4, num_snapshots = 6;
+  std::vector<std::vector<std::vector<double>>> snapshots;
+
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  // Fronts of growing size, the first one empty, with values that text would
+  // round.
+  for (unsigned j = 0; j < num_snapshots; j++) {
+    snapshots.emplace_back();
+
+    for (unsigned i = 0; i < 3 * j; i++) {
+      std::vector<double> value(num_objectives);
+
+      for (unsigned k = 0; k < num_objectives; k++) {
+        value[k] = 1.0 / (1.0 + i + 7 * k) + j;
+      }
+
+      snapshots.back().push_back(value);
+    }
+  }
+
+  {
+    mopop::Snapshot_File_Writer writer;
+
+    writer.open(filename, num_objectives);
+
+    for (unsigned j = 0; j < num_snapshots; j++) {
+      writer.append(10 * j, 0.125 * j, snapshots[j]);
+    }
+
+    writer.close();
+  }
+
+  assert(mopop::Snapshot_File_Reader::is_snapshot_file(filename));
+
+  // Random access through the index, snapshots read out of order.
+  {
+    const mopop::Snapshot_File_Reader reader(filename);
+
+    assert(reader.num_objectives == num_objectives);
+    assert(reader.num_snapshots() == num_snapshots);
+
+    for (unsigned j = num_snapshots; j-- > 0;) {
+      assert(reader.iteration(j) == 10 * j);
+      assert(reader.time(j) == 0.125 * j);
+      assert(reader.count(j) == snapshots[j].size());
+      assert(reader.points(j) == snapshots[j]);
+
+      for (unsigned k = 0; k < num_objectives; k++) {
+        for (unsigned i = 0; i < reader.count(j); i++) {
+          assert(reader.column(j, k)[i] == snapshots[j][i][k]);
+        }
+      }
+    }
+  }
+
+  // A run that stopped before closing its file leaves it without an index, and
+  // possibly with a partial last block. The whole blocks are still read.
+  {
+    const std::uintmax_t size = std::filesystem::file_size(filename);
+    const std::uintmax_t index_size = num_snapshots * 8 + 24;
+    const std::uintmax_t last_block_size =
+        24 + snapshots.back().size() * num_objectives * 8;
+
+    std::filesystem::resize_file(filename, size - index_size);
+
+    {
+      const mopop::Snapshot_File_Reader reader(filename);
+
+      assert(reader.num_snapshots() == num_snapshots);
+      assert(reader.points(num_snapshots - 1) == snapshots.back());
+    }
+
+    std::filesystem::resize_file(filename, size - index_size - 8);
+
+    {
+      const mopop::Snapshot_File_Reader reader(filename);
+
+      assert(reader.num_snapshots() == num_snapshots - 1);
+      assert(reader.points(num_snapshots - 2) == snapshots[num_snapshots - 2]);
+    }
+
+    std::filesystem::resize_file(filename,
+                                 size - index_size - last_block_size);
+
+    {
+      const mopop::Snapshot_File_Reader reader(filename);
+
+      assert(reader.num_snapshots() == num_snapshots - 1);
+    }
+  }
+
+  // A text file is not a binary snapshot file, and neither is a missing one.
+  {
+    const std::string text_filename = directory / "pareto.txt";
+    std::ofstream ofs(text_filename);
+    bool is_thrown = false;
+
+    ofs << "0.1 0.2 0.3 0.4" << std::endl;
+    ofs.close();
+
+    assert(!mopop::Snapshot_File_Reader::is_snapshot_file(text_filename));
+    assert(!mopop::Snapshot_File_Reader::is_snapshot_file(directory /
+                                                          "missing.bin"));
+
+    try {
+      mopop::Snapshot_File_Reader reader(text_filename);
+    } catch (const std::runtime_error&) {
+      is_thrown = true;
+    }
+
+    assert(is_thrown);
+  }
+
+  // The same snapshots in both formats read the same through the shared
+  // readers, which refuse another number of objectives.
+  {
+    const std::string binary_filename = directory / "run.bin",
+                      text_prefix = directory / "run_snapshot_";
+    mopop::Snapshot_File_Writer writer;
+
+    writer.open(binary_filename, num_objectives);
+
+    for (unsigned j = 0; j < num_snapshots; j++) {
+      std::ofstream ofs(text_prefix + std::to_string(j) + ".txt");
+
+      writer.append(10 * j, 0.125 * j, snapshots[j]);
+      ofs << std::setprecision(std::numeric_limits<double>::max_digits10)
+          << 10 * j << " " << 0.125 * j << "\n";
+
+      for (const std::vector<double>& value : snapshots[j]) {
+        for (unsigned k = 0; k < num_objectives; k++) {
+          ofs << value[k] << (k + 1 < num_objectives ? " " : "\n");
+        }
+      }
+    }
+
+    writer.close();
+
+    for (const std::string& name : {binary_filename, text_prefix}) {
+      const mopop::Front_Snapshots read =
+          mopop::read_front_snapshots(name, num_objectives);
+
+      assert(read.fronts == snapshots);
+      assert(read.iterations.size() == num_snapshots);
+      assert(read.iterations.back() == 10 * (num_snapshots - 1));
+      assert(read.times.back() == 0.125 * (num_snapshots - 1));
+    }
+
+    assert(mopop::read_front(binary_filename, num_objectives) ==
+           snapshots.back());
+
+    assert(mopop::read_front(directory / "pareto.txt", num_objectives) ==
+           std::vector<std::vector<double>>({{0.1, 0.2, 0.3, 0.4}}));
+
+    for (const std::string& name :
+         {binary_filename, std::string(directory / "pareto.txt")}) {
+      for (const unsigned other_num_objectives :
+           {num_objectives - 1, num_objectives + 1}) {
+        bool is_thrown = false;
+
+        try {
+          mopop::read_front(name, other_num_objectives);
+        } catch (const std::runtime_error&) {
+          is_thrown = true;
+        }
+
+        assert(is_thrown);
+      }
+    }
+  }
+
+  std::filesystem::remove_all(directory);
+
+  std::cout << std::endl << "Snapshot File Test PASSED" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include "solver/snapshot_scheduler.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Returns the iterations of the snapshots taken by a solver running one
+ * iteration per generation, as the schedule used to be computed inline in
+ * every solve.
+ */
+static std::vector<unsigned> iterations_snapshots(unsigned iterations_limit,
+                                                  unsigned max_num_snapshots) {
+  std::vector<unsigned> result;
+  unsigned num_iterations = 0, num_snapshots = 0;
+  unsigned iteration_next_snapshot = 0, iteration_last_snapshot = 0;
+  double iteration_snapshot_factor = 1.0;
+
+  if (max_num_snapshots > num_snapshots + 1) {
+    result.push_back(num_iterations);
+    iteration_last_snapshot = num_iterations;
+    num_snapshots++;
+    iteration_snapshot_factor =
+        std::pow(iterations_limit / (iteration_last_snapshot + 1.0),
+                 1.0 / (max_num_snapshots - num_snapshots));
+    iteration_next_snapshot = unsigned(std::round(
+        double(iteration_last_snapshot) * iteration_snapshot_factor));
+  }
+
+  while (num_iterations < iterations_limit) {
+    num_iterations++;
+
+    if (max_num_snapshots > num_snapshots + 1 &&
+        num_iterations >= iteration_next_snapshot) {
+      result.push_back(num_iterations);
+      iteration_last_snapshot = num_iterations;
+      num_snapshots++;
+      iteration_next_snapshot = unsigned(std::round(
+          double(iteration_last_snapshot) * iteration_snapshot_factor));
+      iteration_snapshot_factor =
+          std::pow(iterations_limit / iteration_last_snapshot,
+                   1.0 / (max_num_snapshots - num_snapshots));
+    }
+  }
+
+  if (max_num_snapshots > 0) {
+    result.push_back(num_iterations);
+  }
+
+  return result;
+}
+
+int main() {
+  for (unsigned iterations_limit : {1u, 10u, 100u, 1000u, 12345u}) {
+    for (unsigned max_num_snapshots : {0u, 1u, 2u, 3u, 16u, 64u}) {
+      mopop::Snapshot_Scheduler scheduler;
+      std::vector<unsigned> result;
+      unsigned num_iterations = 0;
+
+      scheduler.start(std::numeric_limits<double>::max(), iterations_limit,
+                      max_num_snapshots);
+
+      if (scheduler.is_due(num_iterations, 0.0)) {
+        result.push_back(num_iterations);
+        scheduler.record(num_iterations, 1e-3);
+      }
+
+      while (num_iterations < iterations_limit) {
+        num_iterations++;
+
+        if (scheduler.is_due(num_iterations, 1e-3 * num_iterations)) {
+          result.push_back(num_iterations);
+          scheduler.record(num_iterations, 1e-3 * num_iterations);
+        }
+      }
+
+      if (max_num_snapshots > 0) {
+        result.push_back(num_iterations);
+        scheduler.record(num_iterations, 1e-3 * num_iterations);
+      }
+
+      assert(result == iterations_snapshots(iterations_limit,
+                                            max_num_snapshots));
+      assert(scheduler.num_snapshots == result.size());
+    }
+  }
+
+  // Snapshots by time alone, growing towards the time limit, with the last one
+  // left for when the optimization stops.
+  {
+    mopop::Snapshot_Scheduler scheduler;
+    std::vector<double> times;
+
+    scheduler.start(1.0, std::numeric_limits<unsigned>::max(), 8);
+
+    for (unsigned k = 1; k <= 1000; k++) {
+      const double time = 1e-3 * k;
+
+      if (scheduler.is_due(k - 1, time)) {
+        times.push_back(time);
+        scheduler.record(k - 1, time);
+      }
+    }
+
+    assert(times.size() == 7);
+    assert(!scheduler.is_active());
+
+    for (unsigned i = 1; i < times.size(); i++) {
+      assert(times[i] > times[i - 1]);
+    }
+  }
+
+  std::cout << std::endl << "Snapshot Scheduler Test PASSED" << std::endl;
+
+  return 0;
+}
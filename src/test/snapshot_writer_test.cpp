@@ -0,0 +1,206 @@
+#include "solver/snapshot_writer.hpp"
+
+#include <cassert>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * @brief Returns the contents of a file.
+ */
+static std::string read(const std::filesystem::path& path) {
+  std::ifstream ifs(path);
+  std::stringstream ss;
+
+  assert(ifs.is_open());
+  ss << ifs.rdbuf();
+
+  return ss.str();
+}
+
+int main() {
+  const std::vector<NSBRKGA::Sense> senses(4, NSBRKGA::Sense::MINIMIZE);
+  const std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "mopop_snapshot_writer_test";
+  const unsigned num_snapshots = 5;
+
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+
+  {
+    mopop::Snapshot_Writer writer(senses, num_snapshots);
+
+    writer.best_solutions_snapshots_filename = directory / "best_solutions_";
+    writer.hypervolume_snapshots_filename = directory / "hypervolume.txt";
+    writer.num_non_dominated_snapshots_filename =
+        directory / "num_non_dominated.txt";
+    writer.num_fronts_snapshots_filename = directory / "num_fronts.txt";
+    writer.populations_snapshots_filename = directory / "populations_";
+    writer.num_elites_snapshots_filename = directory / "num_elites.txt";
+    writer.start();
+
+    // More snapshots handed over at once than there are slabs up front. The
+    // populations are sorted by the writer, except for the last one, which
+    // comes with its counts.
+    for (unsigned k = 0; k < num_snapshots; k++) {
+      mopop::Snapshot& snapshot = writer.acquire();
+
+      snapshot.iteration = 10 * k;
+      snapshot.time = 0.25 * k;
+      snapshot.best_solutions = {{0.0, 1.0, 2.0, 3.0 + k},
+                                 {1.0, 0.5, 2.0, 3.0}};
+      snapshot.has_hypervolume = k % 2 == 0;
+      snapshot.hypervolume = 1.5 * k;
+      snapshot.populations = {
+          {{0.0, 0.0, 0.0, 0.0}, {1.0, 1.0, 1.0, 1.0}, {2.0, 2.0, 2.0, 2.0}},
+          {{0.0, 1.0, 0.0, 0.0}, {1.0, 0.0, 0.0, 0.0}, {2.0, 2.0, 2.0, 2.0}}};
+      snapshot.num_non_dominated.clear();
+      snapshot.num_fronts.clear();
+      snapshot.num_elites = {k, k + 1};
+
+      if (k + 1 == num_snapshots) {
+        snapshot.num_non_dominated = {7, 8};
+        snapshot.num_fronts = {9, 10};
+      }
+
+      writer.publish();
+    }
+
+    writer.close();
+  }
+
+  std::ostringstream hypervolume, num_non_dominated, num_fronts, num_elites;
+
+  for (unsigned k = 0; k < num_snapshots; k++) {
+    const std::string index = std::to_string(k);
+    std::ostringstream best_solutions, populations;
+
+    best_solutions << 10 * k << " " << 0.25 * k << std::endl
+                   << "0 1 2 " << 3.0 + k << std::endl
+                   << "1 0.5 2 3" << std::endl;
+    assert(read(directory / ("best_solutions_" + index + ".txt")) ==
+           best_solutions.str());
+
+    populations << 10 * k << " " << 0.25 * k << std::endl
+                << "0 0 0 0" << std::endl
+                << "1 1 1 1" << std::endl
+                << "2 2 2 2" << std::endl
+                << "0 1 0 0" << std::endl
+                << "1 0 0 0" << std::endl
+                << "2 2 2 2" << std::endl;
+    assert(read(directory / ("populations_" + index + ".txt")) ==
+           populations.str());
+
+    if (k % 2 == 0) {
+      hypervolume << 10 * k << "," << 0.25 * k << "," << 1.5 * k << std::endl;
+    }
+
+    num_non_dominated << 10 * k << " " << 0.25 * k << " "
+                      << (k + 1 == num_snapshots ? "7 8" : "1 2") << std::endl;
+    num_fronts << 10 * k << " " << 0.25 * k << " "
+               << (k + 1 == num_snapshots ? "9 10" : "3 2") << std::endl;
+    num_elites << 10 * k << " " << 0.25 * k << " " << k << " " << k + 1
+               << std::endl;
+  }
+
+  assert(read(directory / "hypervolume.txt") == hypervolume.str());
+  assert(read(directory / "num_non_dominated.txt") == num_non_dominated.str());
+  assert(read(directory / "num_fronts.txt") == num_fronts.str());
+  assert(read(directory / "num_elites.txt") == num_elites.str());
+  assert(!std::filesystem::exists(directory / ("best_solutions_" +
+                                               std::to_string(num_snapshots) +
+                                               ".txt")));
+
+  // The best solutions and the populations of every snapshot in a binary
+  // snapshot file each, the populations one after the other.
+  {
+    mopop::Snapshot_Writer writer(senses, num_snapshots);
+
+    writer.is_binary = true;
+    writer.best_solutions_snapshots_filename = directory / "best_solutions.bin";
+    writer.populations_snapshots_filename = directory / "populations.bin";
+    writer.start();
+
+    for (unsigned k = 0; k < num_snapshots; k++) {
+      mopop::Snapshot& snapshot = writer.acquire();
+
+      snapshot.iteration = 10 * k;
+      snapshot.time = 0.25 * k;
+      snapshot.best_solutions = {{0.0, 1.0, 2.0, 3.0 + k}};
+      snapshot.populations = {{{0.0, 0.0, 0.0, 0.1 * k}},
+                              {{1.0, 0.0, 0.0, 0.0}, {2.0, 2.0, 2.0, 2.0}}};
+      writer.publish();
+    }
+
+    writer.close();
+
+    const mopop::Snapshot_File_Reader best_solutions(directory /
+                                                     "best_solutions.bin");
+    const mopop::Snapshot_File_Reader populations(directory /
+                                                  "populations.bin");
+
+    assert(best_solutions.num_snapshots() == num_snapshots);
+    assert(populations.num_snapshots() == num_snapshots);
+
+    for (unsigned k = 0; k < num_snapshots; k++) {
+      assert(best_solutions.iteration(k) == 10 * k);
+      assert(best_solutions.time(k) == 0.25 * k);
+      assert(best_solutions.points(k) ==
+             std::vector<std::vector<double>>({{0.0, 1.0, 2.0, 3.0 + k}}));
+      assert(populations.iteration(k) == 10 * k);
+      assert(populations.points(k) ==
+             std::vector<std::vector<double>>({{0.0, 0.0, 0.0, 0.1 * k},
+                                               {1.0, 0.0, 0.0, 0.0},
+                                               {2.0, 2.0, 2.0, 2.0}}));
+    }
+
+    assert(!std::filesystem::exists(directory / "best_solutions.bin0.txt"));
+  }
+
+  // A file written once that cannot be created fails before the optimization,
+  // and a file per snapshot when the writer is closed.
+  {
+    mopop::Snapshot_Writer writer(senses, num_snapshots);
+    bool is_thrown = false;
+
+    writer.hypervolume_snapshots_filename = directory / "missing" / "file.txt";
+
+    try {
+      writer.start();
+    } catch (const std::runtime_error&) {
+      is_thrown = true;
+    }
+
+    assert(is_thrown);
+  }
+
+  {
+    mopop::Snapshot_Writer writer(senses, num_snapshots);
+    bool is_thrown = false;
+
+    writer.populations_snapshots_filename = directory / "missing" / "file_";
+    writer.start();
+
+    for (unsigned k = 0; k < num_snapshots; k++) {
+      mopop::Snapshot& snapshot = writer.acquire();
+
+      snapshot.populations = {{{0.0, 0.0, 0.0, 0.0}}};
+      writer.publish();
+    }
+
+    try {
+      writer.close();
+    } catch (const std::runtime_error&) {
+      is_thrown = true;
+    }
+
+    assert(is_thrown);
+  }
+
+  std::filesystem::remove_all(directory);
+
+  std::cout << std::endl << "Snapshot Writer Test PASSED" << std::endl;
+
+  return 0;
+}
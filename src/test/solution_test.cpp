@@ -1,9 +1,13 @@
 #include "solution/solution.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <iostream>
 
+#include "evaluator/evaluator.hpp"
+#include "evaluator/incremental_evaluator.hpp"
+
 int main() {
   mopop::Instance instance;
   mopop::Solution solution;
@@ -79,6 +83,198 @@ int main() {
     std::cout << solution << std::endl;
   }
 
+  {
+    mopop::Instance packed(instance);
+    packed.set_covariance_storage(mopop::Covariance_Storage::PACKED);
+
+    std::vector<double> key = {0.3, 0.1, 0.9, 0.0, 0.4, 0.7, 0.2};
+    mopop::Solution dense_solution(instance, key);
+    mopop::Solution packed_solution(packed, key);
+
+    assert(packed_solution.is_feasible());
+    assert(fabs(packed_solution.value[0] - dense_solution.value[0]) <
+           std::numeric_limits<double>::epsilon());
+    assert(fabs(packed_solution.value[1] - dense_solution.value[1]) <
+           1e-12 * dense_solution.value[1]);
+    assert(fabs(packed_solution.value[3] - dense_solution.value[3]) <
+           std::numeric_limits<double>::epsilon());
+  }
+
+  {
+    // A synthetic instance large enough to run both the full-width loops and
+    // the masked tails of the vector kernels.
+    const unsigned num_assets = 37;
+    std::vector<std::string> tickers(num_assets);
+    std::vector<double> expected_returns(num_assets), key(num_assets);
+    std::vector<std::vector<double>> covariance_matrix(
+        num_assets, std::vector<double>(num_assets));
+
+    for (unsigned i = 0; i < num_assets; i++) {
+      tickers[i] = "A" + std::to_string(i);
+      expected_returns[i] = 0.001 * ((i * 7) % 11) - 0.004;
+      key[i] = (i % 5 == 3) ? 0.0 : 0.1 * ((i * 13) % 17);
+
+      for (unsigned j = 0; j < num_assets; j++) {
+        covariance_matrix[i][j] =
+            1e-4 * (1.0 + ((i * j) % 7)) + (i == j ? 1e-3 : 0.0);
+      }
+    }
+
+    mopop::Instance dense(tickers, expected_returns, covariance_matrix),
+        packed(dense);
+    dense.set_covariance_storage(mopop::Covariance_Storage::DENSE);
+    packed.set_covariance_storage(mopop::Covariance_Storage::PACKED);
+
+    // A factor model with correlated factors, checked against its expansion.
+    const unsigned num_factors = 3;
+    std::vector<std::vector<double>> loadings(
+        num_assets, std::vector<double>(num_factors));
+    std::vector<double> idiosyncratic_variances(num_assets);
+    const std::vector<std::vector<double>> factor_covariance = {
+        {1e-4, 2e-5, 0.0}, {2e-5, 5e-5, 1e-5}, {0.0, 1e-5, 3e-5}};
+
+    for (unsigned i = 0; i < num_assets; i++) {
+      idiosyncratic_variances[i] = 1e-4 * (1.0 + i % 3);
+
+      for (unsigned f = 0; f < num_factors; f++) {
+        loadings[i][f] = 0.1 * ((i * (f + 3)) % 7) - 0.1;
+      }
+    }
+
+    mopop::Instance factor(tickers, expected_returns, loadings,
+                           factor_covariance, idiosyncratic_variances),
+        expanded(factor);
+    expanded.set_covariance_storage(mopop::Covariance_Storage::DENSE);
+
+    // Six keys fill one tile of the batch kernel and part of another, and
+    // include a degenerate one and sparse ones that skip rows.
+    const unsigned num_keys = 6;
+    std::vector<double> keys;
+
+    for (unsigned p = 0; p < num_keys; p++) {
+      for (unsigned i = 0; i < num_assets; i++) {
+        const bool zero = p == 2 || (p % 2 == 1 && i % 3 == 0);
+        keys.push_back(zero ? 0.0 : key[(i + 5 * p) % num_assets]);
+      }
+    }
+
+    const mopop::Instruction_Set supported = mopop::supported_instruction_set();
+    mopop::set_instruction_set(mopop::Instruction_Set::SCALAR);
+    mopop::Solution reference(dense, key), factor_reference(expanded, key);
+
+    for (mopop::Instruction_Set instruction_set :
+         {mopop::Instruction_Set::SCALAR, mopop::Instruction_Set::AVX2,
+          mopop::Instruction_Set::AVX512}) {
+      if (mopop::set_instruction_set(instruction_set) != instruction_set) {
+        continue;
+      }
+
+      std::cout << "Checking the "
+                << mopop::instruction_set_name(instruction_set) << " kernels"
+                << std::endl;
+
+      for (const mopop::Instance* instance : {&dense, &packed, &factor}) {
+        const mopop::Solution& expected =
+            instance == &factor ? factor_reference : reference;
+        mopop::Solution solution(*instance, key);
+
+        assert(solution.is_feasible());
+
+        for (unsigned i = 0; i < num_assets; i++) {
+          assert(fabs(solution.weight[i] - expected.weight[i]) <
+                 std::numeric_limits<double>::epsilon());
+        }
+
+        for (unsigned i = 0; i < 4; i++) {
+          assert(fabs(solution.value[i] - expected.value[i]) <
+                 1e-12 * fabs(expected.value[i]));
+        }
+
+        std::vector<double> weights(keys.size()), values(4 * num_keys);
+        mopop::evaluate_batch(*instance, keys.data(), num_keys, weights.data(),
+                              values.data());
+
+        for (unsigned p = 0; p < num_keys; p++) {
+          const std::vector<double> single_key(
+              keys.begin() + p * num_assets,
+              keys.begin() + (p + 1) * num_assets);
+          mopop::Solution single(*instance, single_key);
+
+          for (unsigned i = 0; i < num_assets; i++) {
+            assert(weights[p * num_assets + i] == single.weight[i]);
+          }
+
+          for (unsigned i = 0; i < 4; i++) {
+            assert(fabs(values[4 * p + i] - single.value[i]) <=
+                   1e-12 * fabs(single.value[i]));
+          }
+        }
+      }
+    }
+
+    mopop::set_instruction_set(supported);
+    assert(mopop::active_instruction_set() == supported);
+
+    // A chain of keys that each change one or two genes of the previous one,
+    // long enough to rebuild the cached product a few times, with a jump in
+    // the middle that forces an evaluation from scratch.
+    for (const mopop::Instance* instance : {&dense, &packed, &factor}) {
+      mopop::Incremental_Evaluator evaluator(*instance);
+      std::vector<double> chain_key(key), value(4);
+
+      for (unsigned step = 0; step < 400; step++) {
+        if (step == 200) {
+          std::reverse(chain_key.begin(), chain_key.end());
+        } else if (step > 0) {
+          chain_key[(step * 7) % num_assets] = 0.01 * ((step * 31) % 101);
+
+          if (step % 3 == 0) {
+            chain_key[(step * 11) % num_assets] = 0.0;
+          }
+        }
+
+        evaluator.evaluate(chain_key.data(), value.data());
+        mopop::Solution solution(*instance, chain_key);
+
+        for (unsigned i = 0; i < 4; i++) {
+          assert(fabs(value[i] - solution.value[i]) <=
+                 1e-10 * fabs(solution.value[i]) + 1e-14);
+        }
+      }
+
+      assert(evaluator.num_full_evaluations == 2);
+      assert(evaluator.num_incremental_evaluations == 398);
+
+      // An unchanged key gets its values back without touching the cached
+      // sums.
+      const unsigned num_updates = evaluator.num_updates;
+      std::vector<double> same_value(4);
+
+      evaluator.evaluate(chain_key.data(), same_value.data());
+
+      assert(same_value == value);
+      assert(evaluator.num_updates == num_updates);
+
+      // Right after a full evaluation, a small change is evaluated at the new
+      // key, with the accuracy of a full evaluation.
+      mopop::Incremental_Evaluator fresh(*instance);
+
+      fresh.evaluate(key.data(), value.data());
+      chain_key = key;
+      chain_key[1] = 0.5;
+      fresh.evaluate(chain_key.data(), value.data());
+
+      mopop::Solution solution(*instance, chain_key);
+
+      for (unsigned i = 0; i < 4; i++) {
+        assert(fabs(value[i] - solution.value[i]) <=
+               1e-12 * fabs(solution.value[i]) + 1e-15);
+      }
+
+      assert(fresh.num_updates == 0);
+    }
+  }
+
   std::cout << std::endl << "Solution Test PASSED" << std::endl;
 
   return 0;
@@ -6,6 +6,7 @@
 #include <tuple>
 #include <vector>
 
+#include "metrics/hypervolume.hpp"
 #include "solver/solver.hpp"
 
 namespace mopop {
@@ -20,8 +21,8 @@ inline double max_single_asset_variance(const Instance& instance) {
   double max_variance = 0.0;
 
   for (unsigned i = 0; i < instance.num_assets; i++) {
-    if (instance.covariance_matrix[i][i] > max_variance) {
-      max_variance = instance.covariance_matrix[i][i];
+    if (instance.covariance(i, i) > max_variance) {
+      max_variance = instance.covariance(i, i);
     }
   }
 
@@ -41,6 +42,10 @@ inline double max_single_asset_variance(const Instance& instance) {
  * used to decode to an empty portfolio, whose zero variance and zero entropy
  * made it permanently non-dominated in the archive.
  *
+ * When the solver tracks the hypervolume of its archive, every hypervolume
+ * snapshot must match the best solutions snapshot taken with it, and the final
+ * hypervolume the final archive, as computed from scratch.
+ *
  * @param solver The solver whose archive is to be verified.
  */
 inline void assert_solver_invariants(const Solver& solver) {
@@ -73,6 +78,33 @@ inline void assert_solver_invariants(const Solver& solver) {
       }
     }
   }
+
+  if (solver.hypervolume_tracker) {
+    const Hypervolume& engine = solver.hypervolume_tracker->engine;
+    std::vector<std::vector<double>> front;
+
+    assert(solver.hypervolume_snapshots.size() ==
+           solver.best_solutions_snapshots.size());
+
+    for (unsigned i = 0; i < solver.hypervolume_snapshots.size(); i++) {
+      double expected = engine.compute(
+          std::get<2>(solver.best_solutions_snapshots[i]));
+
+      assert(std::get<0>(solver.hypervolume_snapshots[i]) ==
+             std::get<0>(solver.best_solutions_snapshots[i]));
+      assert(std::fabs(std::get<2>(solver.hypervolume_snapshots[i]) -
+                       expected) <= 1e-9 * (1.0 + expected));
+    }
+
+    for (const Solution& solution : solver.best_solutions) {
+      front.push_back(solution.value);
+    }
+
+    double expected = engine.compute(front);
+
+    assert(std::fabs(solver.hypervolume - expected) <=
+           1e-9 * (1.0 + expected));
+  }
 }
 
 }  // namespace mopop
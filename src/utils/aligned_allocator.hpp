@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace mopop {
+/**
+ * @class Aligned_Allocator
+ * @brief Allocator whose blocks start on an Alignment-byte boundary, so that
+ * the containers using it can be read with aligned vector loads.
+ *
+ * @tparam T The type of the allocated elements.
+ * @tparam Alignment The alignment in bytes, a power of two.
+ */
+template <class T, std::size_t Alignment = 64>
+class Aligned_Allocator {
+ public:
+  typedef T value_type;
+
+  template <class U>
+  struct rebind {
+    typedef Aligned_Allocator<U, Alignment> other;
+  };
+
+  Aligned_Allocator() noexcept = default;
+
+  template <class U>
+  Aligned_Allocator(const Aligned_Allocator<U, Alignment>&) noexcept {}
+
+  /**
+   * @brief Allocates an aligned block for n elements.
+   *
+   * @param n The number of elements.
+   * @return A pointer to the allocated block.
+   */
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(
+        ::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+  }
+
+  /**
+   * @brief Releases a block obtained from allocate.
+   *
+   * @param p The pointer to the block.
+   * @param n The number of elements of the block.
+   */
+  void deallocate(T* p, std::size_t n) noexcept {
+    ::operator delete(p, n * sizeof(T), std::align_val_t(Alignment));
+  }
+
+  template <class U>
+  bool operator==(const Aligned_Allocator<U, Alignment>&) const noexcept {
+    return true;
+  }
+
+  template <class U>
+  bool operator!=(const Aligned_Allocator<U, Alignment>&) const noexcept {
+    return false;
+  }
+};
+
+}  // namespace mopop
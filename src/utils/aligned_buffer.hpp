@@ -0,0 +1,154 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "utils/aligned_allocator.hpp"
+
+namespace mopop {
+/**
+ * @class Aligned_Buffer
+ * @brief A contiguous aligned array that either owns its elements or views a
+ * read-only block kept alive by someone else, such as a memory-mapped file.
+ *
+ * Copying a view shares the block instead of copying it. The elements are only
+ * written through mutable_data, which first turns a view into an owned copy,
+ * so writing never reaches the block and never copies it unawares.
+ *
+ * @tparam T The type of the elements.
+ * @tparam Alignment The alignment in bytes of the owned elements, a power of
+ * two. A view is as aligned as the block it was given.
+ */
+template <class T, std::size_t Alignment = 64>
+class Aligned_Buffer {
+ public:
+  /**
+   * @brief The type of the owned storage.
+   */
+  typedef std::vector<T, Aligned_Allocator<T, Alignment>> Vector;
+
+ private:
+  /**
+   * @brief The owned elements, empty while viewing a block.
+   */
+  Vector elements;
+
+  /**
+   * @brief The first element of the viewed block.
+   */
+  const T* view_first = nullptr;
+
+  /**
+   * @brief The number of elements of the viewed block.
+   */
+  std::size_t view_count = 0;
+
+  /**
+   * @brief The owner of the viewed block, or null when the elements are owned.
+   */
+  std::shared_ptr<const void> view_owner;
+
+  /**
+   * @brief Copies the viewed block into owned storage, if it is a view.
+   */
+  void own() {
+    if (this->view_owner) {
+      this->elements.assign(this->view_first,
+                            this->view_first + this->view_count);
+      this->release();
+    }
+  }
+
+  /**
+   * @brief Drops the viewed block, if any.
+   */
+  void release() {
+    this->view_first = nullptr;
+    this->view_count = 0;
+    this->view_owner.reset();
+  }
+
+ public:
+  Aligned_Buffer() = default;
+
+  /**
+   * @brief Views a read-only block instead of the owned elements.
+   *
+   * @param first The first element of the block.
+   * @param count The number of elements of the block.
+   * @param owner The object that keeps the block alive.
+   */
+  void view(const T* first, std::size_t count,
+            std::shared_ptr<const void> owner) {
+    Vector().swap(this->elements);
+    this->view_first = first;
+    this->view_count = count;
+    this->view_owner = std::move(owner);
+  }
+
+  /**
+   * @brief Replaces the elements with count copies of value.
+   *
+   * @param count The number of elements.
+   * @param value The value of every element.
+   */
+  void assign(std::size_t count, const T& value) {
+    this->release();
+    this->elements.assign(count, value);
+  }
+
+  /**
+   * @brief Exchanges the elements with those of an owned vector. A viewed
+   * block is dropped and the vector is left empty.
+   *
+   * @param other The vector.
+   */
+  void swap(Vector& other) {
+    this->release();
+    this->elements.swap(other);
+  }
+
+  /**
+   * @brief Returns whether the elements are a view of a block.
+   */
+  bool is_view() const { return static_cast<bool>(this->view_owner); }
+
+  const T* data() const {
+    return this->view_owner ? this->view_first : this->elements.data();
+  }
+
+  /**
+   * @brief Returns the first element for writing, copying a viewed block into
+   * owned storage first.
+   *
+   * @return The first element of the owned storage.
+   */
+  T* mutable_data() {
+    this->own();
+    return this->elements.data();
+  }
+
+  std::size_t size() const {
+    return this->view_owner ? this->view_count : this->elements.size();
+  }
+
+  bool empty() const { return this->size() == 0; }
+
+  const T& operator[](std::size_t i) const { return this->data()[i]; }
+
+  const T* begin() const { return this->data(); }
+
+  const T* end() const { return this->data() + this->size(); }
+
+  friend bool operator==(const Aligned_Buffer& a, const Aligned_Buffer& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+  }
+
+  friend bool operator!=(const Aligned_Buffer& a, const Aligned_Buffer& b) {
+    return !(a == b);
+  }
+};
+
+}  // namespace mopop
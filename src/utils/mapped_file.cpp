@@ -0,0 +1,62 @@
+#include "utils/mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+namespace mopop {
+
+/**
+ * @brief Maps a file.
+ *
+ * The descriptor is closed right away, since the mapping outlives it.
+ *
+ * @param filename The path to the file.
+ *
+ * @throws std::runtime_error If the file cannot be opened or mapped.
+ */
+Mapped_File::Mapped_File(const std::string& filename)
+    : first(nullptr), size(0) {
+  const int descriptor = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+
+  if (descriptor < 0) {
+    throw std::runtime_error("Unable to open file " + filename);
+  }
+
+  struct stat status;
+
+  if (::fstat(descriptor, &status) != 0) {
+    ::close(descriptor);
+    throw std::runtime_error("Unable to read the size of file " + filename);
+  }
+
+  this->size = static_cast<std::size_t>(status.st_size);
+
+  if (this->size > 0) {
+    void* mapping =
+        ::mmap(nullptr, this->size, PROT_READ, MAP_SHARED, descriptor, 0);
+
+    if (mapping == MAP_FAILED) {
+      ::close(descriptor);
+      throw std::runtime_error("Unable to map file " + filename);
+    }
+
+    this->first = static_cast<const unsigned char*>(mapping);
+  }
+
+  ::close(descriptor);
+}
+
+/**
+ * @brief Unmaps the file.
+ */
+Mapped_File::~Mapped_File() {
+  if (this->first != nullptr) {
+    ::munmap(const_cast<unsigned char*>(this->first), this->size);
+  }
+}
+
+}  // namespace mopop
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace mopop {
+/**
+ * @class Mapped_File
+ * @brief A file memory-mapped read-only and shared, so that every process
+ * mapping the same file reads the same pages of the page cache.
+ */
+class Mapped_File {
+ public:
+  /**
+   * @brief The first byte of the mapping, which starts on a page boundary, or
+   * null for an empty file.
+   */
+  const unsigned char* first;
+
+  /**
+   * @brief The size of the file in bytes.
+   */
+  std::size_t size;
+
+  /**
+   * @brief Maps a file.
+   *
+   * @param filename The path to the file.
+   *
+   * @throws std::runtime_error If the file cannot be opened or mapped.
+   */
+  explicit Mapped_File(const std::string& filename);
+
+  Mapped_File(const Mapped_File&) = delete;
+
+  Mapped_File& operator=(const Mapped_File&) = delete;
+
+  /**
+   * @brief Unmaps the file.
+   */
+  ~Mapped_File();
+};
+
+}  // namespace mopop
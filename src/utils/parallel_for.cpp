@@ -0,0 +1,60 @@
+#include "utils/parallel_for.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mopop {
+
+/**
+ * @brief Runs units of work on a pool of threads, each thread taking the next
+ * unit as soon as it is done with the previous one.
+ *
+ * @param num_units The number of units.
+ * @param num_threads The number of threads, including the calling one.
+ * @param work The work, given the index of a unit.
+ *
+ * @throws The first exception thrown by a unit, after every thread stops.
+ */
+void parallel_for(unsigned num_units, unsigned num_threads,
+                  const std::function<void(unsigned)>& work) {
+  std::atomic<unsigned> next_unit(0);
+  std::exception_ptr exception;
+  std::mutex exception_mutex;
+  std::vector<std::thread> threads;
+
+  const auto worker = [&]() {
+    for (unsigned unit = next_unit++; unit < num_units; unit = next_unit++) {
+      try {
+        work(unit);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(exception_mutex);
+
+        if (!exception) {
+          exception = std::current_exception();
+        }
+
+        next_unit = num_units;
+      }
+    }
+  };
+
+  for (unsigned t = 1; t < std::min(num_threads, num_units); t++) {
+    threads.emplace_back(worker);
+  }
+
+  worker();
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
+}  // namespace mopop
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <functional>
+
+namespace mopop {
+/**
+ * @brief Runs units of work on a pool of threads, each thread taking the next
+ * unit as soon as it is done with the previous one.
+ *
+ * @param num_units The number of units.
+ * @param num_threads The number of threads, including the calling one.
+ * @param work The work, given the index of a unit.
+ *
+ * @throws The first exception thrown by a unit, after every thread stops.
+ */
+void parallel_for(unsigned num_units, unsigned num_threads,
+                  const std::function<void(unsigned)>& work);
+
+}  // namespace mopop
@@ -0,0 +1,571 @@
+#include "utils/snapshot_file.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "utils/text_reader.hpp"
+
+namespace mopop {
+
+namespace {
+
+/**
+ * @brief The first bytes of every binary snapshot file.
+ */
+constexpr char snapshot_file_magic[8] = {'M', 'O', 'P', 'O',
+                                         'P', 'S', 'N', 'P'};
+
+/**
+ * @brief The last bytes of a binary snapshot file with an index.
+ */
+constexpr char snapshot_index_magic[8] = {'M', 'O', 'P', 'O',
+                                          'P', 'I', 'D', 'X'};
+
+/**
+ * @brief The version of the binary snapshot file format, bumped whenever its
+ * layout changes.
+ */
+constexpr std::uint32_t snapshot_file_version = 1;
+
+/**
+ * @brief A value whose bytes, as stored, tell the byte order of the writer.
+ */
+constexpr std::uint32_t snapshot_file_byte_order = 0x01020304;
+
+/**
+ * @brief The header of a binary snapshot file.
+ */
+struct Snapshot_File_Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint32_t num_objectives;
+  std::uint32_t reserved_32;
+  std::uint64_t reserved[5];
+};
+
+static_assert(sizeof(Snapshot_File_Header) == 64,
+              "The binary snapshot file header must not change size");
+
+/**
+ * @brief The header of the block of a snapshot, followed by num_objectives
+ * columns of count values each.
+ */
+struct Snapshot_Block_Header {
+  std::uint64_t iteration;
+  double time;
+  std::uint64_t count;
+};
+
+static_assert(sizeof(Snapshot_Block_Header) == 24,
+              "The binary snapshot block header must not change size");
+
+/**
+ * @brief The end of a binary snapshot file with an index, which follows the
+ * offset of every block.
+ */
+struct Snapshot_Index_Trailer {
+  std::uint64_t num_blocks;
+  std::uint64_t index_offset;
+  char magic[8];
+};
+
+static_assert(sizeof(Snapshot_Index_Trailer) == 24,
+              "The binary snapshot index trailer must not change size");
+
+}  // namespace
+
+/**
+ * @brief Creates a file and writes its header.
+ *
+ * @param filename The name of the file.
+ * @param num_objectives The number of objectives.
+ *
+ * @throws std::runtime_error If the file cannot be created or written.
+ */
+void Snapshot_File_Writer::open(const std::string& filename,
+                                unsigned num_objectives) {
+  Snapshot_File_Header header = {};
+
+  std::memcpy(header.magic, snapshot_file_magic, sizeof(header.magic));
+  header.version = snapshot_file_version;
+  header.byte_order = snapshot_file_byte_order;
+  header.num_objectives = num_objectives;
+
+  this->filename = filename;
+  this->num_objectives = num_objectives;
+  this->offsets.clear();
+  this->ofs.open(filename, std::ios::binary | std::ios::trunc);
+
+  if (!this->ofs.is_open()) {
+    throw std::runtime_error("File " + filename + " not created.");
+  }
+
+  this->ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  this->ofs.flush();
+  this->size = sizeof(header);
+
+  if (this->ofs.fail()) {
+    throw std::runtime_error("Error writing file " + filename + ".");
+  }
+}
+
+/**
+ * @brief Writes the block of a snapshot, whose columns are filled.
+ *
+ * @param iteration The iteration of the snapshot.
+ * @param time The time of the snapshot in seconds.
+ * @param count The number of points of the snapshot.
+ *
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void Snapshot_File_Writer::write_block(unsigned iteration, double time,
+                                       std::size_t count) {
+  const Snapshot_Block_Header header = {iteration, time, count};
+
+  this->ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  this->ofs.write(reinterpret_cast<const char*>(this->columns.data()),
+                  this->columns.size() * sizeof(double));
+  this->ofs.flush();
+
+  if (this->ofs.fail()) {
+    throw std::runtime_error("Error writing file " + this->filename + ".");
+  }
+
+  this->offsets.push_back(this->size);
+  this->size += sizeof(header) + this->columns.size() * sizeof(double);
+}
+
+/**
+ * @brief Appends a snapshot.
+ *
+ * @param iteration The iteration of the snapshot.
+ * @param time The time of the snapshot in seconds.
+ * @param points The objective values of the points.
+ *
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void Snapshot_File_Writer::append(
+    unsigned iteration, double time,
+    const std::vector<std::vector<double>>& points) {
+  const std::size_t count = points.size();
+
+  this->columns.resize(count * this->num_objectives);
+
+  for (std::size_t i = 0; i < count; i++) {
+    for (unsigned k = 0; k < this->num_objectives; k++) {
+      this->columns[k * count + i] = points[i][k];
+    }
+  }
+
+  this->write_block(iteration, time, count);
+}
+
+/**
+ * @brief Appends a snapshot of several populations, as one block with the
+ * points of every population, one population after the other.
+ *
+ * @param iteration The iteration of the snapshot.
+ * @param time The time of the snapshot in seconds.
+ * @param populations The objective values of the points of each population.
+ *
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void Snapshot_File_Writer::append(
+    unsigned iteration, double time,
+    const std::vector<std::vector<std::vector<double>>>& populations) {
+  std::size_t count = 0, i = 0;
+
+  for (const std::vector<std::vector<double>>& population : populations) {
+    count += population.size();
+  }
+
+  this->columns.resize(count * this->num_objectives);
+
+  for (const std::vector<std::vector<double>>& population : populations) {
+    for (const std::vector<double>& value : population) {
+      for (unsigned k = 0; k < this->num_objectives; k++) {
+        this->columns[k * count + i] = value[k];
+      }
+
+      i++;
+    }
+  }
+
+  this->write_block(iteration, time, count);
+}
+
+/**
+ * @brief Writes the index and closes the file.
+ *
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void Snapshot_File_Writer::close() {
+  if (!this->ofs.is_open()) {
+    return;
+  }
+
+  Snapshot_Index_Trailer trailer = {};
+
+  trailer.num_blocks = this->offsets.size();
+  trailer.index_offset = this->size;
+  std::memcpy(trailer.magic, snapshot_index_magic, sizeof(trailer.magic));
+
+  this->ofs.write(reinterpret_cast<const char*>(this->offsets.data()),
+                  this->offsets.size() * sizeof(std::uint64_t));
+  this->ofs.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+  this->ofs.close();
+
+  if (this->ofs.fail()) {
+    throw std::runtime_error("Error writing file " + this->filename + ".");
+  }
+}
+
+/**
+ * @brief Maps a file and reads its index.
+ *
+ * Without an index at its end, the blocks are found one after the other
+ * from the header, up to the last whole one.
+ *
+ * @param filename The name of the file.
+ *
+ * @throws std::runtime_error If the file cannot be mapped, or is not a
+ * binary snapshot file of the current version.
+ */
+Snapshot_File_Reader::Snapshot_File_Reader(const std::string& filename)
+    : file(new Mapped_File(filename)) {
+  const std::uint64_t size = this->file->size;
+  Snapshot_File_Header header;
+
+  if (size < sizeof(header)) {
+    throw std::runtime_error("File " + filename +
+                             " is not a binary snapshot file.");
+  }
+
+  std::memcpy(&header, this->file->first, sizeof(header));
+
+  if (std::memcmp(header.magic, snapshot_file_magic, sizeof(header.magic)) !=
+      0) {
+    throw std::runtime_error("File " + filename +
+                             " is not a binary snapshot file.");
+  }
+
+  if (header.byte_order != snapshot_file_byte_order) {
+    throw std::runtime_error("File " + filename + " has another byte order.");
+  }
+
+  if (header.version != snapshot_file_version || header.num_objectives == 0) {
+    throw std::runtime_error("File " + filename +
+                             " has an unsupported version.");
+  }
+
+  this->num_objectives = header.num_objectives;
+
+  // The size of a block, or zero if it does not fit in the first bytes of the
+  // file.
+  const auto block_size = [&](std::uint64_t offset, std::uint64_t last) {
+    Snapshot_Block_Header block_header;
+
+    if (offset + sizeof(block_header) > last) {
+      return std::uint64_t(0);
+    }
+
+    std::memcpy(&block_header, this->file->first + offset,
+                sizeof(block_header));
+
+    if (block_header.count > (last - offset - sizeof(block_header)) /
+                                 (this->num_objectives * sizeof(double))) {
+      return std::uint64_t(0);
+    }
+
+    return sizeof(block_header) +
+           block_header.count * this->num_objectives * sizeof(double);
+  };
+
+  Snapshot_Index_Trailer trailer;
+
+  if (size >= sizeof(header) + sizeof(trailer)) {
+    std::memcpy(&trailer, this->file->first + size - sizeof(trailer),
+                sizeof(trailer));
+  }
+
+  if (size >= sizeof(header) + sizeof(trailer) &&
+      std::memcmp(trailer.magic, snapshot_index_magic,
+                  sizeof(trailer.magic)) == 0) {
+    if (trailer.index_offset < sizeof(header) ||
+        trailer.index_offset > size - sizeof(trailer) ||
+        trailer.num_blocks > size ||
+        trailer.num_blocks * sizeof(std::uint64_t) !=
+            size - sizeof(trailer) - trailer.index_offset) {
+      throw std::runtime_error("File " + filename + " has an invalid index.");
+    }
+
+    this->offsets.resize(trailer.num_blocks);
+    std::memcpy(this->offsets.data(),
+                this->file->first + trailer.index_offset,
+                trailer.num_blocks * sizeof(std::uint64_t));
+
+    for (const std::uint64_t offset : this->offsets) {
+      if (offset < sizeof(header) || offset % sizeof(double) != 0 ||
+          block_size(offset, trailer.index_offset) == 0) {
+        throw std::runtime_error("File " + filename + " has an invalid index.");
+      }
+    }
+  } else {
+    for (std::uint64_t offset = sizeof(header), length;
+         (length = block_size(offset, size)) > 0; offset += length) {
+      this->offsets.push_back(offset);
+    }
+  }
+}
+
+/**
+ * @brief Returns whether a file is a binary snapshot file, so that a reader
+ * accepts either it or the text files.
+ *
+ * @param filename The name of the file.
+ * @return true if the file exists and starts as a binary snapshot file;
+ * false otherwise.
+ */
+bool Snapshot_File_Reader::is_snapshot_file(const std::string& filename) {
+  std::ifstream ifs(filename, std::ios::binary);
+  char magic[sizeof(snapshot_file_magic)];
+
+  ifs.read(magic, sizeof(magic));
+
+  return ifs.gcount() == sizeof(magic) &&
+         std::memcmp(magic, snapshot_file_magic, sizeof(magic)) == 0;
+}
+
+/**
+ * @brief Returns the iteration of a snapshot.
+ *
+ * @param j The index of the snapshot.
+ * @return The iteration.
+ */
+unsigned Snapshot_File_Reader::iteration(std::size_t j) const {
+  std::uint64_t iteration;
+
+  std::memcpy(&iteration,
+              this->block(j) + offsetof(Snapshot_Block_Header, iteration),
+              sizeof(iteration));
+
+  return unsigned(iteration);
+}
+
+/**
+ * @brief Returns the time of a snapshot.
+ *
+ * @param j The index of the snapshot.
+ * @return The time in seconds.
+ */
+double Snapshot_File_Reader::time(std::size_t j) const {
+  double time;
+
+  std::memcpy(&time, this->block(j) + offsetof(Snapshot_Block_Header, time),
+              sizeof(time));
+
+  return time;
+}
+
+/**
+ * @brief Returns the number of points of a snapshot.
+ *
+ * @param j The index of the snapshot.
+ * @return The number of points.
+ */
+std::size_t Snapshot_File_Reader::count(std::size_t j) const {
+  std::uint64_t count;
+
+  std::memcpy(&count, this->block(j) + offsetof(Snapshot_Block_Header, count),
+              sizeof(count));
+
+  return std::size_t(count);
+}
+
+/**
+ * @brief Returns the values of an objective over the points of a snapshot.
+ *
+ * The blocks start on 8-byte boundaries of a mapping that starts on a page
+ * boundary, so the values are aligned.
+ *
+ * @param j The index of the snapshot.
+ * @param k The index of the objective.
+ * @return The first of count(j) values.
+ */
+const double* Snapshot_File_Reader::column(std::size_t j, unsigned k) const {
+  return reinterpret_cast<const double*>(this->block(j) +
+                                         sizeof(Snapshot_Block_Header)) +
+         k * this->count(j);
+}
+
+/**
+ * @brief Returns the points of a snapshot, one vector of objective values
+ * per point.
+ *
+ * @param j The index of the snapshot.
+ * @return The points.
+ */
+std::vector<std::vector<double>> Snapshot_File_Reader::points(
+    std::size_t j) const {
+  const std::size_t count = this->count(j);
+  std::vector<std::vector<double>> points(
+      count, std::vector<double>(this->num_objectives));
+
+  for (unsigned k = 0; k < this->num_objectives; k++) {
+    const double* column = this->column(j, k);
+
+    for (std::size_t i = 0; i < count; i++) {
+      points[i][k] = column[i];
+    }
+  }
+
+  return points;
+}
+
+/**
+ * @brief Reads the points of the remaining lines of an open text file.
+ *
+ * @param reader The reader of the file.
+ * @param filename The name of the file.
+ * @param num_objectives The number of objectives of the instance.
+ * @return The objective values of the points.
+ *
+ * @throws std::runtime_error If a line does not have num_objectives numbers.
+ */
+static std::vector<std::vector<double>> read_points(Text_Reader& reader,
+                                                    const std::string& filename,
+                                                    unsigned num_objectives) {
+  std::vector<std::vector<double>> points;
+  double extra;
+
+  while (reader.next_line()) {
+    std::vector<double> value(num_objectives, 0.0);
+
+    for (unsigned j = 0; j < num_objectives; j++) {
+      if (!reader.next_number(value[j])) {
+        throw std::runtime_error("File " + filename + " does not have " +
+                                 std::to_string(num_objectives) +
+                                 " objectives.");
+      }
+    }
+
+    if (reader.next_number(extra)) {
+      throw std::runtime_error("File " + filename + " does not have " +
+                               std::to_string(num_objectives) +
+                               " objectives.");
+    }
+
+    points.push_back(std::move(value));
+  }
+
+  return points;
+}
+
+/**
+ * @brief Maps a binary snapshot file of the objectives of an instance.
+ *
+ * @param filename The name of the file.
+ * @param num_objectives The number of objectives of the instance.
+ * @return The reader of the file.
+ *
+ * @throws std::runtime_error If the file cannot be mapped, or does not have
+ * num_objectives objectives.
+ */
+static Snapshot_File_Reader open_snapshot_file(const std::string& filename,
+                                               unsigned num_objectives) {
+  Snapshot_File_Reader snapshot_file(filename);
+
+  if (snapshot_file.num_objectives != num_objectives) {
+    throw std::runtime_error("File " + filename + " does not have " +
+                             std::to_string(num_objectives) + " objectives.");
+  }
+
+  return snapshot_file;
+}
+
+/**
+ * @brief Reads a front, either the last snapshot of a binary snapshot file or
+ * a text file with the objective values of a point per line.
+ *
+ * @param filename The name of the file.
+ * @param num_objectives The number of objectives of the instance.
+ * @return The objective values of the points.
+ *
+ * @throws std::runtime_error If the file cannot be read, or its points do not
+ * have num_objectives objective values.
+ */
+std::vector<std::vector<double>> read_front(const std::string& filename,
+                                            unsigned num_objectives) {
+  if (Snapshot_File_Reader::is_snapshot_file(filename)) {
+    const Snapshot_File_Reader snapshot_file =
+        open_snapshot_file(filename, num_objectives);
+
+    return snapshot_file.num_snapshots() > 0
+               ? snapshot_file.points(snapshot_file.num_snapshots() - 1)
+               : std::vector<std::vector<double>>();
+  }
+
+  Text_Reader reader;
+
+  if (!reader.open(filename)) {
+    throw std::runtime_error("File " + filename + " not found.");
+  }
+
+  return read_points(reader, filename, num_objectives);
+}
+
+/**
+ * @brief Reads the snapshots of the best solutions of a run, either from a
+ * binary snapshot file or from the text files whose names are the name given
+ * followed by the index of the snapshot and ".txt", each of which starts with
+ * the iteration and the time of its snapshot.
+ *
+ * @param filename The name of the binary snapshot file, or the start of the
+ * names of the text files.
+ * @param num_objectives The number of objectives of the instance.
+ * @return The snapshots.
+ *
+ * @throws std::runtime_error If a file cannot be read, or its points do not
+ * have num_objectives objective values.
+ */
+Front_Snapshots read_front_snapshots(const std::string& filename,
+                                     unsigned num_objectives) {
+  Front_Snapshots snapshots;
+
+  if (Snapshot_File_Reader::is_snapshot_file(filename)) {
+    const Snapshot_File_Reader snapshot_file =
+        open_snapshot_file(filename, num_objectives);
+
+    for (std::size_t j = 0; j < snapshot_file.num_snapshots(); j++) {
+      snapshots.iterations.push_back(snapshot_file.iteration(j));
+      snapshots.times.push_back(snapshot_file.time(j));
+      snapshots.fronts.push_back(snapshot_file.points(j));
+    }
+
+    return snapshots;
+  }
+
+  Text_Reader reader;
+
+  for (unsigned j = 0; reader.open(filename + std::to_string(j) + ".txt");
+       j++) {
+    unsigned iteration = 0;
+    double time = 0.0;
+
+    reader.next_line();
+    reader.next_number(iteration);
+    reader.next_number(time);
+
+    snapshots.iterations.push_back(iteration);
+    snapshots.times.push_back(time);
+    snapshots.fronts.push_back(read_points(
+        reader, filename + std::to_string(j) + ".txt", num_objectives));
+  }
+
+  return snapshots;
+}
+
+}  // namespace mopop
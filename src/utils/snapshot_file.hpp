@@ -0,0 +1,286 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "utils/mapped_file.hpp"
+
+namespace mopop {
+/**
+ * @class Snapshot_File_Writer
+ * @brief Appends the fronts of a run to a binary snapshot file, one block per
+ * snapshot, instead of writing a text file per snapshot.
+ *
+ * The file starts with a fixed-size header with the format version and the
+ * number of objectives. Each block holds the iteration, the time and the
+ * number of points of its snapshot, followed by the objective values as
+ * columns of float64, one column per objective. Once the writer is closed, an
+ * index with the offset of every block ends the file, so that any snapshot is
+ * read without reading the ones before it. The numbers are written in the
+ * byte order of the running machine.
+ *
+ * Every block is flushed as it is appended, so a run that stops before the
+ * writer is closed leaves a file without an index, whose blocks are still
+ * read one after the other.
+ */
+class Snapshot_File_Writer {
+ private:
+  /**
+   * @brief The name of the file.
+   */
+  std::string filename;
+
+  /**
+   * @brief The file.
+   */
+  std::ofstream ofs;
+
+  /**
+   * @brief The number of objectives.
+   */
+  unsigned num_objectives = 0;
+
+  /**
+   * @brief The size of the file written so far, in bytes.
+   */
+  std::uint64_t size = 0;
+
+  /**
+   * @brief The offset of each block in bytes from the start of the file.
+   */
+  std::vector<std::uint64_t> offsets;
+
+  /**
+   * @brief The columns of the block being appended, kept between blocks to
+   * reuse their capacity.
+   */
+  std::vector<double> columns;
+
+  /**
+   * @brief Writes the block of a snapshot, whose columns are filled.
+   *
+   * @param iteration The iteration of the snapshot.
+   * @param time The time of the snapshot in seconds.
+   * @param count The number of points of the snapshot.
+   *
+   * @throws std::runtime_error If the file cannot be written.
+   */
+  void write_block(unsigned iteration, double time, std::size_t count);
+
+ public:
+  Snapshot_File_Writer() = default;
+
+  Snapshot_File_Writer(const Snapshot_File_Writer&) = delete;
+
+  Snapshot_File_Writer& operator=(const Snapshot_File_Writer&) = delete;
+
+  /**
+   * @brief Creates a file and writes its header.
+   *
+   * @param filename The name of the file.
+   * @param num_objectives The number of objectives.
+   *
+   * @throws std::runtime_error If the file cannot be created or written.
+   */
+  void open(const std::string& filename, unsigned num_objectives);
+
+  /**
+   * @brief Returns whether a file is open.
+   */
+  bool is_open() const { return this->ofs.is_open(); }
+
+  /**
+   * @brief Appends a snapshot.
+   *
+   * @param iteration The iteration of the snapshot.
+   * @param time The time of the snapshot in seconds.
+   * @param points The objective values of the points.
+   *
+   * @throws std::runtime_error If the file cannot be written.
+   */
+  void append(unsigned iteration, double time,
+              const std::vector<std::vector<double>>& points);
+
+  /**
+   * @brief Appends a snapshot of several populations, as one block with the
+   * points of every population, one population after the other.
+   *
+   * @param iteration The iteration of the snapshot.
+   * @param time The time of the snapshot in seconds.
+   * @param populations The objective values of the points of each population.
+   *
+   * @throws std::runtime_error If the file cannot be written.
+   */
+  void append(unsigned iteration, double time,
+              const std::vector<std::vector<std::vector<double>>>& populations);
+
+  /**
+   * @brief Writes the index and closes the file.
+   *
+   * @throws std::runtime_error If the file cannot be written.
+   */
+  void close();
+};
+
+/**
+ * @class Snapshot_File_Reader
+ * @brief Reads the snapshots of a binary snapshot file, written by
+ * Snapshot_File_Writer, in place.
+ *
+ * The file is memory-mapped, and the columns are views of the mapping, valid
+ * while the reader lives. A file without an index, left by a run that
+ * stopped, is read up to its last whole block.
+ */
+class Snapshot_File_Reader {
+ public:
+  /**
+   * @brief The number of objectives.
+   */
+  unsigned num_objectives = 0;
+
+ private:
+  /**
+   * @brief The mapped file.
+   */
+  std::unique_ptr<const Mapped_File> file;
+
+  /**
+   * @brief The offset of each block in bytes from the start of the file.
+   */
+  std::vector<std::uint64_t> offsets;
+
+  /**
+   * @brief Returns the first byte of the block of a snapshot.
+   */
+  const unsigned char* block(std::size_t j) const {
+    return this->file->first + this->offsets[j];
+  }
+
+ public:
+  /**
+   * @brief Maps a file and reads its index.
+   *
+   * @param filename The name of the file.
+   *
+   * @throws std::runtime_error If the file cannot be mapped, or is not a
+   * binary snapshot file of the current version.
+   */
+  explicit Snapshot_File_Reader(const std::string& filename);
+
+  /**
+   * @brief Returns whether a file is a binary snapshot file, so that a reader
+   * accepts either it or the text files.
+   *
+   * @param filename The name of the file.
+   * @return true if the file exists and starts as a binary snapshot file;
+   * false otherwise.
+   */
+  static bool is_snapshot_file(const std::string& filename);
+
+  /**
+   * @brief Returns the number of snapshots.
+   */
+  std::size_t num_snapshots() const { return this->offsets.size(); }
+
+  /**
+   * @brief Returns the iteration of a snapshot.
+   *
+   * @param j The index of the snapshot.
+   * @return The iteration.
+   */
+  unsigned iteration(std::size_t j) const;
+
+  /**
+   * @brief Returns the time of a snapshot.
+   *
+   * @param j The index of the snapshot.
+   * @return The time in seconds.
+   */
+  double time(std::size_t j) const;
+
+  /**
+   * @brief Returns the number of points of a snapshot.
+   *
+   * @param j The index of the snapshot.
+   * @return The number of points.
+   */
+  std::size_t count(std::size_t j) const;
+
+  /**
+   * @brief Returns the values of an objective over the points of a snapshot.
+   *
+   * @param j The index of the snapshot.
+   * @param k The index of the objective.
+   * @return The first of count(j) values.
+   */
+  const double* column(std::size_t j, unsigned k) const;
+
+  /**
+   * @brief Returns the points of a snapshot, one vector of objective values
+   * per point.
+   *
+   * @param j The index of the snapshot.
+   * @return The points.
+   */
+  std::vector<std::vector<double>> points(std::size_t j) const;
+};
+
+/**
+ * @class Front_Snapshots
+ * @brief The snapshots of the best solutions of a run, read from either a
+ * binary snapshot file or the text files of the snapshots.
+ */
+class Front_Snapshots {
+ public:
+  /**
+   * @brief The iteration of each snapshot.
+   */
+  std::vector<unsigned> iterations;
+
+  /**
+   * @brief The time of each snapshot in seconds.
+   */
+  std::vector<double> times;
+
+  /**
+   * @brief The objective values of the points of each snapshot.
+   */
+  std::vector<std::vector<std::vector<double>>> fronts;
+};
+
+/**
+ * @brief Reads a front, either the last snapshot of a binary snapshot file or
+ * a text file with the objective values of a point per line.
+ *
+ * @param filename The name of the file.
+ * @param num_objectives The number of objectives of the instance.
+ * @return The objective values of the points.
+ *
+ * @throws std::runtime_error If the file cannot be read, or its points do not
+ * have num_objectives objective values.
+ */
+std::vector<std::vector<double>> read_front(const std::string& filename,
+                                            unsigned num_objectives);
+
+/**
+ * @brief Reads the snapshots of the best solutions of a run, either from a
+ * binary snapshot file or from the text files whose names are the name given
+ * followed by the index of the snapshot and ".txt", each of which starts with
+ * the iteration and the time of its snapshot.
+ *
+ * @param filename The name of the binary snapshot file, or the start of the
+ * names of the text files.
+ * @param num_objectives The number of objectives of the instance.
+ * @return The snapshots.
+ *
+ * @throws std::runtime_error If a file cannot be read, or its points do not
+ * have num_objectives objective values.
+ */
+Front_Snapshots read_front_snapshots(const std::string& filename,
+                                     unsigned num_objectives);
+
+}  // namespace mopop
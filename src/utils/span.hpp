@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+
+namespace mopop {
+/**
+ * @class Span
+ * @brief A non-owning view of a contiguous sequence of elements.
+ *
+ * @tparam T The type of the elements, const-qualified for read-only views.
+ */
+template <class T>
+class Span {
+ public:
+  /**
+   * @brief The first element of the view.
+   */
+  T* first = nullptr;
+
+  /**
+   * @brief The number of elements in the view.
+   */
+  std::size_t count = 0;
+
+  Span() = default;
+
+  Span(T* first, std::size_t count) : first(first), count(count) {}
+
+  T& operator[](std::size_t i) const { return this->first[i]; }
+
+  T* data() const { return this->first; }
+
+  T* begin() const { return this->first; }
+
+  T* end() const { return this->first + this->count; }
+
+  std::size_t size() const { return this->count; }
+
+  bool empty() const { return this->count == 0; }
+};
+
+}  // namespace mopop
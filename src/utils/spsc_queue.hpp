@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace mopop {
+/**
+ * @class SPSC_Queue
+ * @brief A bounded lock-free queue between one producer thread and one
+ * consumer thread.
+ *
+ * The two ends only share a head and a tail index, each written by one end
+ * alone, so neither end ever waits for the other: pushing to a full queue and
+ * popping from an empty one simply fail.
+ *
+ * @tparam T The type of the elements, cheap to copy.
+ */
+template <class T>
+class SPSC_Queue {
+ private:
+  /**
+   * @brief The elements, a power of two of them.
+   */
+  std::vector<T> elements;
+
+  /**
+   * @brief The mask of an index into the elements.
+   */
+  std::size_t mask;
+
+  /**
+   * @brief The number of elements ever popped, written by the consumer.
+   */
+  alignas(64) std::atomic<std::size_t> head;
+
+  /**
+   * @brief The number of elements ever pushed, written by the producer.
+   */
+  alignas(64) std::atomic<std::size_t> tail;
+
+ public:
+  /**
+   * @brief Constructs a new empty queue.
+   *
+   * @param capacity The minimum number of elements the queue holds.
+   */
+  SPSC_Queue(std::size_t capacity) : head(0), tail(0) {
+    std::size_t size = 1;
+
+    while (size < capacity) {
+      size <<= 1;
+    }
+
+    this->elements.resize(size);
+    this->mask = size - 1;
+  }
+
+  SPSC_Queue(const SPSC_Queue&) = delete;
+
+  SPSC_Queue& operator=(const SPSC_Queue&) = delete;
+
+  /**
+   * @brief Returns the number of elements the queue holds.
+   *
+   * @return The capacity.
+   */
+  std::size_t capacity() const { return this->elements.size(); }
+
+  /**
+   * @brief Appends an element, from the producer thread.
+   *
+   * @param element The element.
+   * @return true if the element was appended; false if the queue is full.
+   */
+  bool push(const T& element) {
+    const std::size_t tail = this->tail.load(std::memory_order_relaxed);
+
+    if (tail - this->head.load(std::memory_order_acquire) ==
+        this->elements.size()) {
+      return false;
+    }
+
+    this->elements[tail & this->mask] = element;
+    this->tail.store(tail + 1, std::memory_order_release);
+
+    return true;
+  }
+
+  /**
+   * @brief Removes the first element, from the consumer thread.
+   *
+   * @param element The element removed.
+   * @return true if an element was removed; false if the queue is empty.
+   */
+  bool pop(T& element) {
+    const std::size_t head = this->head.load(std::memory_order_relaxed);
+
+    if (head == this->tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    element = this->elements[head & this->mask];
+    this->head.store(head + 1, std::memory_order_release);
+
+    return true;
+  }
+};
+
+}  // namespace mopop
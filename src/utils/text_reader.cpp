@@ -0,0 +1,113 @@
+#include "utils/text_reader.hpp"
+
+#include <cstring>
+
+namespace mopop {
+
+/**
+ * @brief Opens a file.
+ *
+ * @param filename The path to the file.
+ *
+ * @throws std::runtime_error If the file cannot be opened.
+ */
+Text_Reader::Text_Reader(const std::string& filename) {
+  if (!this->open(filename)) {
+    throw std::runtime_error("Unable to open file " + filename);
+  }
+}
+
+/**
+ * @brief Opens a file, closing the current one.
+ *
+ * @param filename The path to the file.
+ * @return Whether the file could be opened.
+ */
+bool Text_Reader::open(const std::string& filename) {
+  this->close();
+
+  try {
+    this->file.reset(new Mapped_File(filename));
+  } catch (const std::runtime_error&) {
+    return false;
+  }
+
+  const char* first = reinterpret_cast<const char*>(this->file->first);
+
+  this->next_line_first = first;
+  this->file_last = first + this->file->size;
+  this->position = first;
+  this->line_last = first;
+
+  return true;
+}
+
+/**
+ * @brief Closes the file.
+ */
+void Text_Reader::close() {
+  this->file.reset();
+  this->next_line_first = nullptr;
+  this->file_last = nullptr;
+  this->position = nullptr;
+  this->line_last = nullptr;
+}
+
+/**
+ * @brief Moves to the next line.
+ *
+ * @return Whether there was a next line.
+ */
+bool Text_Reader::next_line() {
+  if (this->next_line_first == this->file_last) {
+    this->position = this->line_last = this->file_last;
+    return false;
+  }
+
+  const char* line_end = static_cast<const char*>(std::memchr(
+      this->next_line_first, '\n', this->file_last - this->next_line_first));
+
+  if (line_end == nullptr) {
+    line_end = this->file_last;
+  }
+
+  this->position = this->next_line_first;
+  this->line_last = line_end;
+  this->next_line_first =
+      line_end == this->file_last ? this->file_last : line_end + 1;
+
+  if (this->line_last > this->position && this->line_last[-1] == '\r') {
+    this->line_last--;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Reads the next field of the current line. As with std::getline, a
+ * delimiter at the end of the line does not start an empty field.
+ *
+ * @param field The field, written by the function.
+ * @param delimiter The character between two fields.
+ * @return Whether the line had a field left.
+ */
+bool Text_Reader::next_field(std::string_view& field, char delimiter) {
+  if (this->position == this->line_last) {
+    return false;
+  }
+
+  const char* field_last = static_cast<const char*>(
+      std::memchr(this->position, delimiter, this->line_last - this->position));
+
+  if (field_last == nullptr) {
+    field_last = this->line_last;
+  }
+
+  field = std::string_view(this->position, field_last - this->position);
+  this->position =
+      field_last == this->line_last ? this->line_last : field_last + 1;
+
+  return true;
+}
+
+}  // namespace mopop
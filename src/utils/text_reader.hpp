@@ -0,0 +1,162 @@
+#pragma once
+
+#include <charconv>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "utils/mapped_file.hpp"
+
+namespace mopop {
+/**
+ * @class Text_Reader
+ * @brief Reads a text file line by line and field by field, without
+ * allocating.
+ *
+ * The whole file is memory-mapped, and the lines and fields are views of the
+ * mapping, valid while the reader stays open. Both "\n" and "\r\n" end a line.
+ */
+class Text_Reader {
+ private:
+  /**
+   * @brief The mapped file, or null when the reader is not open.
+   */
+  std::unique_ptr<const Mapped_File> file;
+
+  /**
+   * @brief The first character after the current line.
+   */
+  const char* next_line_first = nullptr;
+
+  /**
+   * @brief The first character after the file.
+   */
+  const char* file_last = nullptr;
+
+  /**
+   * @brief The first unread character of the current line.
+   */
+  const char* position = nullptr;
+
+  /**
+   * @brief The first character after the current line, without the line end.
+   */
+  const char* line_last = nullptr;
+
+  /**
+   * @brief Moves past the spaces and tabs at the current position.
+   */
+  void skip_blanks() {
+    while (this->position < this->line_last &&
+           (*this->position == ' ' || *this->position == '\t')) {
+      this->position++;
+    }
+  }
+
+ public:
+  Text_Reader() = default;
+
+  /**
+   * @brief Opens a file.
+   *
+   * @param filename The path to the file.
+   *
+   * @throws std::runtime_error If the file cannot be opened.
+   */
+  explicit Text_Reader(const std::string& filename);
+
+  /**
+   * @brief Opens a file, closing the current one.
+   *
+   * @param filename The path to the file.
+   * @return Whether the file could be opened.
+   */
+  bool open(const std::string& filename);
+
+  /**
+   * @brief Returns whether a file is open.
+   */
+  bool is_open() const { return static_cast<bool>(this->file); }
+
+  /**
+   * @brief Closes the file.
+   */
+  void close();
+
+  /**
+   * @brief Moves to the next line.
+   *
+   * @return Whether there was a next line.
+   */
+  bool next_line();
+
+  /**
+   * @brief Returns the unread part of the current line.
+   */
+  std::string_view rest_of_line() const {
+    return std::string_view(this->position, this->line_last - this->position);
+  }
+
+  /**
+   * @brief Reads the next field of the current line. As with std::getline, a
+   * delimiter at the end of the line does not start an empty field.
+   *
+   * @param field The field, written by the function.
+   * @param delimiter The character between two fields.
+   * @return Whether the line had a field left.
+   */
+  bool next_field(std::string_view& field, char delimiter = ',');
+
+  /**
+   * @brief Reads the next number of the current line.
+   *
+   * The number is read with std::from_chars, so it always uses a dot as the
+   * decimal separator, whatever the locale. Blanks around it are skipped, and
+   * so is the delimiter after it. With the default delimiter the numbers are
+   * separated by blanks alone. As with next_field, a delimiter at the end of
+   * the line does not start an empty field.
+   *
+   * @tparam T The type of the number.
+   * @param value The number, written by the function.
+   * @param delimiter The character between two numbers.
+   * @return Whether the line had a number left.
+   *
+   * @throws std::runtime_error If the next field is not a number of type T.
+   */
+  template <class T>
+  bool next_number(T& value, char delimiter = ' ') {
+    this->skip_blanks();
+
+    if (this->position == this->line_last) {
+      return false;
+    }
+
+    const std::from_chars_result result =
+        std::from_chars(this->position, this->line_last, value);
+
+    if (result.ec != std::errc() ||
+        (result.ptr < this->line_last && *result.ptr != delimiter &&
+         *result.ptr != ' ' && *result.ptr != '\t')) {
+      throw std::runtime_error("Invalid number " +
+                               std::string(this->rest_of_line()));
+    }
+
+    this->position = result.ptr;
+    this->skip_blanks();
+
+    if (delimiter != ' ' && this->position < this->line_last) {
+      if (*this->position != delimiter) {
+        throw std::runtime_error("Invalid number " +
+                                 std::string(this->rest_of_line()));
+      }
+
+      this->position++;
+    }
+
+    return true;
+  }
+};
+
+}  // namespace mopop